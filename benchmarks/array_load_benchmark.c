@@ -0,0 +1,174 @@
+// Loading an array of doubles for parallel_reduce: serial strtod over a text
+// file against the binary format of include/array_file.h, loaded by parallel
+// preads or mapped zero-copy, with and without checksum verification.
+// Every case ends with parallel_reduce over the loaded array, so a lazily
+// mapped file pays for its page faults inside the timing.
+//
+// Binary loads run with a warm page cache and with the file evicted before
+// every run (posix_fadvise); text parsing is CPU bound and only runs warm.
+// Sizes: BENCH_SIZE doubles, 16M (128 MB binary, ~390 MB text) by default.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/array_file.h"
+#include "../include/mmap_reader.h"
+#include "../include/parallel_algorithms.h"
+
+#define NUM_VALUES (16L << 20)
+
+typedef enum { LOAD_TEXT = 0, LOAD_PREAD, LOAD_PREAD_VERIFY, LOAD_MMAP, LOAD_MMAP_VERIFY, LOAD_NUM_CASES } LoadCase;
+
+static const char* case_names[LOAD_NUM_CASES] = {
+    "text_strtod", "binary_pread", "binary_pread_verify", "binary_mmap", "binary_mmap_verify"
+};
+
+typedef struct {
+    const char* text_path;
+    const char* binary_path;
+    LoadCase load;
+    int cold;
+    long n;
+    double sum;
+    int errors;
+} BenchArgs;
+
+// Serial text ingestion: read the whole file, then strtod value by value
+static void load_text(BenchArgs* b) {
+    FILE* in = fopen(b->text_path, "r");
+    double* values = (double*)malloc(b->n * sizeof(double));
+    if (!in || !values) {
+        b->errors++;
+        if (in) fclose(in);
+        free(values);
+        return;
+    }
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    char* text = (char*)malloc(size + 1);
+    if (!text || fread(text, 1, size, in) != (size_t)size) b->errors++;
+    fclose(in);
+
+    long count = 0;
+    if (text) {
+        text[size] = '\0';
+        char* p = text;
+        char* end;
+        while (count < b->n) {
+            double v = strtod(p, &end);
+            if (end == p) break;
+            values[count++] = v;
+            p = end;
+        }
+    }
+    if (count != b->n) b->errors++;
+    b->sum = parallel_reduce(values, (int)count, 0.0, 0);
+    free(text);
+    free(values);
+}
+
+static void load_binary(BenchArgs* b) {
+    array_load_mode_t mode = b->load == LOAD_MMAP || b->load == LOAD_MMAP_VERIFY ? ARRAY_LOAD_MMAP : ARRAY_LOAD_PREAD;
+    int verify = b->load == LOAD_PREAD_VERIFY || b->load == LOAD_MMAP_VERIFY;
+    array_t a;
+    if (array_file_load(b->binary_path, mode, verify, &a) != 0 || (long)a.count != b->n) {
+        b->errors++;
+        return;
+    }
+    b->sum = parallel_reduce((const double*)a.data, (int)a.count, 0.0, 0);
+    array_free(&a);
+}
+
+static void run_load(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    if (b->cold && mmap_file_evict(b->binary_path) != 0) b->errors++;
+    if (b->load == LOAD_TEXT) {
+        load_text(b);
+    } else {
+        load_binary(b);
+    }
+}
+
+int main() {
+    const long n = bench_problem_size(NUM_VALUES, 1);
+    const char* tmp = getenv("BENCH_TMPDIR");
+    char text_path[512], binary_path[512];
+    snprintf(text_path, sizeof(text_path), "%s/array_load.%d.txt", tmp && *tmp ? tmp : "/tmp", (int)getpid());
+    snprintf(binary_path, sizeof(binary_path), "%s/array_load.%d.bin", tmp && *tmp ? tmp : "/tmp", (int)getpid());
+
+    double* values = (double*)malloc(n * sizeof(double));
+    if (!values) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+    srand(42);
+    for (long i = 0; i < n; i++) values[i] = (double)rand() / RAND_MAX * 1000.0 - 500.0;
+    double expected = parallel_reduce(values, (int)n, 0.0, 0);
+
+    // Round-trip precision, so both formats hold exactly the same values
+    FILE* out = fopen(text_path, "w");
+    if (!out) {
+        fprintf(stderr, "Could not write %s\n", text_path);
+        return 1;
+    }
+    for (long i = 0; i < n; i++) fprintf(out, "%.17g\n", values[i]);
+    fclose(out);
+    size_t shape = (size_t)n;
+    if (array_file_write(binary_path, values, ARRAY_FLOAT64, 1, &shape, 0, ARRAY_DEFAULT_CHUNK) != 0) {
+        fprintf(stderr, "Could not write %s\n", binary_path);
+        unlink(text_path);
+        return 1;
+    }
+    free(values);
+
+    double medians[2][LOAD_NUM_CASES] = { { 0.0 } };
+    double bytes = (double)n * sizeof(double);
+    int errors = 0;
+
+    bench_report_begin("array_load_benchmark");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "%ld doubles: %.1f MB binary\n", n, bytes / 1e6);
+
+    for (int cold = 0; cold < 2; cold++) {
+        for (int c = 0; c < LOAD_NUM_CASES; c++) {
+            if (cold && c == LOAD_TEXT) continue;
+            BenchArgs args = { text_path, binary_path, (LoadCase)c, cold, n, 0.0, 0 };
+            char name[BENCH_NAME_LEN];
+            snprintf(name, sizeof(name), "%s/%s", case_names[c], cold ? "cold" : "warm");
+            bench_result_t result;
+
+            bench_run(NULL, name, n, run_load, &args, &result);
+            bench_report_result(&result);
+            medians[cold][c] = result.median;
+            bench_result_free(&result);
+
+            // Every case loads the same values; leave room for rounding in the reduction
+            if (args.errors || fabs(args.sum - expected) > 1e-6 * fabs(expected) + 1e-6) {
+                fprintf(msg, "%s: wrong data loaded\n", name);
+                errors++;
+            }
+        }
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\n%-22s %14s %14s %14s\n", "case", "warm MB/s", "cold MB/s", "vs text");
+    for (int c = 0; c < LOAD_NUM_CASES; c++) {
+        fprintf(msg, "%-22s %14.0f ", case_names[c], bytes / medians[0][c] / 1e6);
+        if (medians[1][c] > 0.0) {
+            fprintf(msg, "%14.0f ", bytes / medians[1][c] / 1e6);
+        } else {
+            fprintf(msg, "%14s ", "-");
+        }
+        fprintf(msg, "%13.1fx\n", medians[0][LOAD_TEXT] / medians[0][c]);
+    }
+    if (errors) fprintf(msg, "\n%d case(s) loaded wrong data!\n", errors);
+
+    unlink(text_path);
+    unlink(binary_path);
+    return errors || regressions ? 1 : 0;
+}
@@ -0,0 +1,336 @@
+// Critical-path priorities on an imbalanced task graph: a tiled Cholesky
+// factorization (BENCH_SIZE x BENCH_SIZE tiles of 64x64, 20x20 by default).
+// Step k factors the diagonal tile (potrf), solves the tiles below it (trsm)
+// and updates the trailing matrix (syrk on the diagonal, gemm below it). The
+// few potrf/trsm tasks gate the next step while most of the work is gemm, so a
+// scheduler that runs ready gemms in creation order starves the critical path.
+//
+// The same task graph runs four ways: depend() clauses written per kernel as
+// in examples/task_dependencies.c, without and with priority() from the
+// kernels' bottom levels (include/task_dag.h), and the graph built with
+// task_dag and run by its counters executor, without and with priorities.
+// Set OMP_MAX_TASK_PRIORITY (e.g. 100); otherwise every priority is 0 and the
+// _prio cases only measure noise.
+//
+// The lower bound on the makespan is the larger of the serial time over the
+// threads and the critical path, converted with the serial flop rate. Every
+// case must reproduce the serial factorization bit for bit.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/task_dag.h"
+
+#define NUM_TILES 20
+#define TILE 64
+#define TILE_ELEMS (TILE * TILE)
+
+typedef enum { KERNEL_POTRF = 0, KERNEL_TRSM, KERNEL_SYRK, KERNEL_GEMM } KernelType;
+
+typedef struct {
+    KernelType type;
+    int k, i, j;            // Step, and the tile written: (i, j)
+} Kernel;
+
+typedef enum { RUN_CLAUSES = 0, RUN_CLAUSES_PRIO, RUN_COUNTERS, RUN_COUNTERS_PRIO, RUN_NUM_CASES } RunCase;
+
+static const char* case_names[RUN_NUM_CASES] = {
+    "depend_clauses", "depend_clauses_prio", "dag_counters", "dag_counters_prio"
+};
+
+typedef struct {
+    int nt;                 // Tiles per dimension
+    double** tile;          // tile[i * nt + j], lower triangle only
+    double* store;          // Backing storage of the tiles
+    const double* original; // Matrix to factor, copied into store before each run
+    long store_elems;
+    Kernel* kernels;        // In submission order; kernel id = task_dag node id
+    long num_kernels;
+    int* priority;          // Per kernel, from the task_dag analysis
+    task_dag_t* dag;
+    RunCase run;
+} BenchArgs;
+
+static BenchArgs* current;
+
+#define T(i, j) current->tile[(i) * current->nt + (j)]
+
+// In-place lower Cholesky of a diagonal tile (row-major, upper part untouched)
+static void potrf(double* a) {
+    for (int j = 0; j < TILE; j++) {
+        double d = a[j * TILE + j];
+        for (int p = 0; p < j; p++) d -= a[j * TILE + p] * a[j * TILE + p];
+        d = sqrt(d);
+        a[j * TILE + j] = d;
+        for (int i = j + 1; i < TILE; i++) {
+            double s = a[i * TILE + j];
+            for (int p = 0; p < j; p++) s -= a[i * TILE + p] * a[j * TILE + p];
+            a[i * TILE + j] = s / d;
+        }
+    }
+}
+
+// b = b * l^-T for the factored diagonal tile l
+static void trsm(const double* l, double* b) {
+    for (int r = 0; r < TILE; r++) {
+        for (int c = 0; c < TILE; c++) {
+            double x = b[r * TILE + c];
+            for (int p = 0; p < c; p++) x -= b[r * TILE + p] * l[c * TILE + p];
+            b[r * TILE + c] = x / l[c * TILE + c];
+        }
+    }
+}
+
+// c -= a * a^T, lower triangle
+static void syrk(const double* a, double* c) {
+    for (int r = 0; r < TILE; r++) {
+        for (int s = 0; s <= r; s++) {
+            double x = 0.0;
+            for (int p = 0; p < TILE; p++) x += a[r * TILE + p] * a[s * TILE + p];
+            c[r * TILE + s] -= x;
+        }
+    }
+}
+
+// c -= a * b^T
+static void gemm(const double* a, const double* b, double* c) {
+    for (int r = 0; r < TILE; r++) {
+        for (int s = 0; s < TILE; s++) {
+            double x = 0.0;
+            for (int p = 0; p < TILE; p++) x += a[r * TILE + p] * b[s * TILE + p];
+            c[r * TILE + s] -= x;
+        }
+    }
+}
+
+static void run_kernel(void* arg) {
+    const Kernel* t = (const Kernel*)arg;
+    switch (t->type) {
+        case KERNEL_POTRF: potrf(T(t->k, t->k)); break;
+        case KERNEL_TRSM:  trsm(T(t->k, t->k), T(t->i, t->k)); break;
+        case KERNEL_SYRK:  syrk(T(t->i, t->k), T(t->i, t->i)); break;
+        case KERNEL_GEMM:  gemm(T(t->i, t->k), T(t->j, t->k), T(t->i, t->j)); break;
+    }
+}
+
+// Relative cost in flops
+static double kernel_cost(KernelType type) {
+    const double b3 = (double)TILE * TILE * TILE;
+    switch (type) {
+        case KERNEL_POTRF: return b3 / 3.0;
+        case KERNEL_TRSM:  return b3;
+        case KERNEL_SYRK:  return b3;
+        default:           return 2.0 * b3;
+    }
+}
+
+// Kernels of the right-looking factorization in submission order
+static long list_kernels(int nt, Kernel* out) {
+    long count = 0;
+    for (int k = 0; k < nt; k++) {
+        out[count++] = (Kernel){ KERNEL_POTRF, k, k, k };
+        for (int i = k + 1; i < nt; i++) out[count++] = (Kernel){ KERNEL_TRSM, k, i, k };
+        for (int i = k + 1; i < nt; i++) {
+            out[count++] = (Kernel){ KERNEL_SYRK, k, i, i };
+            for (int j = k + 1; j < i; j++) out[count++] = (Kernel){ KERNEL_GEMM, k, i, j };
+        }
+    }
+    return count;
+}
+
+// Edges from the last writer of every tile a kernel touches. Tiles are final
+// once read (potrf and trsm outputs), so read-after-write and the chain of
+// writes to each tile are the only orderings needed
+static task_dag_t* build_dag(BenchArgs* b) {
+    task_dag_t* dag = task_dag_create();
+    long* writer = (long*)malloc((size_t)b->nt * b->nt * sizeof(long));
+    if (!dag || !writer) {
+        task_dag_destroy(dag);
+        free(writer);
+        return NULL;
+    }
+    for (long t = 0; t < (long)b->nt * b->nt; t++) writer[t] = -1;
+    for (long id = 0; id < b->num_kernels; id++) {
+        const Kernel* t = &b->kernels[id];
+        long v = task_dag_add_node(dag, run_kernel, &b->kernels[id], kernel_cost(t->type));
+        long reads[2];
+        int num_reads = 0;
+        switch (t->type) {
+            case KERNEL_POTRF: break;
+            case KERNEL_TRSM:  reads[num_reads++] = t->k * b->nt + t->k; break;
+            case KERNEL_SYRK:  reads[num_reads++] = t->i * b->nt + t->k; break;
+            case KERNEL_GEMM:
+                reads[num_reads++] = t->i * b->nt + t->k;
+                reads[num_reads++] = t->j * b->nt + t->k;
+                break;
+        }
+        long written = t->i * b->nt + t->j;
+        for (int r = 0; r < num_reads; r++) {
+            if (writer[reads[r]] >= 0) task_dag_add_edge(dag, writer[reads[r]], v);
+        }
+        if (writer[written] >= 0) task_dag_add_edge(dag, writer[written], v);
+        writer[written] = v;
+    }
+    free(writer);
+    return dag;
+}
+
+// One task per kernel with depend() on the tile pointers, as written by hand
+static void factor_clauses(BenchArgs* b, int priorities) {
+    double** tile = b->tile;
+    const int nt = b->nt;
+    #pragma omp parallel
+    #pragma omp single
+    {
+        long id = 0;
+        for (int k = 0; k < nt; k++) {
+            #pragma omp task depend(inout: tile[k * nt + k]) priority(priorities ? b->priority[id] : 0)
+            potrf(tile[k * nt + k]);
+            id++;
+            for (int i = k + 1; i < nt; i++) {
+                #pragma omp task depend(in: tile[k * nt + k]) depend(inout: tile[i * nt + k]) \
+                    priority(priorities ? b->priority[id] : 0)
+                trsm(tile[k * nt + k], tile[i * nt + k]);
+                id++;
+            }
+            for (int i = k + 1; i < nt; i++) {
+                #pragma omp task depend(in: tile[i * nt + k]) depend(inout: tile[i * nt + i]) \
+                    priority(priorities ? b->priority[id] : 0)
+                syrk(tile[i * nt + k], tile[i * nt + i]);
+                id++;
+                for (int j = k + 1; j < i; j++) {
+                    #pragma omp task depend(in: tile[i * nt + k], tile[j * nt + k]) depend(inout: tile[i * nt + j]) \
+                        priority(priorities ? b->priority[id] : 0)
+                    gemm(tile[i * nt + k], tile[j * nt + k], tile[i * nt + j]);
+                    id++;
+                }
+            }
+        }
+    }
+}
+
+static void factor(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    current = b;
+    memcpy(b->store, b->original, b->store_elems * sizeof(double));
+    switch (b->run) {
+        case RUN_CLAUSES:       factor_clauses(b, 0); break;
+        case RUN_CLAUSES_PRIO:  factor_clauses(b, 1); break;
+        case RUN_COUNTERS:      task_dag_execute(b->dag, TASK_DAG_COUNTERS, 0); break;
+        default:                task_dag_execute(b->dag, TASK_DAG_COUNTERS, 1); break;
+    }
+}
+
+int main() {
+    const int nt = (int)bench_problem_size(NUM_TILES, 3);
+    const int threads = omp_get_max_threads();
+    const long num_tiles = (long)nt * (nt + 1) / 2;
+    const long max_kernels = (long)nt * (nt + 1) * (nt + 2) / 6 + nt * nt;
+
+    BenchArgs args = { 0 };
+    args.nt = nt;
+    args.store_elems = num_tiles * TILE_ELEMS;
+    args.tile = (double**)calloc((size_t)nt * nt, sizeof(double*));
+    args.store = (double*)malloc(args.store_elems * sizeof(double));
+    double* original = (double*)malloc(args.store_elems * sizeof(double));
+    double* reference = (double*)malloc(args.store_elems * sizeof(double));
+    args.kernels = (Kernel*)malloc(max_kernels * sizeof(Kernel));
+    args.priority = (int*)malloc(max_kernels * sizeof(int));
+    if (!args.tile || !args.store || !original || !reference || !args.kernels || !args.priority) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+    args.original = original;
+
+    // Symmetric, diagonally dominant: a_rc = a_cr in [0, 1), plus n on the diagonal
+    const long n = (long)nt * TILE;
+    long next = 0;
+    for (int i = 0; i < nt; i++) {
+        for (int j = 0; j <= i; j++) {
+            args.tile[i * nt + j] = args.store + next;
+            for (int r = 0; r < TILE; r++) {
+                for (int c = 0; c < TILE; c++) {
+                    long gr = (long)i * TILE + r, gc = (long)j * TILE + c;
+                    long lo = gr < gc ? gr : gc, hi = gr < gc ? gc : gr;
+                    double v = (double)((unsigned long)(hi * 2654435761UL + lo * 40503UL) % 1000003UL) / 1000003.0;
+                    original[next + r * TILE + c] = gr == gc ? v + n : v;
+                }
+            }
+            next += TILE_ELEMS;
+        }
+    }
+
+    args.num_kernels = list_kernels(nt, args.kernels);
+    args.dag = build_dag(&args);
+    double critical_path = args.dag ? task_dag_critical_path(args.dag) : -1.0;
+    if (critical_path < 0.0) {
+        fprintf(stderr, "Building the task graph failed!\n");
+        return 1;
+    }
+    double total_cost = 0.0;
+    for (long id = 0; id < args.num_kernels; id++) {
+        args.priority[id] = task_dag_priority(args.dag, id);
+        total_cost += kernel_cost(args.kernels[id].type);
+    }
+
+    // Serial factorization in submission order: reference result and flop rate
+    current = &args;
+    memcpy(args.store, original, args.store_elems * sizeof(double));
+    double serial_start = omp_get_wtime();
+    for (long id = 0; id < args.num_kernels; id++) run_kernel(&args.kernels[id]);
+    const double serial = omp_get_wtime() - serial_start;
+    memcpy(reference, args.store, args.store_elems * sizeof(double));
+    const double bound = fmax(serial / threads, serial * critical_path / total_cost);
+
+    double medians[RUN_NUM_CASES] = { 0.0 };
+    int errors = 0;
+
+    bench_report_begin("cholesky_benchmark");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "%dx%d tiles of %dx%d (n = %ld), %ld tasks, critical path %.1f%% of the work\n",
+            nt, nt, TILE, TILE, n, args.num_kernels, 100.0 * critical_path / total_cost);
+    fprintf(msg, "Serial %.3f s (%.2f GFLOP/s), makespan bound on %d threads %.4f s\n",
+            serial, total_cost / serial / 1e9, threads, bound);
+    fprintf(msg, "Max task priority %d%s\n", omp_get_max_task_priority(),
+            omp_get_max_task_priority() ? "" : " (set OMP_MAX_TASK_PRIORITY for the _prio cases to differ)");
+
+    for (int c = 0; c < RUN_NUM_CASES; c++) {
+        args.run = (RunCase)c;
+        bench_result_t result;
+
+        bench_run(NULL, case_names[c], n, factor, &args, &result);
+        bench_report_result(&result);
+        medians[c] = result.median;
+        bench_result_free(&result);
+
+        if (memcmp(args.store, reference, args.store_elems * sizeof(double)) != 0) {
+            fprintf(msg, "%s: factor differs from the serial factorization\n", case_names[c]);
+            errors++;
+        }
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\n%-22s %12s %10s %12s %16s\n", "case", "makespan (s)", "GFLOP/s", "of bound", "vs. no priority");
+    for (int c = 0; c < RUN_NUM_CASES; c++) {
+        fprintf(msg, "%-22s %12.4f %10.2f %11.1f%%", case_names[c], medians[c], total_cost / medians[c] / 1e9,
+                100.0 * bound / medians[c]);
+        if (c == RUN_CLAUSES_PRIO || c == RUN_COUNTERS_PRIO) {
+            fprintf(msg, " %15.2fx\n", medians[c - 1] / medians[c]);
+        } else {
+            fprintf(msg, " %16s\n", "");
+        }
+    }
+    if (errors) fprintf(msg, "\n%d case(s) gave a wrong factor!\n", errors);
+
+    task_dag_destroy(args.dag);
+    free(args.tile);
+    free(args.store);
+    free(original);
+    free(reference);
+    free(args.kernels);
+    free(args.priority);
+    return errors || regressions ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+// Ingestion throughput (MB/s of text) of a numeric CSV file: the serial
+// strtod loop against include/csv_parser.h on one thread (fast float parsing
+// alone) and on all threads (newline-split parts parsed into the columns).
+// Every case ends with parallel_reduce over each column and must produce
+// columns bit-identical to strtod.
+//
+// The file has four columns in the usual shapes of exported data: full
+// round-trip precision, fixed six decimals, integers and short scientific.
+// Sizes: BENCH_SIZE rows, 4M (~230 MB of text) by default.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/csv_parser.h"
+#include "../include/mmap_reader.h"
+#include "../include/parallel_algorithms.h"
+
+#define NUM_ROWS (4L << 20)
+#define NUM_COLUMNS 4
+
+typedef enum { PARSE_STRTOD = 0, PARSE_FAST_SERIAL, PARSE_FAST_PARALLEL, PARSE_NUM_CASES } ParseCase;
+
+static const char* case_names[PARSE_NUM_CASES] = { "strtod_serial", "csv_1_thread", "csv_parallel" };
+
+typedef struct {
+    const char* path;
+    ParseCase parse;
+    int threads;
+    long rows;
+    double** reference;     // Columns from strtod, NULL while parsing them
+    double sums[NUM_COLUMNS];
+    int errors;
+} BenchArgs;
+
+// Baseline: read the file, then strtod field by field into the columns
+static void parse_strtod(BenchArgs* b, double** columns) {
+    mmap_file_t* file = mmap_file_open(b->path, MMAP_WILLNEED);
+    char* text = file ? (char*)malloc(file->size + 1) : NULL;
+    if (!text) {
+        b->errors++;
+        if (file) mmap_file_close(file);
+        return;
+    }
+    memcpy(text, file->data, file->size);
+    text[file->size] = '\0';
+    mmap_file_close(file);
+
+    char* p = strchr(text, '\n') + 1;       // Header
+    char* end;
+    long row = 0;
+    for (; row < b->rows && *p; row++) {
+        for (int c = 0; c < NUM_COLUMNS; c++) {
+            columns[c][row] = strtod(p, &end);
+            if (end == p) b->errors++;
+            p = end + 1;                    // Delimiter or newline
+        }
+    }
+    if (row != b->rows) b->errors++;
+    free(text);
+}
+
+static void run_parse(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    double* columns[NUM_COLUMNS];
+    csv_table_t table = { 0 };
+
+    if (b->parse == PARSE_STRTOD) {
+        for (int c = 0; c < NUM_COLUMNS; c++) columns[c] = (double*)malloc(b->rows * sizeof(double));
+        parse_strtod(b, columns);
+    } else {
+        omp_set_num_threads(b->threads);
+        if (csv_parse_file(b->path, ',', 1, &table) != 0 || table.columns != NUM_COLUMNS ||
+            table.rows != b->rows || table.bad_fields) {
+            b->errors++;
+            csv_table_free(&table);
+            return;
+        }
+        for (int c = 0; c < NUM_COLUMNS; c++) columns[c] = table.data[c];
+    }
+
+    for (int c = 0; c < NUM_COLUMNS; c++) b->sums[c] = parallel_reduce(columns[c], (int)b->rows, 0.0, 0);
+
+    if (b->reference) {
+        for (int c = 0; c < NUM_COLUMNS; c++) {
+            if (memcmp(columns[c], b->reference[c], b->rows * sizeof(double)) != 0) b->errors++;
+        }
+    }
+    if (b->parse == PARSE_STRTOD) {
+        if (!b->reference) {
+            // First run: keep the columns as the reference
+            b->reference = (double**)malloc(NUM_COLUMNS * sizeof(double*));
+            for (int c = 0; c < NUM_COLUMNS; c++) b->reference[c] = columns[c];
+        } else {
+            for (int c = 0; c < NUM_COLUMNS; c++) free(columns[c]);
+        }
+    } else {
+        csv_table_free(&table);
+    }
+}
+
+int main() {
+    const long rows = bench_problem_size(NUM_ROWS, 1);
+    const int max_threads = omp_get_max_threads();
+    const char* tmp = getenv("BENCH_TMPDIR");
+    char path[512];
+    snprintf(path, sizeof(path), "%s/csv_benchmark.%d.csv", tmp && *tmp ? tmp : "/tmp", (int)getpid());
+
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "Could not write %s\n", path);
+        return 1;
+    }
+    srand(42);
+    fprintf(out, "precise,fixed,count,scientific\n");
+    for (long i = 0; i < rows; i++) {
+        double x = (double)rand() / RAND_MAX * 2000.0 - 1000.0;
+        fprintf(out, "%.17g,%.6f,%d,%.4e\n", x, x * 0.37, rand() % 100000, x * 1e-5);
+    }
+    long bytes = ftell(out);
+    fclose(out);
+
+    double medians[PARSE_NUM_CASES] = { 0.0 };
+    double** reference = NULL;
+    double reference_sums[NUM_COLUMNS] = { 0.0 };
+    int errors = 0;
+
+    bench_report_begin("csv_benchmark");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "%ld rows x %d columns: %.1f MB of text, %d threads\n", rows, NUM_COLUMNS, bytes / 1e6, max_threads);
+
+    for (int c = 0; c < PARSE_NUM_CASES; c++) {
+        BenchArgs args = { path, (ParseCase)c, c == PARSE_FAST_PARALLEL ? max_threads : 1, rows, reference,
+                           { 0.0 }, 0 };
+        bench_result_t result;
+
+        bench_run(NULL, case_names[c], bytes, run_parse, &args, &result);
+        bench_report_result(&result);
+        medians[c] = result.median;
+        bench_result_free(&result);
+        omp_set_num_threads(max_threads);
+
+        if (c == PARSE_STRTOD) {
+            reference = args.reference;
+            memcpy(reference_sums, args.sums, sizeof(reference_sums));
+        }
+        // Bit-identical columns give identical sums as well
+        if (args.errors || !reference || memcmp(args.sums, reference_sums, sizeof(reference_sums)) != 0) {
+            fprintf(msg, "%s: columns differ from strtod\n", case_names[c]);
+            errors++;
+        }
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\n%-16s %12s %12s\n", "case", "MB/s", "vs strtod");
+    for (int c = 0; c < PARSE_NUM_CASES; c++) {
+        fprintf(msg, "%-16s %12.0f %11.1fx\n", case_names[c], bytes / medians[c] / 1e6,
+                medians[PARSE_STRTOD] / medians[c]);
+    }
+    if (errors) fprintf(msg, "\n%d case(s) parsed wrong values!\n", errors);
+
+    if (reference) {
+        for (int c = 0; c < NUM_COLUMNS; c++) free(reference[c]);
+        free(reference);
+    }
+    unlink(path);
+    return errors || regressions ? 1 : 0;
+}
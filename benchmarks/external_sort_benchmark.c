@@ -0,0 +1,133 @@
+// Sorting an array file larger than the memory it may use: load +
+// parallel_sort + write as the in-memory reference, against the external sort
+// of include/external_sort.h with budgets of a quarter and a sixteenth of
+// the data. Throughput is MB of input per second; the phase columns split the
+// external sort into run formation (read/sort/spill overlapped) and merge.
+// Every output is loaded with checksum verification and checked for order
+// and for the input's sum.
+// Sizes: BENCH_SIZE doubles, 32M (256 MB) by default.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/array_file.h"
+#include "../include/external_sort.h"
+#include "../include/parallel_algorithms.h"
+
+#define NUM_VALUES (32L << 20)
+
+typedef enum { SORT_IN_MEMORY = 0, SORT_EXTERNAL_4, SORT_EXTERNAL_16, SORT_NUM_CASES } SortCase;
+
+static const char* case_names[SORT_NUM_CASES] = { "in_memory", "external_budget/4", "external_budget/16" };
+static const int budget_divisors[SORT_NUM_CASES] = { 1, 4, 16 };
+
+typedef struct {
+    const char* input;
+    const char* output;
+    SortCase sort;
+    long n;
+    external_sort_stats_t stats;
+    int errors;
+} BenchArgs;
+
+static void run_sort(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    if (b->sort == SORT_IN_MEMORY) {
+        array_t a;
+        if (array_file_load(b->input, ARRAY_LOAD_PREAD, 0, &a) != 0) {
+            b->errors++;
+            return;
+        }
+        parallel_sort((double*)a.data, (int)a.count);
+        size_t shape = a.count;
+        if (array_file_write(b->output, a.data, ARRAY_FLOAT64, 1, &shape, 0, ARRAY_DEFAULT_CHUNK) != 0) b->errors++;
+        array_free(&a);
+    } else {
+        const char* tmp = getenv("BENCH_TMPDIR");
+        external_sort_config_t config = { (size_t)b->n * sizeof(double) / budget_divisors[b->sort], tmp };
+        if (external_sort_file(b->input, b->output, &config, &b->stats) != 0) b->errors++;
+    }
+}
+
+// Sorted, checksums intact, same sum as the input
+static int verify_output(const char* path, long n, double expected_sum) {
+    array_t a;
+    if (array_file_load(path, ARRAY_LOAD_MMAP, 1, &a) != 0) return 1;
+    const double* v = (const double*)a.data;
+    int errors = (long)a.count != n;
+    for (long i = 1; i < n && !errors; i++) errors += v[i - 1] > v[i];
+    double sum = parallel_reduce(v, (int)a.count, 0.0, 0);
+    errors += fabs(sum - expected_sum) > 1e-6 * fabs(expected_sum) + 1e-6;
+    array_free(&a);
+    return errors;
+}
+
+int main() {
+    const long n = bench_problem_size(NUM_VALUES, 1);
+    const char* tmp = getenv("BENCH_TMPDIR");
+    char input[512], output[512];
+    snprintf(input, sizeof(input), "%s/external_sort.%d.in", tmp && *tmp ? tmp : "/tmp", (int)getpid());
+    snprintf(output, sizeof(output), "%s/external_sort.%d.out", tmp && *tmp ? tmp : "/tmp", (int)getpid());
+
+    double* values = (double*)malloc(n * sizeof(double));
+    if (!values) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+    srand(42);
+    for (long i = 0; i < n; i++) values[i] = (double)rand() / RAND_MAX * 1000.0 - 500.0;
+    double expected_sum = parallel_reduce(values, (int)n, 0.0, 0);
+    size_t shape = (size_t)n;
+    if (array_file_write(input, values, ARRAY_FLOAT64, 1, &shape, 0, ARRAY_DEFAULT_CHUNK) != 0) {
+        fprintf(stderr, "Could not write %s\n", input);
+        return 1;
+    }
+    free(values);
+
+    double medians[SORT_NUM_CASES] = { 0.0 };
+    external_sort_stats_t stats[SORT_NUM_CASES];
+    memset(stats, 0, sizeof(stats));
+    double bytes = (double)n * sizeof(double);
+    int errors = 0;
+
+    bench_report_begin("external_sort_benchmark");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "%ld doubles: %.1f MB\n", n, bytes / 1e6);
+
+    for (int c = 0; c < SORT_NUM_CASES; c++) {
+        BenchArgs args = { input, output, (SortCase)c, n, { 0, 0, 0.0, 0.0 }, 0 };
+        bench_result_t result;
+
+        bench_run(NULL, case_names[c], n, run_sort, &args, &result);
+        bench_report_result(&result);
+        medians[c] = result.median;
+        stats[c] = args.stats;
+        bench_result_free(&result);
+
+        if (args.errors || verify_output(output, n, expected_sum)) {
+            fprintf(msg, "%s: output not sorted or incomplete\n", case_names[c]);
+            errors++;
+        }
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\n%-20s %10s %8s %10s %10s %12s\n", "case", "MB/s", "runs", "runs (s)", "merge (s)", "vs memory");
+    for (int c = 0; c < SORT_NUM_CASES; c++) {
+        fprintf(msg, "%-20s %10.0f ", case_names[c], bytes / medians[c] / 1e6);
+        if (c == SORT_IN_MEMORY) {
+            fprintf(msg, "%8s %10s %10s ", "-", "-", "-");
+        } else {
+            fprintf(msg, "%8ld %10.3f %10.3f ", stats[c].runs, stats[c].run_seconds, stats[c].merge_seconds);
+        }
+        fprintf(msg, "%11.2fx\n", medians[SORT_IN_MEMORY] / medians[c]);
+    }
+    if (errors) fprintf(msg, "\n%d case(s) produced wrong output!\n", errors);
+
+    unlink(input);
+    unlink(output);
+    return errors || regressions ? 1 : 0;
+}
@@ -0,0 +1,601 @@
+// CPU-bound irregular task benchmarks: unbalanced tree search (binomial and
+// geometric trees), N-Queens, recursive fib and a sparse LU task graph. Every
+// recursive kernel runs in five task variants:
+//
+//   tied       plain tasks, serial recursion past the cutoff depth
+//   untied     the same with untied tasks
+//   final      tasks past the cutoff are final(), their descendants run as
+//              included tasks instead of switching to serial code
+//   mergeable  final() plus mergeable, so included tasks may share the data
+//              environment of their parent
+//   taskloop   children spawned with taskloop grainsize(1)
+//
+// Sparse LU has no nesting, so it runs as a depend() task graph (tied and
+// untied) and as phase-wise taskloops. Every case is timed for thread counts
+// 1, 2, 4, ... up to argv[1] (default: number of processors) and reported with
+// its task throughput and speedup over one thread.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+
+#define CUTOFF_DEPTH 12          // Recursion depth at which tasks stop (or turn final)
+#define QUEENS_CUTOFF 4          // N-Queens is much wider, so it stops earlier
+
+#define FIB_N 32
+
+#define QUEENS_N 11
+#define QUEENS_MAX 16
+
+#define BIN_ROOT_CHILDREN 2000   // Binomial UTS: b0 root children, then m children
+#define BIN_CHILDREN 8           // with probability q, q*m < 1
+#define BIN_PROBABILITY 0.1225
+#define GEO_BRANCH 2.0           // Geometric UTS: mean branching factor
+#define GEO_DEPTH 18             // and depth limit
+#define UTS_INLINE_CHILDREN 16   // Child arrays up to this size live on the stack
+
+#define LU_BLOCKS 32             // Sparse LU: blocks per dimension
+#define LU_BLOCK_SIZE 32         // and elements per block dimension
+
+typedef enum {
+    VARIANT_TIED = 0,
+    VARIANT_UNTIED,
+    VARIANT_FINAL,
+    VARIANT_MERGEABLE,
+    VARIANT_TASKLOOP,
+    NUM_VARIANTS
+} Variant;
+
+static const char* variant_names[NUM_VARIANTS] = { "tied", "untied", "final", "mergeable", "taskloop" };
+
+// final and mergeable keep creating (included) tasks past the cutoff
+static int serial_past_cutoff(Variant v) {
+    return v != VARIANT_FINAL && v != VARIANT_MERGEABLE;
+}
+
+// Spawn children 0..n-1 with the variant's clauses and wait for them. The
+// final variants read a local int final_task declared by the caller.
+#define SPAWN_CHILDREN(variant, n, i, ...)                          \
+    do {                                                            \
+        if ((variant) == VARIANT_TASKLOOP) {                        \
+            _Pragma("omp taskloop grainsize(1)")                    \
+            for (int i = 0; i < (n); i++) { __VA_ARGS__; }          \
+        } else {                                                    \
+            for (int i = 0; i < (n); i++) {                         \
+                switch (variant) {                                  \
+                    case VARIANT_UNTIED:                            \
+                        _Pragma("omp task untied")                  \
+                        { __VA_ARGS__; }                            \
+                        break;                                      \
+                    case VARIANT_FINAL:                             \
+                        _Pragma("omp task final(final_task)")       \
+                        { __VA_ARGS__; }                            \
+                        break;                                      \
+                    case VARIANT_MERGEABLE:                         \
+                        _Pragma("omp task final(final_task) mergeable") \
+                        { __VA_ARGS__; }                            \
+                        break;                                      \
+                    default:                                        \
+                        _Pragma("omp task")                         \
+                        { __VA_ARGS__; }                            \
+                        break;                                      \
+                }                                                   \
+            }                                                       \
+            _Pragma("omp taskwait")                                 \
+        }                                                           \
+    } while (0)
+
+// ---- fib ----
+
+static long fib_serial(int n) {
+    return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+// Calls at depths 1..limit, i.e. the tasks a run creates
+static long fib_count(int n, int depth, int limit) {
+    if (depth > limit) return 0;
+    long self = depth > 0;
+    return n < 2 ? self : self + fib_count(n - 1, depth + 1, limit) + fib_count(n - 2, depth + 1, limit);
+}
+
+static long fib_task(int n, int depth, Variant v) {
+    if (n < 2) return n;
+    if (serial_past_cutoff(v) && depth >= CUTOFF_DEPTH) return fib_serial(n);
+
+    long result[2];
+    long* r = result;
+    int final_task = depth + 1 >= CUTOFF_DEPTH;
+    (void)final_task;
+    SPAWN_CHILDREN(v, 2, i, r[i] = fib_task(n - 1 - i, depth + 1, v));
+    return result[0] + result[1];
+}
+
+// ---- N-Queens ----
+
+// Queen in row `row` at board[row] attacks none of the rows above
+static int queens_ok(const char* board, int row) {
+    for (int r = 0; r < row; r++) {
+        int d = board[row] - board[r];
+        if (d == 0 || d == row - r || d == r - row) return 0;
+    }
+    return 1;
+}
+
+static long queens_serial(char* board, int row, int n) {
+    if (row == n) return 1;
+    long solutions = 0;
+    for (int c = 0; c < n; c++) {
+        board[row] = (char)c;
+        if (queens_ok(board, row)) solutions += queens_serial(board, row + 1, n);
+    }
+    return solutions;
+}
+
+// Child slots (one per column of every valid partial board) at depths 1..limit
+static long queens_count(char* board, int row, int n, int depth, int limit) {
+    if (row == n || depth >= limit) return 0;
+    long slots = n;
+    for (int c = 0; c < n; c++) {
+        board[row] = (char)c;
+        if (queens_ok(board, row)) slots += queens_count(board, row + 1, n, depth + 1, limit);
+    }
+    return slots;
+}
+
+static long queens_task(const char* board, int row, int n, int depth, Variant v) {
+    if (row == n) return 1;
+    if (serial_past_cutoff(v) && depth >= QUEENS_CUTOFF) {
+        char copy[QUEENS_MAX];
+        memcpy(copy, board, row);
+        return queens_serial(copy, row, n);
+    }
+
+    long counts[QUEENS_MAX];
+    long* cnt = counts;
+    int final_task = depth + 1 >= QUEENS_CUTOFF;
+    (void)final_task;
+    SPAWN_CHILDREN(v, n, c, {
+        char child[QUEENS_MAX];
+        memcpy(child, board, row);
+        child[row] = (char)c;
+        cnt[c] = queens_ok(child, row) ? queens_task(child, row + 1, n, depth + 1, v) : 0;
+    });
+
+    long solutions = 0;
+    for (int c = 0; c < n; c++) solutions += counts[c];
+    return solutions;
+}
+
+// ---- Unbalanced tree search ----
+
+typedef enum { TREE_BINOMIAL = 0, TREE_GEOMETRIC } TreeShape;
+
+static unsigned long long uts_hash(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static int uts_children(TreeShape shape, unsigned long long state, int depth) {
+    double u = (uts_hash(state) >> 11) * (1.0 / 9007199254740992.0);
+    if (shape == TREE_GEOMETRIC) {
+        if (depth >= GEO_DEPTH) return 0;
+        // Geometric number of children with mean GEO_BRANCH
+        return (int)floor(log(1.0 - u) / log(GEO_BRANCH / (1.0 + GEO_BRANCH)));
+    }
+    if (depth == 0) return BIN_ROOT_CHILDREN;
+    return u < BIN_PROBABILITY ? BIN_CHILDREN : 0;
+}
+
+static unsigned long long uts_child(unsigned long long state, int i) {
+    return uts_hash(state * 31 + i + 1);
+}
+
+// Nodes at depths 1..limit (the tasks a run creates), or all nodes with limit < 0
+static long uts_count(TreeShape shape, unsigned long long state, int depth, int limit) {
+    if (limit >= 0 && depth > limit) return 0;
+    long nodes = limit < 0 || depth > 0;
+    int n = uts_children(shape, state, depth);
+    for (int i = 0; i < n; i++) nodes += uts_count(shape, uts_child(state, i), depth + 1, limit);
+    return nodes;
+}
+
+static long uts_serial(TreeShape shape, unsigned long long state, int depth) {
+    return uts_count(shape, state, depth, -1);
+}
+
+static long uts_task(TreeShape shape, unsigned long long state, int depth, Variant v) {
+    int n = uts_children(shape, state, depth);
+    if (n == 0) return 1;
+    if (serial_past_cutoff(v) && depth >= CUTOFF_DEPTH) return uts_serial(shape, state, depth);
+
+    long inline_counts[UTS_INLINE_CHILDREN];
+    long* counts = n <= UTS_INLINE_CHILDREN ? inline_counts : (long*)malloc(n * sizeof(long));
+    int final_task = depth + 1 >= CUTOFF_DEPTH;
+    (void)final_task;
+    SPAWN_CHILDREN(v, n, i, counts[i] = uts_task(shape, uts_child(state, i), depth + 1, v));
+
+    long nodes = 1;
+    for (int i = 0; i < n; i++) nodes += counts[i];
+    if (counts != inline_counts) free(counts);
+    return nodes;
+}
+
+// ---- Sparse LU (BOTS sparselu) ----
+
+#define BS LU_BLOCK_SIZE
+
+static void lu0(float* diag) {
+    for (int k = 0; k < BS; k++) {
+        for (int i = k + 1; i < BS; i++) {
+            diag[i * BS + k] /= diag[k * BS + k];
+            for (int j = k + 1; j < BS; j++) diag[i * BS + j] -= diag[i * BS + k] * diag[k * BS + j];
+        }
+    }
+}
+
+static void fwd(const float* diag, float* col) {
+    for (int j = 0; j < BS; j++) {
+        for (int k = 0; k < BS; k++) {
+            for (int i = k + 1; i < BS; i++) col[i * BS + j] -= diag[i * BS + k] * col[k * BS + j];
+        }
+    }
+}
+
+static void bdiv(const float* diag, float* row) {
+    for (int i = 0; i < BS; i++) {
+        for (int k = 0; k < BS; k++) {
+            row[i * BS + k] /= diag[k * BS + k];
+            for (int j = k + 1; j < BS; j++) row[i * BS + j] -= row[i * BS + k] * diag[k * BS + j];
+        }
+    }
+}
+
+static void bmod(const float* row, const float* col, float* inner) {
+    for (int i = 0; i < BS; i++) {
+        for (int k = 0; k < BS; k++) {
+            for (int j = 0; j < BS; j++) inner[i * BS + j] -= row[i * BS + k] * col[k * BS + j];
+        }
+    }
+}
+
+// BOTS sparsity pattern and values; blocks are NULL where the matrix is empty
+static float** lu_generate(void) {
+    const int nb = LU_BLOCKS;
+    float** A = (float**)calloc(nb * nb, sizeof(float*));
+    int value = 1325;
+
+    for (int ii = 0; ii < nb; ii++) {
+        for (int jj = 0; jj < nb; jj++) {
+            int empty = (ii < jj && ii % 3 != 0) || (ii > jj && jj % 3 != 0) || ii % 2 == 1 || jj % 2 == 1;
+            if (ii == jj || ii == jj - 1 || ii - 1 == jj) empty = 0;
+            if (empty) continue;
+
+            float* block = (float*)malloc(BS * BS * sizeof(float));
+            for (int e = 0; e < BS * BS; e++) {
+                value = (3125 * value) % 65536;
+                block[e] = (float)((value - 32768.0) / 16384.0);
+            }
+            A[ii * nb + jj] = block;
+        }
+    }
+    return A;
+}
+
+static void lu_free(float** A) {
+    for (int b = 0; b < LU_BLOCKS * LU_BLOCKS; b++) free(A[b]);
+    free(A);
+}
+
+static float* lu_fill_in(float** A, int ii, int jj) {
+    if (!A[ii * LU_BLOCKS + jj]) A[ii * LU_BLOCKS + jj] = (float*)calloc(BS * BS, sizeof(float));
+    return A[ii * LU_BLOCKS + jj];
+}
+
+// Number of kernel calls (tasks) of one factorization
+static long lu_count(void) {
+    float** A = lu_generate();
+    const int nb = LU_BLOCKS;
+    long tasks = 0;
+    for (int kk = 0; kk < nb; kk++) {
+        tasks++;
+        for (int jj = kk + 1; jj < nb; jj++) tasks += A[kk * nb + jj] != NULL;
+        for (int ii = kk + 1; ii < nb; ii++) {
+            if (!A[ii * nb + kk]) continue;
+            tasks++;
+            for (int jj = kk + 1; jj < nb; jj++) {
+                if (A[kk * nb + jj]) {
+                    lu_fill_in(A, ii, jj);
+                    tasks++;
+                }
+            }
+        }
+    }
+    lu_free(A);
+    return tasks;
+}
+
+static void lu_serial(float** A) {
+    const int nb = LU_BLOCKS;
+    for (int kk = 0; kk < nb; kk++) {
+        lu0(A[kk * nb + kk]);
+        for (int jj = kk + 1; jj < nb; jj++) {
+            if (A[kk * nb + jj]) fwd(A[kk * nb + kk], A[kk * nb + jj]);
+        }
+        for (int ii = kk + 1; ii < nb; ii++) {
+            if (A[ii * nb + kk]) bdiv(A[kk * nb + kk], A[ii * nb + kk]);
+        }
+        for (int ii = kk + 1; ii < nb; ii++) {
+            if (!A[ii * nb + kk]) continue;
+            for (int jj = kk + 1; jj < nb; jj++) {
+                if (A[kk * nb + jj]) bmod(A[ii * nb + kk], A[kk * nb + jj], lu_fill_in(A, ii, jj));
+            }
+        }
+    }
+}
+
+// One task per kernel call, ordered by depend() on the block slots
+static void lu_depend(float** A, int untied) {
+    const int nb = LU_BLOCKS;
+    for (int kk = 0; kk < nb; kk++) {
+        float* diag = A[kk * nb + kk];
+        if (untied) {
+            #pragma omp task untied depend(inout: A[kk * nb + kk])
+            lu0(diag);
+        } else {
+            #pragma omp task depend(inout: A[kk * nb + kk])
+            lu0(diag);
+        }
+
+        for (int jj = kk + 1; jj < nb; jj++) {
+            float* col = A[kk * nb + jj];
+            if (!col) continue;
+            if (untied) {
+                #pragma omp task untied depend(in: A[kk * nb + kk]) depend(inout: A[kk * nb + jj])
+                fwd(diag, col);
+            } else {
+                #pragma omp task depend(in: A[kk * nb + kk]) depend(inout: A[kk * nb + jj])
+                fwd(diag, col);
+            }
+        }
+
+        for (int ii = kk + 1; ii < nb; ii++) {
+            float* row = A[ii * nb + kk];
+            if (!row) continue;
+            if (untied) {
+                #pragma omp task untied depend(in: A[kk * nb + kk]) depend(inout: A[ii * nb + kk])
+                bdiv(diag, row);
+            } else {
+                #pragma omp task depend(in: A[kk * nb + kk]) depend(inout: A[ii * nb + kk])
+                bdiv(diag, row);
+            }
+        }
+
+        for (int ii = kk + 1; ii < nb; ii++) {
+            float* row = A[ii * nb + kk];
+            if (!row) continue;
+            for (int jj = kk + 1; jj < nb; jj++) {
+                float* col = A[kk * nb + jj];
+                if (!col) continue;
+                float* inner = lu_fill_in(A, ii, jj);
+                if (untied) {
+                    #pragma omp task untied depend(in: A[ii * nb + kk], A[kk * nb + jj]) depend(inout: A[ii * nb + jj])
+                    bmod(row, col, inner);
+                } else {
+                    #pragma omp task depend(in: A[ii * nb + kk], A[kk * nb + jj]) depend(inout: A[ii * nb + jj])
+                    bmod(row, col, inner);
+                }
+            }
+        }
+    }
+    #pragma omp taskwait
+}
+
+// Phase by phase: each taskloop ends in an implicit taskgroup
+static void lu_taskloop(float** A) {
+    const int nb = LU_BLOCKS;
+    for (int kk = 0; kk < nb; kk++) {
+        float* diag = A[kk * nb + kk];
+        lu0(diag);
+
+        #pragma omp taskloop grainsize(1)
+        for (int jj = kk + 1; jj < nb; jj++) {
+            if (A[kk * nb + jj]) fwd(diag, A[kk * nb + jj]);
+        }
+
+        #pragma omp taskloop grainsize(1)
+        for (int ii = kk + 1; ii < nb; ii++) {
+            if (A[ii * nb + kk]) bdiv(diag, A[ii * nb + kk]);
+        }
+
+        // Allocate fill-in blocks before the updates run concurrently
+        for (int ii = kk + 1; ii < nb; ii++) {
+            if (!A[ii * nb + kk]) continue;
+            for (int jj = kk + 1; jj < nb; jj++) {
+                if (A[kk * nb + jj]) lu_fill_in(A, ii, jj);
+            }
+        }
+
+        #pragma omp taskloop collapse(2) grainsize(1)
+        for (int ii = kk + 1; ii < nb; ii++) {
+            for (int jj = kk + 1; jj < nb; jj++) {
+                if (A[ii * nb + kk] && A[kk * nb + jj]) bmod(A[ii * nb + kk], A[kk * nb + jj], A[ii * nb + jj]);
+            }
+        }
+    }
+}
+
+static double lu_checksum(float** A) {
+    double sum = 0.0;
+    for (int b = 0; b < LU_BLOCKS * LU_BLOCKS; b++) {
+        if (!A[b]) continue;
+        for (int e = 0; e < BS * BS; e++) sum += fabs(A[b][e]);
+    }
+    return sum;
+}
+
+// ---- Benchmark cases ----
+
+typedef enum { KERNEL_UTS_BINOMIAL = 0, KERNEL_UTS_GEOMETRIC, KERNEL_QUEENS, KERNEL_FIB, KERNEL_SPARSELU, NUM_KERNELS } Kernel;
+
+static const char* kernel_names[NUM_KERNELS] = { "uts_binomial", "uts_geometric", "nqueens", "fib", "sparselu" };
+
+typedef struct {
+    Kernel kernel;
+    Variant variant;
+    double result;
+} TaskArgs;
+
+void run_case(void* arg) {
+    TaskArgs* t = (TaskArgs*)arg;
+    double result = 0.0;
+    char board[QUEENS_MAX];
+    float** A = t->kernel == KERNEL_SPARSELU ? lu_generate() : NULL;
+
+    #pragma omp parallel
+    #pragma omp single
+    {
+        switch (t->kernel) {
+            case KERNEL_UTS_BINOMIAL: result = uts_task(TREE_BINOMIAL, 1, 0, t->variant); break;
+            case KERNEL_UTS_GEOMETRIC: result = uts_task(TREE_GEOMETRIC, 1, 0, t->variant); break;
+            case KERNEL_QUEENS: result = queens_task(board, 0, QUEENS_N, 0, t->variant); break;
+            case KERNEL_FIB: result = fib_task(FIB_N, 0, t->variant); break;
+            case KERNEL_SPARSELU:
+                if (t->variant == VARIANT_TASKLOOP) lu_taskloop(A);
+                else lu_depend(A, t->variant == VARIANT_UNTIED);
+                break;
+            default: break;
+        }
+    }
+
+    if (A) {
+        result = lu_checksum(A);
+        lu_free(A);
+    }
+    t->result = result;
+}
+
+// Sparse LU has no recursion to mark final
+static int variant_supported(Kernel k, Variant v) {
+    return k != KERNEL_SPARSELU || (v != VARIANT_FINAL && v != VARIANT_MERGEABLE);
+}
+
+// Tasks one run creates and the answer it must produce
+static void expected_results(Kernel k, Variant v, long* tasks, double* answer) {
+    int cutoff = k == KERNEL_QUEENS ? QUEENS_CUTOFF : CUTOFF_DEPTH;
+    int limit = serial_past_cutoff(v) ? cutoff : INT_MAX;
+    char board[QUEENS_MAX];
+
+    switch (k) {
+        case KERNEL_UTS_BINOMIAL:
+            *tasks = uts_count(TREE_BINOMIAL, 1, 0, limit);
+            *answer = uts_serial(TREE_BINOMIAL, 1, 0);
+            break;
+        case KERNEL_UTS_GEOMETRIC:
+            *tasks = uts_count(TREE_GEOMETRIC, 1, 0, limit);
+            *answer = uts_serial(TREE_GEOMETRIC, 1, 0);
+            break;
+        case KERNEL_QUEENS:
+            *tasks = queens_count(board, 0, QUEENS_N, 0, limit);
+            *answer = queens_serial(board, 0, QUEENS_N);
+            break;
+        case KERNEL_FIB:
+            *tasks = fib_count(FIB_N, 0, limit);
+            *answer = fib_serial(FIB_N);
+            break;
+        case KERNEL_SPARSELU: {
+            float** A = lu_generate();
+            lu_serial(A);
+            *tasks = lu_count();
+            *answer = lu_checksum(A);
+            lu_free(A);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : omp_get_num_procs();
+
+    int thread_counts[32];
+    int num_counts = 0;
+    for (int t = 1; t < max_threads && num_counts < 31; t *= 2) thread_counts[num_counts++] = t;
+    thread_counts[num_counts++] = max_threads;
+
+    long tasks[NUM_KERNELS][NUM_VARIANTS];
+    double answers[NUM_KERNELS][NUM_VARIANTS];
+    double* medians = (double*)calloc(num_counts * NUM_KERNELS * NUM_VARIANTS, sizeof(double));
+    if (!medians) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+
+    bench_report_begin("irregular_tasks");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "Cutoff depth %d (N-Queens %d); UTS binomial b0=%d m=%d q=%.4f, geometric b=%.1f d=%d; "
+                 "%d-queens; fib(%d); sparse LU %dx%d blocks of %d\n\n",
+            CUTOFF_DEPTH, QUEENS_CUTOFF, BIN_ROOT_CHILDREN, BIN_CHILDREN, BIN_PROBABILITY, GEO_BRANCH, GEO_DEPTH,
+            QUEENS_N, FIB_N, LU_BLOCKS, LU_BLOCKS, LU_BLOCK_SIZE);
+
+    for (int k = 0; k < NUM_KERNELS; k++) {
+        for (int v = 0; v < NUM_VARIANTS; v++) {
+            if (variant_supported(k, v)) expected_results(k, v, &tasks[k][v], &answers[k][v]);
+        }
+    }
+
+    int errors = 0;
+    char name[BENCH_NAME_LEN];
+    for (int t = 0; t < num_counts; t++) {
+        omp_set_num_threads(thread_counts[t]);
+
+        for (int k = 0; k < NUM_KERNELS; k++) {
+            for (int v = 0; v < NUM_VARIANTS; v++) {
+                if (!variant_supported(k, v)) continue;
+
+                TaskArgs args = { k, v, 0.0 };
+                bench_result_t result;
+
+                snprintf(name, sizeof(name), "%s/%s", kernel_names[k], variant_names[v]);
+                bench_run(NULL, name, tasks[k][v], run_case, &args, &result);
+                bench_report_result(&result);
+                medians[(t * NUM_KERNELS + k) * NUM_VARIANTS + v] = result.median;
+                bench_result_free(&result);
+
+                if (fabs(args.result - answers[k][v]) > 1e-6 * fabs(answers[k][v])) {
+                    fprintf(msg, "%s: wrong result %.6f, expected %.6f\n", name, args.result, answers[k][v]);
+                    errors++;
+                }
+            }
+        }
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\n%-26s %10s %12s", "case", "tasks", "Mtasks/s");
+    for (int t = 0; t < num_counts; t++) fprintf(msg, "   S(%3d)", thread_counts[t]);
+    fprintf(msg, "\n");
+    for (int k = 0; k < NUM_KERNELS; k++) {
+        for (int v = 0; v < NUM_VARIANTS; v++) {
+            if (!variant_supported(k, v)) continue;
+
+            double base = medians[k * NUM_VARIANTS + v];
+            double last = medians[((num_counts - 1) * NUM_KERNELS + k) * NUM_VARIANTS + v];
+            snprintf(name, sizeof(name), "%s/%s", kernel_names[k], variant_names[v]);
+            fprintf(msg, "%-26s %10ld %12.3f", name, tasks[k][v], tasks[k][v] / last / 1e6);
+            for (int t = 0; t < num_counts; t++) {
+                fprintf(msg, " %8.2f", base / medians[(t * NUM_KERNELS + k) * NUM_VARIANTS + v]);
+            }
+            fprintf(msg, "\n");
+        }
+    }
+    if (errors) fprintf(msg, "\n%d case(s) produced a wrong result!\n", errors);
+
+    free(medians);
+    return errors || regressions ? 1 : 0;
+}
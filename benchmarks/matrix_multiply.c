@@ -2,9 +2,9 @@
 #include <stdlib.h>
 #include <omp.h>
 #include "../include/omp_utils.h"
+#include "../include/bench_harness.h"
 
-#define SIZE 1000
-#define ITERATIONS 3
+#define DEFAULT_SIZE 1000
 
 void matrix_multiply_seq(double **A, double **B, double **C, int n) {
     for (int i = 0; i < n; i++) {
@@ -29,10 +29,27 @@ void matrix_multiply_parallel(double **A, double **B, double **C, int n) {
     }
 }
 
+typedef struct {
+    double **A, **B, **C;
+    int n;
+} matmul_args_t;
+
+static void run_matmul_seq(void* arg) {
+    matmul_args_t* m = (matmul_args_t*)arg;
+    matrix_multiply_seq(m->A, m->B, m->C, m->n);
+}
+
+static void run_matmul_parallel(void* arg) {
+    matmul_args_t* m = (matmul_args_t*)arg;
+    matrix_multiply_parallel(m->A, m->B, m->C, m->n);
+}
+
 int main() {
     double **A, **B, **C;
-    double start, end;
-    double seq_time = 0.0, parallel_time = 0.0;
+    bench_result_t seq, parallel;
+    
+    // Matrix dimension; GEMM work grows with its cube
+    const int SIZE = (int)bench_problem_size(DEFAULT_SIZE, 3);
     
     // Allocate memory
     A = (double**)malloc(SIZE * sizeof(double*));
@@ -53,30 +70,24 @@ int main() {
         }
     }
     
-    printf("Matrix multiplication benchmark (%d x %d)\n", SIZE, SIZE);
-    print_omp_info();
+    bench_report_begin("matrix_multiply");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "Matrix multiplication benchmark (%d x %d)\n", SIZE, SIZE);
     
-    // Sequential benchmark
-    for (int iter = 0; iter < ITERATIONS; iter++) {
-        start = omp_get_time();
-        matrix_multiply_seq(A, B, C, SIZE);
-        end = omp_get_time();
-        seq_time += (end - start);
-        printf("Sequential iteration %d: %.4f seconds\n", iter + 1, end - start);
-    }
+    matmul_args_t args = { A, B, C, SIZE };
     
-    // Parallel benchmark
-    for (int iter = 0; iter < ITERATIONS; iter++) {
-        start = omp_get_time();
-        matrix_multiply_parallel(A, B, C, SIZE);
-        end = omp_get_time();
-        parallel_time += (end - start);
-        printf("Parallel iteration %d: %.4f seconds\n", iter + 1, end - start);
-    }
+    // Sequential and parallel benchmarks
+    bench_run(NULL, "matmul_seq", (long)SIZE * SIZE, run_matmul_seq, &args, &seq);
+    bench_report_result(&seq);
+    
+    bench_run(NULL, "matmul_parallel", (long)SIZE * SIZE, run_matmul_parallel, &args, &parallel);
+    bench_report_result(&parallel);
+    
+    int regressions = bench_report_end();
+    fprintf(msg, "\nSpeedup (median): %.2f\n", seq.median / parallel.median);
     
-    printf("\nAverage sequential time: %.4f seconds\n", seq_time / ITERATIONS);
-    printf("Average parallel time: %.4f seconds\n", parallel_time / ITERATIONS);
-    printf("Speedup: %.2f\n", seq_time / parallel_time);
+    bench_result_free(&seq);
+    bench_result_free(&parallel);
     
     // Free memory
     for (int i = 0; i < SIZE; i++) {
@@ -88,5 +99,5 @@ int main() {
     free(B);
     free(C);
     
-    return 0;
+    return regressions ? 1 : 0;
 }
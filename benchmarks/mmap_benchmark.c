@@ -0,0 +1,222 @@
+// Zero-copy mmap input (include/mmap_reader.h) against read() into malloc'ed
+// buffers, the way the pipeline examples load their data.
+//
+// A file of BENCH_SIZE bytes (2 GB by default) is processed in 4 MB chunks,
+// one task per chunk, each computing a checksum of its bytes:
+//   read_malloc    every task mallocs a buffer and preads its chunk into it
+//   mmap           tasks get views into a plain mapping, pages fault on first touch
+//   mmap_populate  MAP_POPULATE faults the whole file in during mmap()
+//   mmap_prefault  MADV_SEQUENTIAL|MADV_WILLNEED, then every thread faults its
+//                  share of the pages in parallel before the tasks run
+// Each strategy runs with a warm page cache (the file stays cached between
+// runs) and a cold one (evicted with posix_fadvise before every run; the
+// eviction itself is timed too but costs little next to reading the file).
+//
+// Usage: mmap_benchmark [file]   (default: generated in BENCH_TMPDIR, then removed)
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/mmap_reader.h"
+
+#define FILE_SIZE (2L << 30)
+#define CHUNK_SIZE (4 << 20)
+
+typedef enum { READ_MALLOC = 0, MMAP_PLAIN, MMAP_POPULATED, MMAP_PREFAULTED } Strategy;
+
+typedef struct {
+    const char* path;
+    Strategy strategy;
+    int cold;
+    size_t size;
+    uint64_t checksum;
+    int errors;
+} BenchArgs;
+
+// Sum of the 8-byte words of a chunk, plus the trailing bytes
+static uint64_t checksum_chunk(const char* data, size_t size) {
+    uint64_t sum = 0;
+    size_t words = size / 8;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t w;
+        memcpy(&w, data + 8 * i, 8);
+        sum += w;
+    }
+    for (size_t i = words * 8; i < size; i++) sum += (unsigned char)data[i];
+    return sum;
+}
+
+static void run_read_malloc(BenchArgs* b) {
+    int fd = open(b->path, O_RDONLY);
+    if (fd < 0) {
+        b->errors++;
+        return;
+    }
+    uint64_t checksum = 0;
+    long chunks = (long)((b->size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    #pragma omp parallel
+    #pragma omp single
+    for (long c = 0; c < chunks; c++) {
+        #pragma omp task firstprivate(c)
+        {
+            size_t offset = (size_t)c * CHUNK_SIZE;
+            size_t size = b->size - offset < CHUNK_SIZE ? b->size - offset : CHUNK_SIZE;
+            char* buffer = (char*)malloc(size);
+            size_t done = 0;
+            while (buffer && done < size) {
+                ssize_t n = pread(fd, buffer + done, size - done, offset + done);
+                if (n <= 0) break;
+                done += n;
+            }
+            if (buffer && done == size) {
+                uint64_t sum = checksum_chunk(buffer, size);
+                #pragma omp atomic
+                checksum += sum;
+            } else {
+                #pragma omp atomic
+                b->errors++;
+            }
+            free(buffer);
+        }
+    }
+    close(fd);
+    b->checksum = checksum;
+}
+
+static void run_mmap(BenchArgs* b) {
+    int flags = 0;
+    if (b->strategy == MMAP_POPULATED) flags = MMAP_POPULATE;
+    if (b->strategy == MMAP_PREFAULTED) flags = MMAP_SEQUENTIAL | MMAP_WILLNEED | MMAP_PREFAULT;
+    mmap_file_t* file = mmap_file_open(b->path, flags);
+    if (!file) {
+        b->errors++;
+        return;
+    }
+    long chunks = mmap_file_views(file, CHUNK_SIZE, NULL, 0);
+    mmap_view_t* views = (mmap_view_t*)malloc(chunks * sizeof(mmap_view_t));
+    if (!views) {
+        b->errors++;
+        mmap_file_close(file);
+        return;
+    }
+    mmap_file_views(file, CHUNK_SIZE, views, chunks);
+    uint64_t checksum = 0;
+
+    #pragma omp parallel
+    #pragma omp single
+    for (long c = 0; c < chunks; c++) {
+        #pragma omp task firstprivate(c)
+        {
+            uint64_t sum = checksum_chunk(views[c].data, views[c].size);
+            #pragma omp atomic
+            checksum += sum;
+        }
+    }
+    free(views);
+    mmap_file_close(file);
+    b->checksum = checksum;
+}
+
+static void run_strategy(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    if (b->cold && mmap_file_evict(b->path) != 0) b->errors++;
+    if (b->strategy == READ_MALLOC) {
+        run_read_malloc(b);
+    } else {
+        run_mmap(b);
+    }
+}
+
+// Pseudo-random bytes, written in 1 MB blocks
+static int generate_input(const char* path, long size) {
+    FILE* out = fopen(path, "w");
+    if (!out) return -1;
+    uint64_t block[1 << 17];
+    uint64_t x = 42;
+    for (long written = 0; written < size; written += sizeof(block)) {
+        for (int i = 0; i < (1 << 17); i++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            block[i] = x;
+        }
+        long n = size - written < (long)sizeof(block) ? size - written : (long)sizeof(block);
+        if (fwrite(block, 1, n, out) != (size_t)n) {
+            fclose(out);
+            return -1;
+        }
+    }
+    return fclose(out);
+}
+
+int main(int argc, char* argv[]) {
+    const long size = bench_problem_size(FILE_SIZE, 1);
+    const char* tmp = getenv("BENCH_TMPDIR");
+    char path[512];
+    int generated = argc < 2;
+
+    if (generated) {
+        snprintf(path, sizeof(path), "%s/mmap_benchmark.%d.bin", tmp && *tmp ? tmp : "/tmp", (int)getpid());
+        if (generate_input(path, size) != 0) {
+            fprintf(stderr, "Could not write %ld bytes to %s\n", size, path);
+            unlink(path);
+            return 1;
+        }
+    } else {
+        snprintf(path, sizeof(path), "%s", argv[1]);
+    }
+    mmap_file_t* probe = mmap_file_open(path, 0);
+    if (!probe) {
+        fprintf(stderr, "Could not map %s\n", path);
+        if (generated) unlink(path);
+        return 1;
+    }
+    size_t file_size = probe->size;
+    uint64_t expected = checksum_chunk(probe->data, probe->size);
+    mmap_file_close(probe);
+
+    const char* names[] = { "read_malloc", "mmap", "mmap_populate", "mmap_prefault" };
+    double medians[2][4];
+    int errors = 0;
+
+    bench_report_begin("mmap_benchmark");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "Input: %s, %.2f GB in %d MB chunks\n", path, file_size / 1e9, CHUNK_SIZE >> 20);
+
+    for (int cold = 0; cold < 2; cold++) {
+        for (int s = 0; s < 4; s++) {
+            BenchArgs args = { path, (Strategy)s, cold, file_size, 0, 0 };
+            char name[BENCH_NAME_LEN];
+            snprintf(name, sizeof(name), "%s/%s", names[s], cold ? "cold" : "warm");
+            bench_result_t result;
+
+            bench_run(NULL, name, (long)file_size, run_strategy, &args, &result);
+            bench_report_result(&result);
+            medians[cold][s] = result.median;
+            bench_result_free(&result);
+
+            if (args.errors || args.checksum != expected) {
+                fprintf(msg, "%s: wrong checksum or I/O error\n", name);
+                errors++;
+            }
+        }
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\n%-16s %12s %12s %12s %12s\n", "strategy", "warm MB/s", "cold MB/s", "warm vs read", "cold vs read");
+    for (int s = 0; s < 4; s++) {
+        fprintf(msg, "%-16s %12.0f %12.0f %11.2fx %11.2fx\n", names[s],
+                file_size / medians[0][s] / 1e6, file_size / medians[1][s] / 1e6,
+                medians[0][READ_MALLOC] / medians[0][s], medians[1][READ_MALLOC] / medians[1][s]);
+    }
+    if (errors) fprintf(msg, "\n%d case(s) produced a wrong result!\n", errors);
+
+    if (generated) unlink(path);
+    return errors || regressions ? 1 : 0;
+}
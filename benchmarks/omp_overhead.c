@@ -0,0 +1,405 @@
+// OpenMP runtime overhead microbenchmarks in the style of the EPCC suite
+// (syncbench, schedbench, taskbench). Each construct is executed INNER_REPS
+// times around a small calibrated delay; its overhead is the difference to a
+// reference run of the same delays without the construct, divided by INNER_REPS.
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+
+#define INNER_REPS 1000
+#define DELAY_TIME 0.1e-6      // Target duration of one delay (seconds)
+#define ITERS_PER_THREAD 128   // schedbench loop iterations per thread
+
+typedef struct {
+    int reps;
+    int delay_length;
+    int chunk;
+    double sum;
+} OverheadArgs;
+
+// Busy loop whose length is calibrated once at start-up
+static void delay(int length) {
+    volatile double a = 0.0;
+    for (int i = 0; i < length; i++) a += i;
+}
+
+static int calibrate_delay(double target) {
+    int length = 1;
+    for (;;) {
+        double start = omp_get_wtime();
+        for (int r = 0; r < 10000; r++) delay(length);
+        double per_call = (omp_get_wtime() - start) / 10000;
+        if (per_call >= target) return length;
+        length *= 2;
+    }
+}
+
+// ---- Reference loops ----
+
+// Delays executed once per repetition on a single thread
+void ref_serial(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    for (int j = 0; j < o->reps; j++) delay(o->delay_length);
+}
+
+// Delays executed once per repetition by every thread of one region
+void ref_parallel(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        for (int j = 0; j < o->reps; j++) delay(o->delay_length);
+    }
+}
+
+// Per-thread share of reps delays (for constructs that serialize or distribute work)
+void ref_shared(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int share = o->reps / omp_get_num_threads();
+        for (int j = 0; j < share; j++) delay(o->delay_length);
+    }
+}
+
+// Plain increments, reference for atomic
+void ref_atomic(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int share = o->reps / omp_get_num_threads();
+        volatile double x = 0.0;
+        for (int j = 0; j < share; j++) x += 1.0;
+    }
+}
+
+// schedbench reference: each thread runs its share of iterations without a worksharing loop
+void ref_schedule(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        for (int j = 0; j < o->reps; j++) {
+            for (int i = 0; i < ITERS_PER_THREAD; i++) delay(o->delay_length);
+        }
+    }
+}
+
+// ---- syncbench ----
+
+void test_parallel(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    for (int j = 0; j < o->reps; j++) {
+        #pragma omp parallel
+        delay(o->delay_length);
+    }
+}
+
+void test_for(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int nthreads = omp_get_num_threads();
+        for (int j = 0; j < o->reps; j++) {
+            #pragma omp for
+            for (int i = 0; i < nthreads; i++) delay(o->delay_length);
+        }
+    }
+}
+
+void test_parallel_for(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    int nthreads = omp_get_max_threads();
+    for (int j = 0; j < o->reps; j++) {
+        #pragma omp parallel for
+        for (int i = 0; i < nthreads; i++) delay(o->delay_length);
+    }
+}
+
+void test_barrier(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        for (int j = 0; j < o->reps; j++) {
+            delay(o->delay_length);
+            #pragma omp barrier
+        }
+    }
+}
+
+void test_single(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        for (int j = 0; j < o->reps; j++) {
+            #pragma omp single
+            delay(o->delay_length);
+        }
+    }
+}
+
+void test_critical(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int share = o->reps / omp_get_num_threads();
+        for (int j = 0; j < share; j++) {
+            #pragma omp critical
+            delay(o->delay_length);
+        }
+    }
+}
+
+void test_lock(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    omp_lock_t lock;
+    omp_init_lock(&lock);
+    #pragma omp parallel
+    {
+        int share = o->reps / omp_get_num_threads();
+        for (int j = 0; j < share; j++) {
+            omp_set_lock(&lock);
+            delay(o->delay_length);
+            omp_unset_lock(&lock);
+        }
+    }
+    omp_destroy_lock(&lock);
+}
+
+void test_atomic(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    double x = 0.0;
+    #pragma omp parallel
+    {
+        int share = o->reps / omp_get_num_threads();
+        for (int j = 0; j < share; j++) {
+            #pragma omp atomic
+            x += 1.0;
+        }
+    }
+    o->sum = x;
+}
+
+void test_reduction(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    double x = 0.0;
+    for (int j = 0; j < o->reps; j++) {
+        #pragma omp parallel reduction(+:x)
+        {
+            delay(o->delay_length);
+            x += 1.0;
+        }
+    }
+    o->sum = x;
+}
+
+// ---- schedbench ----
+
+void test_static(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int iters = ITERS_PER_THREAD * omp_get_num_threads();
+        for (int j = 0; j < o->reps; j++) {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < iters; i++) delay(o->delay_length);
+        }
+    }
+}
+
+void test_static_chunk(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int iters = ITERS_PER_THREAD * omp_get_num_threads();
+        for (int j = 0; j < o->reps; j++) {
+            #pragma omp for schedule(static, o->chunk)
+            for (int i = 0; i < iters; i++) delay(o->delay_length);
+        }
+    }
+}
+
+void test_dynamic(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int iters = ITERS_PER_THREAD * omp_get_num_threads();
+        for (int j = 0; j < o->reps; j++) {
+            #pragma omp for schedule(dynamic, o->chunk)
+            for (int i = 0; i < iters; i++) delay(o->delay_length);
+        }
+    }
+}
+
+void test_guided(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int iters = ITERS_PER_THREAD * omp_get_num_threads();
+        for (int j = 0; j < o->reps; j++) {
+            #pragma omp for schedule(guided, o->chunk)
+            for (int i = 0; i < iters; i++) delay(o->delay_length);
+        }
+    }
+}
+
+// ---- taskbench ----
+
+// Every thread creates its share of tasks
+void test_parallel_task(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int share = o->reps / omp_get_num_threads();
+        for (int j = 0; j < share; j++) {
+            #pragma omp task
+            delay(o->delay_length);
+        }
+    }
+}
+
+// One thread creates all tasks, the others execute them
+void test_master_task(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        #pragma omp master
+        {
+            for (int j = 0; j < o->reps; j++) {
+                #pragma omp task
+                delay(o->delay_length);
+            }
+        }
+    }
+}
+
+void test_taskwait(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int share = o->reps / omp_get_num_threads();
+        for (int j = 0; j < share; j++) {
+            #pragma omp task
+            delay(o->delay_length);
+            #pragma omp taskwait
+        }
+    }
+}
+
+void test_taskgroup(void* arg) {
+    OverheadArgs* o = (OverheadArgs*)arg;
+    #pragma omp parallel
+    {
+        int share = o->reps / omp_get_num_threads();
+        for (int j = 0; j < share; j++) {
+            #pragma omp taskgroup
+            {
+                #pragma omp task
+                delay(o->delay_length);
+            }
+        }
+    }
+}
+
+typedef struct {
+    const char* suite;
+    const char* name;
+    bench_fn_t test;
+    bench_fn_t reference;
+    int chunk;
+} Construct;
+
+static const Construct constructs[] = {
+    { "sync",  "parallel",        test_parallel,      ref_serial,   0 },
+    { "sync",  "for",             test_for,           ref_parallel, 0 },
+    { "sync",  "parallel_for",    test_parallel_for,  ref_serial,   0 },
+    { "sync",  "barrier",         test_barrier,       ref_parallel, 0 },
+    { "sync",  "single",          test_single,        ref_parallel, 0 },
+    { "sync",  "critical",        test_critical,      ref_shared,   0 },
+    { "sync",  "lock",            test_lock,          ref_shared,   0 },
+    { "sync",  "atomic",          test_atomic,        ref_atomic,   0 },
+    { "sync",  "reduction",       test_reduction,     ref_serial,   0 },
+    { "sched", "static",          test_static,        ref_schedule, 0 },
+    { "sched", "static,1",        test_static_chunk,  ref_schedule, 1 },
+    { "sched", "static,8",        test_static_chunk,  ref_schedule, 8 },
+    { "sched", "dynamic,1",       test_dynamic,       ref_schedule, 1 },
+    { "sched", "dynamic,8",       test_dynamic,       ref_schedule, 8 },
+    { "sched", "dynamic,64",      test_dynamic,       ref_schedule, 64 },
+    { "sched", "guided,1",        test_guided,        ref_schedule, 1 },
+    { "sched", "guided,8",        test_guided,        ref_schedule, 8 },
+    { "task",  "parallel_task",   test_parallel_task, ref_shared,   0 },
+    { "task",  "master_task",     test_master_task,   ref_shared,   0 },
+    { "task",  "taskwait",        test_taskwait,      ref_shared,   0 },
+    { "task",  "taskgroup",       test_taskgroup,     ref_shared,   0 },
+};
+
+int main(int argc, char* argv[]) {
+    // Spinning waits make oversubscribed runs meaningless, so sweep up to the
+    // number of processors unless told otherwise
+    int max_threads = omp_get_num_procs();
+    if (argc > 1) {
+        char* end;
+        long value = strtol(argv[1], &end, 10);
+        if (end == argv[1] || *end || value < 1 || value > INT_MAX) {
+            fprintf(stderr, "Usage: %s [max_threads >= 1]\n", argv[0]);
+            return 1;
+        }
+        max_threads = (int)value;
+    }
+    int num_constructs = sizeof(constructs) / sizeof(constructs[0]);
+    int delay_length = calibrate_delay(DELAY_TIME);
+
+    bench_report_begin("omp_overhead");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "Delay length %d (~%.2f us), %d repetitions per sample\n\n",
+            delay_length, DELAY_TIME * 1e6, INNER_REPS);
+
+    // Overheads per thread count, printed as one table at the end
+    int thread_counts[32];
+    int num_counts = 0;
+    for (int t = 1; t < max_threads && num_counts < 31; t *= 2) thread_counts[num_counts++] = t;
+    thread_counts[num_counts++] = max_threads;
+
+    double* overhead = (double*)malloc(num_counts * num_constructs * sizeof(double));
+    if (!overhead) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+
+    char name[BENCH_NAME_LEN];
+    for (int t = 0; t < num_counts; t++) {
+        omp_set_num_threads(thread_counts[t]);
+
+        for (int c = 0; c < num_constructs; c++) {
+            OverheadArgs args = { INNER_REPS, delay_length, constructs[c].chunk, 0.0 };
+            bench_result_t test, ref;
+
+            snprintf(name, sizeof(name), "%s/%s", constructs[c].suite, constructs[c].name);
+            bench_run(NULL, name, INNER_REPS, constructs[c].test, &args, &test);
+            bench_report_result(&test);
+
+            snprintf(name, sizeof(name), "%s/%s:reference", constructs[c].suite, constructs[c].name);
+            bench_run(NULL, name, INNER_REPS, constructs[c].reference, &args, &ref);
+            bench_report_result(&ref);
+
+            overhead[t * num_constructs + c] = (test.median - ref.median) / INNER_REPS * 1e6;
+            bench_result_free(&test);
+            bench_result_free(&ref);
+        }
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\nOverhead per construct (microseconds):\n%-22s", "construct");
+    for (int t = 0; t < num_counts; t++) fprintf(msg, " %8d", thread_counts[t]);
+    fprintf(msg, "\n");
+    for (int c = 0; c < num_constructs; c++) {
+        snprintf(name, sizeof(name), "%s/%s", constructs[c].suite, constructs[c].name);
+        fprintf(msg, "%-22s", name);
+        for (int t = 0; t < num_counts; t++) fprintf(msg, " %8.3f", overhead[t * num_constructs + c]);
+        fprintf(msg, "\n");
+    }
+
+    free(overhead);
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,321 @@
+// Inter-thread queues (include/ring_buffer.h) against a lock-protected ring.
+// P producer threads push items that C consumer threads pop, for the
+// 1p1c, 2p2c, 4p4c, 1p4c and 4p1c configurations. Reports throughput in
+// million items per second and the push-to-pop latency (p50/p99) of a sample
+// of the items, which carry the time they were pushed.
+//
+// Producers and consumers spin on a full or empty queue and yield the CPU
+// after a while, so oversubscribed runs (more threads than cores) still make
+// progress, but the numbers are only meaningful with P + C free cores.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sched.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/ring_buffer.h"
+
+#define NUM_ITEMS (1 << 20)  // Items per run, split across producers
+#define QUEUE_CAPACITY 1024
+#define BATCH_SIZE 32        // Items per call of the batch variant
+#define SAMPLE_EVERY 64      // One item in SAMPLE_EVERY carries a timestamp
+#define YIELD_AFTER 64       // Failed attempts before yielding the CPU
+#define MAX_CONSUMERS 4      // Largest C of the configurations
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// ---- Lock-protected ring, the baseline ----
+
+typedef struct {
+    omp_lock_t lock;
+    void** items;
+    size_t capacity;
+    size_t head;
+    size_t count;
+} LockedQueue;
+
+static void* locked_create(size_t capacity) {
+    LockedQueue* q = (LockedQueue*)malloc(sizeof(LockedQueue));
+    if (!q) return NULL;
+    q->items = (void**)malloc(capacity * sizeof(void*));
+    if (!q->items) {
+        free(q);
+        return NULL;
+    }
+    omp_init_lock(&q->lock);
+    q->capacity = capacity;
+    q->head = 0;
+    q->count = 0;
+    return q;
+}
+
+static void locked_destroy(void* queue) {
+    LockedQueue* q = (LockedQueue*)queue;
+    omp_destroy_lock(&q->lock);
+    free(q->items);
+    free(q);
+}
+
+static size_t locked_push(void* queue, void* const* items, size_t n) {
+    LockedQueue* q = (LockedQueue*)queue;
+    omp_set_lock(&q->lock);
+    size_t pushed = 0;
+    for (; pushed < n && q->count < q->capacity; pushed++) {
+        q->items[(q->head + q->count) % q->capacity] = items[pushed];
+        q->count++;
+    }
+    omp_unset_lock(&q->lock);
+    return pushed;
+}
+
+static size_t locked_pop(void* queue, void** items, size_t max) {
+    LockedQueue* q = (LockedQueue*)queue;
+    omp_set_lock(&q->lock);
+    size_t popped = 0;
+    for (; popped < max && q->count > 0; popped++) {
+        items[popped] = q->items[q->head];
+        q->head = (q->head + 1) % q->capacity;
+        q->count--;
+    }
+    omp_unset_lock(&q->lock);
+    return popped;
+}
+
+// ---- Adapters to a common batch interface ----
+
+static void* spsc_create(size_t capacity) { return ring_spsc_create(capacity); }
+static void spsc_destroy(void* q) { ring_spsc_destroy((ring_spsc_t*)q); }
+static size_t spsc_push(void* q, void* const* items, size_t n) {
+    (void)n;
+    return ring_spsc_push((ring_spsc_t*)q, items[0]);
+}
+static size_t spsc_pop(void* q, void** items, size_t max) {
+    (void)max;
+    return ring_spsc_pop((ring_spsc_t*)q, items);
+}
+
+static void* mpmc_create(size_t capacity) { return ring_mpmc_create(capacity); }
+static void mpmc_destroy(void* q) { ring_mpmc_destroy((ring_mpmc_t*)q); }
+static size_t mpmc_push(void* q, void* const* items, size_t n) {
+    (void)n;
+    return ring_mpmc_push((ring_mpmc_t*)q, items[0]);
+}
+static size_t mpmc_pop(void* q, void** items, size_t max) {
+    (void)max;
+    return ring_mpmc_pop((ring_mpmc_t*)q, items);
+}
+static size_t mpmc_push_batch(void* q, void* const* items, size_t n) {
+    return ring_mpmc_push_batch((ring_mpmc_t*)q, items, n);
+}
+static size_t mpmc_pop_batch(void* q, void** items, size_t max) {
+    return ring_mpmc_pop_batch((ring_mpmc_t*)q, items, max);
+}
+
+typedef struct {
+    const char* name;
+    int single_producer_consumer;  // Only valid for 1p1c
+    size_t batch;
+    void* (*create)(size_t capacity);
+    void (*destroy)(void* queue);
+    size_t (*push)(void* queue, void* const* items, size_t n);
+    size_t (*pop)(void* queue, void** items, size_t max);
+} QueueKind;
+
+// ---- Benchmark ----
+
+typedef struct {
+    const QueueKind* kind;
+    void* queue;
+    int producers;
+    int consumers;
+    long items;
+    atomic_int producers_done;
+    long consumed[MAX_CONSUMERS];        // Per consumer, checked after the run
+    uint64_t* latencies[MAX_CONSUMERS];  // Per consumer samples of the last run
+    long num_latencies[MAX_CONSUMERS];
+} BenchArgs;
+
+// Items are integers disguised as pointers: odd values carry the push time
+// in ns, even values a sequence number
+static void produce(BenchArgs* b, int producer) {
+    const QueueKind* k = b->kind;
+    long first = b->items * producer / b->producers;
+    long last = b->items * (producer + 1) / b->producers;
+    void* batch[BATCH_SIZE];
+
+    for (long i = first; i < last;) {
+        size_t n = 0;
+        for (; n < k->batch && i + (long)n < last; n++) {
+            uint64_t value = (i + n) % SAMPLE_EVERY == 0 ? now_ns() << 1 | 1 : (uint64_t)(i + n) << 1;
+            batch[n] = (void*)(uintptr_t)value;
+        }
+        size_t pushed = 0;
+        int failed = 0;
+        while (pushed < n) {
+            size_t m = k->push(b->queue, batch + pushed, n - pushed);
+            pushed += m;
+            if (m) {
+                failed = 0;
+            } else if (++failed >= YIELD_AFTER) {
+                sched_yield();
+                failed = 0;
+            }
+        }
+        i += n;
+    }
+    atomic_fetch_add_explicit(&b->producers_done, 1, memory_order_release);
+}
+
+static void consume(BenchArgs* b, int consumer) {
+    const QueueKind* k = b->kind;
+    void* batch[BATCH_SIZE];
+    long count = 0, samples = 0;
+    int failed = 0;
+
+    for (;;) {
+        // Read the flag before popping: empty after every producer finished means done
+        int done = atomic_load_explicit(&b->producers_done, memory_order_acquire) == b->producers;
+        size_t n = k->pop(b->queue, batch, k->batch);
+        if (n == 0) {
+            if (done) break;
+            if (++failed >= YIELD_AFTER) {
+                sched_yield();
+                failed = 0;
+            }
+            continue;
+        }
+        failed = 0;
+        count += n;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t value = (uint64_t)(uintptr_t)batch[i];
+            if (value & 1) b->latencies[consumer][samples++] = now_ns() - (value >> 1);
+        }
+    }
+    b->consumed[consumer] = count;
+    b->num_latencies[consumer] = samples;
+}
+
+static void run_queue(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    atomic_store(&b->producers_done, 0);
+
+    #pragma omp parallel num_threads(b->producers + b->consumers)
+    {
+        int id = omp_get_thread_num();
+        if (id < b->producers) {
+            produce(b, id);
+        } else {
+            consume(b, id - b->producers);
+        }
+    }
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+int main() {
+    const long items = bench_problem_size(NUM_ITEMS, 1);
+    const QueueKind kinds[] = {
+        { "spsc", 1, 1, spsc_create, spsc_destroy, spsc_push, spsc_pop },
+        { "mpmc", 0, 1, mpmc_create, mpmc_destroy, mpmc_push, mpmc_pop },
+        { "mpmc_batch", 0, BATCH_SIZE, mpmc_create, mpmc_destroy, mpmc_push_batch, mpmc_pop_batch },
+        { "omp_lock", 0, 1, locked_create, locked_destroy, locked_push, locked_pop },
+    };
+    const int configs[][2] = { { 1, 1 }, { 2, 2 }, { 4, 4 }, { 1, 4 }, { 4, 1 } };
+    int num_kinds = sizeof(kinds) / sizeof(kinds[0]);
+    int num_configs = sizeof(configs) / sizeof(configs[0]);
+
+    // Let the parallel regions have P + C threads however OMP_NUM_THREADS is set
+    omp_set_dynamic(0);
+
+    static BenchArgs args;
+    long max_samples = items / SAMPLE_EVERY + 1;
+    for (int c = 0; c < MAX_CONSUMERS; c++) {
+        args.latencies[c] = (uint64_t*)malloc(max_samples * sizeof(uint64_t));
+        if (!args.latencies[c]) {
+            fprintf(stderr, "Memory allocation failed!\n");
+            return 1;
+        }
+    }
+    uint64_t* all_latencies = (uint64_t*)malloc(MAX_CONSUMERS * max_samples * sizeof(uint64_t));
+    if (!all_latencies) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+
+    typedef struct {
+        char name[BENCH_NAME_LEN];
+        double median;
+        uint64_t p50, p99;
+    } Row;
+    Row rows[32];
+    int num_rows = 0, errors = 0;
+
+    bench_report_begin("queue_benchmark");
+    FILE* msg = bench_log_stream();
+
+    for (int k = 0; k < num_kinds; k++) {
+        for (int c = 0; c < num_configs; c++) {
+            int producers = configs[c][0], consumers = configs[c][1];
+            if (kinds[k].single_producer_consumer && (producers > 1 || consumers > 1)) continue;
+
+            args.kind = &kinds[k];
+            args.queue = kinds[k].create(QUEUE_CAPACITY);
+            args.producers = producers;
+            args.consumers = consumers;
+            args.items = items;
+            if (!args.queue) {
+                fprintf(stderr, "Could not create the %s queue\n", kinds[k].name);
+                return 1;
+            }
+
+            Row* row = &rows[num_rows++];
+            snprintf(row->name, sizeof(row->name), "%s/%dp%dc", kinds[k].name, producers, consumers);
+            bench_result_t result;
+            bench_run(NULL, row->name, items, run_queue, &args, &result);
+            bench_report_result(&result);
+            row->median = result.median;
+            bench_result_free(&result);
+
+            // Check the last run and gather its latency samples
+            long consumed = 0, samples = 0;
+            for (int i = 0; i < consumers; i++) {
+                consumed += args.consumed[i];
+                for (long s = 0; s < args.num_latencies[i]; s++) {
+                    all_latencies[samples++] = args.latencies[i][s];
+                }
+            }
+            if (consumed != items) {
+                fprintf(msg, "%s: %ld items consumed, expected %ld\n", row->name, consumed, items);
+                errors++;
+            }
+            qsort(all_latencies, samples, sizeof(uint64_t), compare_u64);
+            row->p50 = samples ? all_latencies[samples / 2] : 0;
+            row->p99 = samples ? all_latencies[samples * 99 / 100] : 0;
+
+            kinds[k].destroy(args.queue);
+        }
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\n%-20s %12s %12s %12s %12s\n", "case", "median(s)", "Mitems/s", "p50(ns)", "p99(ns)");
+    for (int r = 0; r < num_rows; r++) {
+        fprintf(msg, "%-20s %12.6f %12.2f %12llu %12llu\n", rows[r].name, rows[r].median,
+                items / rows[r].median / 1e6, (unsigned long long)rows[r].p50,
+                (unsigned long long)rows[r].p99);
+    }
+    if (errors) fprintf(msg, "\n%d case(s) lost or duplicated items!\n", errors);
+
+    for (int c = 0; c < MAX_CONSUMERS; c++) free(args.latencies[c]);
+    free(all_latencies);
+    return errors || regressions ? 1 : 0;
+}
@@ -0,0 +1,232 @@
+// Loop schedule sweep over synthetic irregular workloads. Every cost profile of
+// include/workload.h is run with static, dynamic, guided, auto and
+// nonmonotonic:dynamic schedules and a range of chunk sizes, and the fastest
+// schedule per profile is reported together with its load imbalance.
+//
+// Usage: schedule_sweep [-n iterations] [-m mean_cost] [-c chunk,chunk,...] [-s seed] [profile...]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/loop_profile.h"
+#include "../include/workload.h"
+
+#define DEFAULT_ITERATIONS 100000
+#define DEFAULT_MEAN_COST 50.0
+#define MAX_CHUNKS 16
+
+typedef enum {
+    SCHED_STATIC = 0,
+    SCHED_DYNAMIC,          // monotonic:dynamic, the pre-OpenMP 5.0 behavior
+    SCHED_GUIDED,
+    SCHED_AUTO,
+    SCHED_NONMONOTONIC,     // nonmonotonic:dynamic, lets the runtime steal
+    NUM_SCHEDULES
+} Schedule;
+
+static const char* schedule_names[NUM_SCHEDULES] = {
+    "static", "dynamic", "guided", "auto", "nonmonotonic"
+};
+
+typedef struct {
+    const double* cost;
+    long n;
+    Schedule schedule;
+    int chunk;                // 0 uses the schedule's default chunk
+    double sum;
+    loop_profile_t* profile;  // NULL while timing
+} SweepArgs;
+
+typedef struct {
+    char name[BENCH_NAME_LEN];
+    double median;
+    double imbalance;
+    double idle_fraction;
+} SweepRow;
+
+// One worksharing loop over the costs; the schedule clause is the only difference
+#define SWEEP_LOOP(directive)                                   \
+    _Pragma("omp parallel reduction(+:sum)")                    \
+    {                                                           \
+        loop_profile_thread_begin(args->profile);               \
+        _Pragma(directive)                                      \
+        for (long i = 0; i < n; i++) {                          \
+            loop_profile_iteration(args->profile, i);           \
+            sum += workload_execute(cost[i]);                   \
+        }                                                       \
+        loop_profile_thread_end(args->profile);                 \
+    }
+
+void run_schedule(void* arg) {
+    SweepArgs* args = (SweepArgs*)arg;
+    const double* cost = args->cost;
+    const long n = args->n;
+    const int chunk = args->chunk;
+    double sum = 0.0;
+
+    switch (args->schedule) {
+        case SCHED_STATIC:
+            if (chunk > 0) {
+                SWEEP_LOOP("omp for schedule(static, chunk) nowait")
+            } else {
+                SWEEP_LOOP("omp for schedule(static) nowait")
+            }
+            break;
+        case SCHED_DYNAMIC:
+            SWEEP_LOOP("omp for schedule(monotonic: dynamic, chunk) nowait")
+            break;
+        case SCHED_GUIDED:
+            SWEEP_LOOP("omp for schedule(guided, chunk) nowait")
+            break;
+        case SCHED_AUTO:
+            SWEEP_LOOP("omp for schedule(auto) nowait")
+            break;
+        case SCHED_NONMONOTONIC:
+            SWEEP_LOOP("omp for schedule(nonmonotonic: dynamic, chunk) nowait")
+            break;
+        default:
+            break;
+    }
+
+    args->sum = sum;
+}
+
+// Parse "1,4,16" into chunks; returns the number of chunk sizes
+static int parse_chunks(const char* list, int* chunks) {
+    int count = 0;
+    char* copy = strdup(list);
+    for (char* tok = strtok(copy, ","); tok && count < MAX_CHUNKS; tok = strtok(NULL, ",")) {
+        int c = atoi(tok);
+        if (c > 0) chunks[count++] = c;
+    }
+    free(copy);
+    return count;
+}
+
+// Time one configuration, then profile one extra run for its load balance
+static void sweep_case(const char* profile_name, SweepArgs* args, SweepRow* row) {
+    bench_result_t result;
+    loop_profile_t profile;
+    loop_profile_summary_t summary;
+
+    if (args->chunk > 0) {
+        snprintf(row->name, sizeof(row->name), "%s/%s,%d", profile_name,
+                 schedule_names[args->schedule], args->chunk);
+    } else {
+        snprintf(row->name, sizeof(row->name), "%s/%s", profile_name, schedule_names[args->schedule]);
+    }
+
+    args->profile = NULL;
+    bench_run(NULL, row->name, args->n, run_schedule, args, &result);
+    bench_report_result(&result);
+    row->median = result.median;
+    bench_result_free(&result);
+
+    row->imbalance = row->idle_fraction = 0.0;
+    if (loop_profile_init(&profile, row->name) == 0) {
+        args->profile = &profile;
+        run_schedule(args);
+        loop_profile_summarize(&profile, &summary);
+        row->imbalance = summary.imbalance;
+        row->idle_fraction = summary.idle_fraction;
+        loop_profile_free(&profile);
+        args->profile = NULL;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    long n = bench_problem_size(DEFAULT_ITERATIONS, 1);
+    double mean_cost = DEFAULT_MEAN_COST;
+    unsigned long long seed = 42;
+    int chunks[MAX_CHUNKS] = { 1, 4, 16, 64, 256, 1024 };
+    int num_chunks = 6;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:m:c:s:")) != -1) {
+        switch (opt) {
+            case 'n': n = atol(optarg); break;
+            case 'm': mean_cost = atof(optarg); break;
+            case 'c': num_chunks = parse_chunks(optarg, chunks); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            default:
+                fprintf(stderr, "Usage: %s [-n iterations] [-m mean_cost] [-c chunk,chunk,...] "
+                                "[-s seed] [profile...]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    int profiles[WORKLOAD_NUM_PROFILES];
+    int num_profiles = 0;
+    for (int a = optind; a < argc && num_profiles < WORKLOAD_NUM_PROFILES; a++) {
+        int p = workload_profile_parse(argv[a]);
+        if (p < 0) {
+            fprintf(stderr, "Unknown profile '%s'\n", argv[a]);
+            return 1;
+        }
+        profiles[num_profiles++] = p;
+    }
+    if (num_profiles == 0) {
+        for (int p = 0; p < WORKLOAD_NUM_PROFILES; p++) profiles[num_profiles++] = p;
+    }
+
+    double* cost = (double*)malloc(n * sizeof(double));
+    // static without a chunk, every chunked schedule per chunk size, and auto
+    int rows_per_profile = 2 + (NUM_SCHEDULES - 2) * num_chunks;
+    SweepRow* rows = (SweepRow*)malloc(rows_per_profile * sizeof(SweepRow));
+    if (!cost || !rows) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+
+    bench_report_begin("schedule_sweep");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "Schedule sweep: %ld iterations, mean cost %.1f units, %d threads\n\n",
+            n, mean_cost, omp_get_max_threads());
+
+    for (int p = 0; p < num_profiles; p++) {
+        const char* profile_name = workload_profile_name(profiles[p]);
+        workload_generate(cost, n, profiles[p], mean_cost, seed);
+
+        int num_rows = 0;
+        SweepArgs args = { cost, n, SCHED_STATIC, 0, 0.0, NULL };
+        sweep_case(profile_name, &args, &rows[num_rows++]);
+
+        for (int s = 0; s < NUM_SCHEDULES; s++) {
+            if (s == SCHED_AUTO) {
+                args.schedule = SCHED_AUTO;
+                args.chunk = 0;
+                sweep_case(profile_name, &args, &rows[num_rows++]);
+                continue;
+            }
+            for (int c = 0; c < num_chunks; c++) {
+                args.schedule = s;
+                args.chunk = chunks[c];
+                sweep_case(profile_name, &args, &rows[num_rows++]);
+            }
+        }
+
+        // rows[0] is plain static, the baseline every schedule is compared to
+        int best = 0;
+        for (int r = 1; r < num_rows; r++) {
+            if (rows[r].median < rows[best].median) best = r;
+        }
+
+        fprintf(msg, "\n%-36s %12s %9s %10s %8s\n", "configuration", "median(s)", "vs static",
+                "imbalance", "idle(%)");
+        for (int r = 0; r < num_rows; r++) {
+            fprintf(msg, "%-36s %12.6f %8.2fx %10.3f %8.1f%s\n", rows[r].name, rows[r].median,
+                    rows[0].median / rows[r].median, rows[r].imbalance,
+                    rows[r].idle_fraction * 100.0, r == best ? "  <- best" : "");
+        }
+        fprintf(msg, "Best for %s: %s (%.2fx over static)\n", profile_name, rows[best].name,
+                rows[0].median / rows[best].median);
+    }
+
+    int regressions = bench_report_end();
+
+    free(rows);
+    free(cost);
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,268 @@
+// STREAM-style memory bandwidth benchmark and roofline report for the library kernels
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/parallel_algorithms.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define DEFAULT_SIZE 20000000   // 3 arrays x 160 MB, well beyond any LLC
+#define SCALAR 3.0
+#define PEAK_ACCUMULATORS 16    // Independent multiply-add chains per thread to hide latency
+#define PEAK_ITERATIONS 2000000
+
+typedef struct {
+    double* a;
+    double* b;
+    double* c;
+    long n;
+    double result;
+} StreamArgs;
+
+// Pages are placed on the NUMA node of the thread that touches them first, so
+// initialize with the same static schedule the kernels use
+static void first_touch_init(StreamArgs* s) {
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < s->n; i++) {
+        s->a[i] = 1.0;
+        s->b[i] = 2.0;
+        s->c[i] = 0.0;
+    }
+}
+
+void stream_copy(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    double *a = s->a, *c = s->c;
+    #pragma omp parallel for simd schedule(static)
+    for (long i = 0; i < s->n; i++) c[i] = a[i];
+}
+
+void stream_scale(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    double *b = s->b, *c = s->c;
+    #pragma omp parallel for simd schedule(static)
+    for (long i = 0; i < s->n; i++) b[i] = SCALAR * c[i];
+}
+
+void stream_add(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    double *a = s->a, *b = s->b, *c = s->c;
+    #pragma omp parallel for simd schedule(static)
+    for (long i = 0; i < s->n; i++) c[i] = a[i] + b[i];
+}
+
+void stream_triad(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    double *a = s->a, *b = s->b, *c = s->c;
+    #pragma omp parallel for simd schedule(static)
+    for (long i = 0; i < s->n; i++) a[i] = b[i] + SCALAR * c[i];
+}
+
+#ifdef __SSE2__
+// Non-temporal stores bypass the cache, saving the read-for-ownership of the destination.
+// Each thread gets an even-sized static block so every pair stays 16-byte aligned.
+#define NT_LOOP(dst, vexpr, sexpr)                                      \
+    _Pragma("omp parallel")                                             \
+    {                                                                   \
+        int nt = omp_get_num_threads(), t = omp_get_thread_num();       \
+        long block = (((s->n + nt - 1) / nt) + 1) & ~1L;                \
+        long lo = t * block, hi = lo + block < s->n ? lo + block : s->n; \
+        long i = lo;                                                    \
+        for (; i + 1 < hi; i += 2) _mm_stream_pd(&dst[i], (vexpr));     \
+        for (; i < hi; i++) dst[i] = (sexpr);                           \
+        _mm_sfence();                                                   \
+    }
+
+void stream_copy_nt(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    double *a = s->a, *c = s->c;
+    NT_LOOP(c, _mm_load_pd(&a[i]), a[i])
+}
+
+void stream_scale_nt(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    double *b = s->b, *c = s->c;
+    NT_LOOP(b, _mm_mul_pd(_mm_set1_pd(SCALAR), _mm_load_pd(&c[i])), SCALAR * c[i])
+}
+
+void stream_add_nt(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    double *a = s->a, *b = s->b, *c = s->c;
+    NT_LOOP(c, _mm_add_pd(_mm_load_pd(&a[i]), _mm_load_pd(&b[i])), a[i] + b[i])
+}
+
+void stream_triad_nt(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    double *a = s->a, *b = s->b, *c = s->c;
+    NT_LOOP(a, _mm_add_pd(_mm_load_pd(&b[i]), _mm_mul_pd(_mm_set1_pd(SCALAR), _mm_load_pd(&c[i]))),
+            b[i] + SCALAR * c[i])
+}
+#endif
+
+// Compute-bound kernel: independent multiply-add chains that fit in registers
+void peak_flops(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    double total = 0.0;
+
+    #pragma omp parallel reduction(+:total)
+    {
+        double acc[PEAK_ACCUMULATORS];
+        for (int k = 0; k < PEAK_ACCUMULATORS; k++) acc[k] = omp_get_thread_num() + k;
+
+        for (int it = 0; it < PEAK_ITERATIONS; it++) {
+            #pragma omp simd
+            for (int k = 0; k < PEAK_ACCUMULATORS; k++) acc[k] = acc[k] * 0.999999 + 1e-6;
+        }
+        for (int k = 0; k < PEAK_ACCUMULATORS; k++) total += acc[k];
+    }
+    s->result = total;
+}
+
+static double affine(double x) {
+    return 2.0 * x + 1.0;
+}
+
+void kernel_reduce_sum(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    s->result = parallel_reduce(s->a, (int)s->n, 0.0, 0);
+}
+
+void kernel_reduce_max(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    s->result = parallel_reduce(s->a, (int)s->n, -INFINITY, 2);
+}
+
+void kernel_transform(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    parallel_transform(s->a, s->c, (int)s->n, affine);
+}
+
+// parallel_sort works in place, so every run sorts a fresh copy of b;
+// the copy is included in the bytes counted for this kernel
+void kernel_sort(void* arg) {
+    StreamArgs* s = (StreamArgs*)arg;
+    double *b = s->b, *c = s->c;
+    #pragma omp parallel for simd schedule(static)
+    for (long i = 0; i < s->n; i++) c[i] = b[i];
+    parallel_sort(c, (int)s->n);
+}
+
+typedef struct {
+    const char* name;
+    bench_fn_t fn;
+    double flops_per_elem;
+    double bytes_per_elem;
+} Kernel;
+
+int main(int argc, char* argv[]) {
+    long n = bench_problem_size(argc > 1 ? atol(argv[1]) : DEFAULT_SIZE, 1);
+    StreamArgs s = { NULL, NULL, NULL, n, 0.0 };
+
+    s.a = (double*)aligned_alloc(64, ((n * sizeof(double) + 63) / 64) * 64);
+    s.b = (double*)aligned_alloc(64, ((n * sizeof(double) + 63) / 64) * 64);
+    s.c = (double*)aligned_alloc(64, ((n * sizeof(double) + 63) / 64) * 64);
+    if (!s.a || !s.b || !s.c) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+
+    first_touch_init(&s);
+
+    bench_report_begin("stream_roofline");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "STREAM: %ld doubles per array (%.1f MB each)\n\n", n, n * 8.0 / 1e6);
+
+    // Bytes per element count only the compulsory traffic, as STREAM does
+    Kernel stream[] = {
+        { "copy",     stream_copy,     0.0, 16.0 },
+        { "scale",    stream_scale,    1.0, 16.0 },
+        { "add",      stream_add,      1.0, 24.0 },
+        { "triad",    stream_triad,    2.0, 24.0 },
+#ifdef __SSE2__
+        { "copy_nt",  stream_copy_nt,  0.0, 16.0 },
+        { "scale_nt", stream_scale_nt, 1.0, 16.0 },
+        { "add_nt",   stream_add_nt,   1.0, 24.0 },
+        { "triad_nt", stream_triad_nt, 2.0, 24.0 },
+#endif
+    };
+    int num_stream = sizeof(stream) / sizeof(stream[0]);
+    double stream_gbs[sizeof(stream) / sizeof(stream[0])];
+    double peak_bw = 0.0;
+
+    for (int k = 0; k < num_stream; k++) {
+        bench_result_t r;
+        bench_run(NULL, stream[k].name, n, stream[k].fn, &s, &r);
+        bench_report_result(&r);
+        stream_gbs[k] = stream[k].bytes_per_elem * n / r.min / 1e9;
+        if (stream_gbs[k] > peak_bw) peak_bw = stream_gbs[k];
+        bench_result_free(&r);
+    }
+
+    bench_result_t r;
+    bench_run(NULL, "peak_flops", 0, peak_flops, &s, &r);
+    bench_report_result(&r);
+    double peak_gflops = 2.0 * PEAK_ACCUMULATORS * (double)PEAK_ITERATIONS * r.threads / r.min / 1e9;
+    bench_result_free(&r);
+
+    // Library kernels: reduce reads 8 B and does 1 op per element, transform
+    // reads and writes 8 B each and does 2 flops, sort's merge passes do no
+    // arithmetic but stream 16 B per element per level
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < n; i++) s.b[i] = (double)((i * 2654435761UL) % 1000003);
+
+    double sort_levels = n > 1000 ? ceil(log2((double)n / 1000.0)) + 1.0 : 1.0;
+    Kernel library[] = {
+        { "parallel_reduce(sum)", kernel_reduce_sum, 1.0,  8.0 },
+        { "parallel_reduce(max)", kernel_reduce_max, 1.0,  8.0 },
+        { "parallel_transform",   kernel_transform,  2.0, 16.0 },
+        { "parallel_sort",        kernel_sort,       0.0, 16.0 + 16.0 * sort_levels },
+    };
+    int num_library = sizeof(library) / sizeof(library[0]);
+    double library_time[sizeof(library) / sizeof(library[0])];
+
+    for (int k = 0; k < num_library; k++) {
+        bench_result_t lr;
+        bench_run(NULL, library[k].name, n, library[k].fn, &s, &lr);
+        bench_report_result(&lr);
+        library_time[k] = lr.median;
+        bench_result_free(&lr);
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\nSTREAM bandwidth (best run):\n");
+    for (int k = 0; k < num_stream; k++) {
+        fprintf(msg, "  %-10s %8.2f GB/s\n", stream[k].name, stream_gbs[k]);
+    }
+
+    fprintf(msg, "\nRoofline: peak bandwidth %.2f GB/s, peak compute %.2f GFLOP/s, ridge at %.3f FLOP/B\n",
+            peak_bw, peak_gflops, peak_gflops / peak_bw);
+    fprintf(msg, "%-22s %8s %10s %8s %12s %8s  %s\n",
+            "kernel", "FLOP/B", "GFLOP/s", "GB/s", "attainable", "% roof", "bound");
+
+    for (int k = 0; k < num_library; k++) {
+        double intensity = library[k].flops_per_elem / library[k].bytes_per_elem;
+        double gflops = library[k].flops_per_elem * n / library_time[k] / 1e9;
+        double gbs = library[k].bytes_per_elem * n / library_time[k] / 1e9;
+        double mem_roof = intensity * peak_bw;
+        int memory_bound = mem_roof < peak_gflops;
+
+        // Kernels without arithmetic are judged against the bandwidth roof only
+        double attainable = intensity > 0.0 ? (memory_bound ? mem_roof : peak_gflops) : peak_bw;
+        double achieved = intensity > 0.0 ? gflops : gbs;
+
+        fprintf(msg, "%-22s %8.3f %10.3f %8.2f %9.2f %s %7.1f%%  %s\n",
+                library[k].name, intensity, gflops, gbs, attainable,
+                intensity > 0.0 ? "GF" : "GB", 100.0 * achieved / attainable,
+                memory_bound ? "memory" : "compute");
+    }
+
+    free(s.a);
+    free(s.b);
+    free(s.c);
+    return regressions ? 1 : 0;
+}
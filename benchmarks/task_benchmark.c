@@ -2,11 +2,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <omp.h>
-#include <unistd.h>  // for sleep function
 #include <string.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <aio.h>
+#include <sys/stat.h>
+#include "../include/bench_harness.h"
+#include "../include/workload.h"
+#include "../include/async_io.h"
+
+#define NUM_FILES 16   // Divisible by every default thread count
+#define NUM_STAGES 4   // Busy stages per file (read, process, report, output)
 
 // Original implementation with nested parallel region and tasks
-double process_file_original(const char* filename) {
+double process_file_original(const char* filename, double stage_time) {
     double start = omp_get_wtime();
     int file_id = 0;
     sscanf(filename, "file_%d.dat", &file_id);
@@ -31,7 +42,7 @@ double process_file_original(const char* filename) {
                     parsed_data[i] = i % 10;
                 }
                 
-                usleep(100000);  // 0.1 second I/O time
+                workload_spin(stage_time);  // Simulated I/O time
             }
             
             // Stage 2: Process data task (depends on read task)
@@ -44,7 +55,7 @@ double process_file_original(const char* filename) {
                     processed_data[i] = parsed_data[i] * 2;
                 }
                 
-                usleep(100000);  // 0.1 second processing time
+                workload_spin(stage_time);  // Simulated processing time
             }
             
             // Stage 3: Generate report (depends on processing task)
@@ -59,14 +70,14 @@ double process_file_original(const char* filename) {
                 report = (char*)malloc(100);
                 sprintf(report, "File %s: %d items, sum=%d", filename, data_size, sum);
                 
-                usleep(100000);  // 0.1 second report generation time
+                workload_spin(stage_time);  // Simulated report generation time
             }
             
             // Stage 4: Output results (depends on report task)
             #pragma omp task depend(in:report)
             {
                 // Simulate saving to disk
-                usleep(100000);  // 0.1 second I/O time
+                workload_spin(stage_time);  // Simulated I/O time
             }
         }
     }
@@ -81,7 +92,7 @@ double process_file_original(const char* filename) {
 }
 
 // Implementation with tasks but no nested parallel region
-double process_file_tasks_no_nested(const char* filename) {
+double process_file_tasks_no_nested(const char* filename, double stage_time) {
     double start = omp_get_wtime();
     int file_id = 0;
     sscanf(filename, "file_%d.dat", &file_id);
@@ -102,7 +113,7 @@ double process_file_tasks_no_nested(const char* filename) {
             parsed_data[i] = i % 10;
         }
         
-        usleep(100000);  // 0.1 second I/O time
+        workload_spin(stage_time);  // Simulated I/O time
     }
     
     // Stage 2: Process data task (depends on read task)
@@ -115,7 +126,7 @@ double process_file_tasks_no_nested(const char* filename) {
             processed_data[i] = parsed_data[i] * 2;
         }
         
-        usleep(100000);  // 0.1 second processing time
+        workload_spin(stage_time);  // Simulated processing time
     }
     
     // Stage 3: Generate report (depends on processing task)
@@ -130,14 +141,14 @@ double process_file_tasks_no_nested(const char* filename) {
         report = (char*)malloc(100);
         sprintf(report, "File %s: %d items, sum=%d", filename, data_size, sum);
         
-        usleep(100000);  // 0.1 second report generation time
+        workload_spin(stage_time);  // Simulated report generation time
     }
     
     // Stage 4: Output results (depends on report task)
     #pragma omp task depend(in:report)
     {
         // Simulate saving to disk
-        usleep(100000);  // 0.1 second I/O time
+        workload_spin(stage_time);  // Simulated I/O time
     }
     
     // Wait for tasks to complete before cleanup
@@ -153,7 +164,7 @@ double process_file_tasks_no_nested(const char* filename) {
 }
 
 // Sequential implementation with no tasks
-double process_file_sequential(const char* filename) {
+double process_file_sequential(const char* filename, double stage_time) {
     double start = omp_get_wtime();
     int file_id = 0;
     sscanf(filename, "file_%d.dat", &file_id);
@@ -166,7 +177,7 @@ double process_file_sequential(const char* filename) {
         parsed_data[i] = i % 10;
     }
     
-    usleep(100000);  // 0.1 second I/O time
+    workload_spin(stage_time);  // Simulated I/O time
     
     // Stage 2: Process data
     int* processed_data = (int*)malloc(data_size * sizeof(int));
@@ -175,7 +186,7 @@ double process_file_sequential(const char* filename) {
         processed_data[i] = parsed_data[i] * 2;
     }
     
-    usleep(100000);  // 0.1 second processing time
+    workload_spin(stage_time);  // Simulated processing time
     
     // Stage 3: Generate report
     int sum = 0;
@@ -186,10 +197,10 @@ double process_file_sequential(const char* filename) {
     char* report = (char*)malloc(100);
     sprintf(report, "File %s: %d items, sum=%d", filename, data_size, sum);
     
-    usleep(100000);  // 0.1 second report generation time
+    workload_spin(stage_time);  // Simulated report generation time
     
     // Stage 4: Output results
-    usleep(100000);  // 0.1 second I/O time
+    workload_spin(stage_time);  // Simulated I/O time
     
     // Clean up
     free(parsed_data);
@@ -200,44 +211,489 @@ double process_file_sequential(const char* filename) {
     return end - start;
 }
 
-typedef double (*ProcessFileFunc)(const char*);
+typedef double (*ProcessFileFunc)(const char*, double);
+
+typedef struct {
+    ProcessFileFunc func;
+    const char** files;
+    int num_files;
+    double stage_time;
+} BenchmarkArgs;
 
 // Run benchmark with the specified implementation
-double run_benchmark(ProcessFileFunc func, const char* files[], int num_files, int num_threads) {
-    double start = omp_get_wtime();
-    
-    omp_set_num_threads(num_threads);
+void run_benchmark(void* arg) {
+    BenchmarkArgs* args = (BenchmarkArgs*)arg;
     
     #pragma omp parallel
     {
         #pragma omp single
         {
-            for (int i = 0; i < num_files; i++) {
+            for (int i = 0; i < args->num_files; i++) {
                 #pragma omp task
-                func(files[i]);
+                args->func(args->files[i], args->stage_time);
             }
         }
     }
-    
-    double end = omp_get_wtime();
-    return end - start;
 }
 
-int main() {
-    const char* files[] = {"file_1.dat", "file_2.dat", "file_3.dat", 
-                          "file_4.dat", "file_5.dat", "file_6.dat"};
-    int num_files = 6;
+// ---- Real file pipeline: pread -> parse -> compute -> write ----
+
+#define IO_FILE_SIZE (4L << 20)  // Bytes per generated input file (BENCH_SIZE overrides)
+#define IO_CHUNK (1L << 20)      // Largest single pread/pwrite
+
+#define IO_DEPTH 16               // Requests in flight for the async_io engines
+
+typedef enum { IO_BLOCKING = 0, IO_THREAD, IO_DETACHED, IO_URING, IO_THREAD_POOL, IO_NUM_STRATEGIES } IoStrategy;
+
+static const char* io_strategy_names[IO_NUM_STRATEGIES] = {
+    "File I/O (Blocking Tasks)",
+    "File I/O (Dedicated I/O Thread)",
+    "File I/O (Detached AIO Tasks)",
+    "File I/O (Detached io_uring)",
+    "File I/O (Detached I/O Pool)"
+};
+
+typedef struct {
+    char in_path[288];
+    char out_path[288];
+    size_t size;                 // Input bytes
+    char* text;                  // Raw input
+    long* values;                // Parsed input
+    long count;
+    char* output;                // Formatted results
+    size_t output_len;
+    long checksum;               // Sum of the computed values
+    int error;
+    atomic_int ready;            // Computed, waiting for the I/O thread to write it
+    int fd;                      // Open file of an asynchronous request
+    size_t done;                 // Bytes transferred so far by that request
+    struct aiocb cb;
+    omp_event_handle_t event;    // Fulfilled when the request completes
+    ssize_t io_result;           // Outcome of an async_io request
+} PipelineFile;
+
+typedef struct {
+    PipelineFile* files;
+    int num_files;
+    IoStrategy strategy;
+    async_io_t* io;              // Engine of the IO_URING and IO_THREAD_POOL strategies
+} PipelineArgs;
+
+static int pread_full(int fd, char* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        size_t n = len - done < IO_CHUNK ? len - done : IO_CHUNK;
+        ssize_t r = pread(fd, buf + done, n, (off_t)done);
+        if (r <= 0) return -1;
+        done += r;
+    }
+    return 0;
+}
+
+static int pwrite_full(int fd, const char* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        size_t n = len - done < IO_CHUNK ? len - done : IO_CHUNK;
+        ssize_t w = pwrite(fd, buf + done, n, (off_t)done);
+        if (w <= 0) return -1;
+        done += w;
+    }
+    return 0;
+}
+
+// Input: one decimal number per line, written once per run of the program
+static int generate_input(const char* path, size_t size, unsigned seed) {
+    FILE* out = fopen(path, "w");
+    if (!out) return -1;
+    size_t written = 0;
+    unsigned long long x = seed;
+    while (written < size) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        written += fprintf(out, "%llu\n", (x >> 33) % 1000000000ULL);
+    }
+    return fclose(out);
+}
+
+static void stage_read(PipelineFile* f) {
+    f->text = (char*)malloc(f->size + 1);
+    int fd = open(f->in_path, O_RDONLY);
+    if (!f->text || fd < 0 || pread_full(fd, f->text, f->size) != 0) f->error = 1;
+    if (fd >= 0) close(fd);
+}
+
+static void stage_parse(PipelineFile* f) {
+    if (f->error) return;
+    f->text[f->size] = '\0';
+    f->values = (long*)malloc((f->size / 2 + 1) * sizeof(long));
+    if (!f->values) {
+        f->error = 1;
+        return;
+    }
+
+    long count = 0;
+    const char* p = f->text;
+    const char* end = f->text + f->size;
+    while (p < end) {
+        long v = 0;
+        while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+        f->values[count++] = v;
+        while (p < end && (*p < '0' || *p > '9')) p++;
+    }
+    f->count = count;
+}
+
+// Scramble every value and format the results, one per line
+static void stage_compute(PipelineFile* f) {
+    if (f->error) return;
+    f->output = (char*)malloc(f->count * 12 + 1);
+    if (!f->output) {
+        f->error = 1;
+        return;
+    }
+
+    char* out = f->output;
+    long checksum = 0;
+    for (long i = 0; i < f->count; i++) {
+        long v = (long)(((unsigned long long)f->values[i] * 2654435761ULL) % 1000003ULL);
+        checksum += v;
+
+        char digits[12];
+        int n = 0;
+        do {
+            digits[n++] = (char)('0' + v % 10);
+            v /= 10;
+        } while (v);
+        while (n) *out++ = digits[--n];
+        *out++ = '\n';
+    }
+    f->output_len = out - f->output;
+    f->checksum = checksum;
+}
+
+static void stage_write(PipelineFile* f) {
+    if (f->error) return;
+    int fd = open(f->out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || pwrite_full(fd, f->output, f->output_len) != 0) f->error = 1;
+    if (fd >= 0) close(fd);
+}
+
+static void pipeline_reset(PipelineFile* files, int num_files) {
+    for (int i = 0; i < num_files; i++) {
+        free(files[i].text);
+        free(files[i].values);
+        free(files[i].output);
+        files[i].text = NULL;
+        files[i].values = NULL;
+        files[i].output = NULL;
+        files[i].error = 0;
+        files[i].checksum = 0;
+        atomic_store(&files[i].ready, 0);
+    }
+}
+
+// Blocking pread/pwrite inside the stage tasks, chained with depend()
+static void pipeline_blocking(PipelineFile* files, int num_files) {
+    #pragma omp parallel
+    #pragma omp single
+    {
+        for (int i = 0; i < num_files; i++) {
+            PipelineFile* f = &files[i];
+
+            #pragma omp task depend(out: f->text)
+            stage_read(f);
+
+            #pragma omp task depend(in: f->text) depend(out: f->output)
+            {
+                stage_parse(f);
+                stage_compute(f);
+            }
+
+            #pragma omp task depend(in: f->output)
+            stage_write(f);
+        }
+    }
+}
+
+// Write every computed file from next_write on, in order; returns the new next_write
+static int write_ready(PipelineFile* files, int num_files, int next_write) {
+    while (next_write < num_files && atomic_load_explicit(&files[next_write].ready, memory_order_acquire)) {
+        stage_write(&files[next_write++]);
+    }
+    return next_write;
+}
+
+// One thread does all reads and writes, the others parse and compute
+static void pipeline_io_thread(PipelineFile* files, int num_files) {
+    #pragma omp parallel
+    #pragma omp single
+    {
+        // Alone, the I/O thread has to compute too: run the tasks undeferred
+        int helpers = omp_get_num_threads() > 1;
+        int next_write = 0;
+
+        for (int i = 0; i < num_files; i++) {
+            PipelineFile* f = &files[i];
+            stage_read(f);
+
+            #pragma omp task if(helpers)
+            {
+                stage_parse(f);
+                stage_compute(f);
+                atomic_store_explicit(&f->ready, 1, memory_order_release);
+            }
+
+            next_write = write_ready(files, num_files, next_write);
+        }
+
+        while (next_write < num_files) {
+            int before = next_write;
+            next_write = write_ready(files, num_files, next_write);
+            if (next_write == before) sched_yield();
+        }
+    }
+}
+
+// Submit the next piece of an asynchronous transfer of f->cb
+static int aio_submit(PipelineFile* f, int write, void (*complete)(union sigval)) {
+    memset(&f->cb, 0, sizeof(f->cb));
+    size_t len = write ? f->output_len : f->size;
+    size_t n = len - f->done < IO_CHUNK ? len - f->done : IO_CHUNK;
+    f->cb.aio_fildes = f->fd;
+    f->cb.aio_buf = (write ? f->output : f->text) + f->done;
+    f->cb.aio_nbytes = n;
+    f->cb.aio_offset = (off_t)f->done;
+    f->cb.aio_sigevent.sigev_notify = SIGEV_THREAD;
+    f->cb.aio_sigevent.sigev_notify_function = complete;
+    f->cb.aio_sigevent.sigev_value.sival_ptr = f;
+    return write ? aio_write(&f->cb) : aio_read(&f->cb);
+}
+
+// Completion callback (glibc AIO thread): continue the transfer or fulfill the task's event
+static void aio_complete(PipelineFile* f, int write, void (*complete)(union sigval)) {
+    ssize_t n = aio_return(&f->cb);
+    size_t len = write ? f->output_len : f->size;
+
+    if (n <= 0) {
+        f->error = 1;
+    } else {
+        f->done += n;
+        if (f->done < len && aio_submit(f, write, complete) == 0) return;
+        if (f->done < len) f->error = 1;
+    }
+    close(f->fd);
+    omp_fulfill_event(f->event);
+}
+
+static void read_complete(union sigval value) {
+    aio_complete((PipelineFile*)value.sival_ptr, 0, read_complete);
+}
+
+static void write_complete(union sigval value) {
+    aio_complete((PipelineFile*)value.sival_ptr, 1, write_complete);
+}
+
+// Start an asynchronous transfer; on failure the event is fulfilled right away
+static void aio_start(PipelineFile* f, int write, omp_event_handle_t event) {
+    f->event = event;
+    f->done = 0;
+    if (write && f->error) {
+        omp_fulfill_event(event);
+        return;
+    }
+
+    f->fd = write ? open(f->out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644) : open(f->in_path, O_RDONLY);
+    if (!write) f->text = (char*)malloc(f->size + 1);
+    if (f->fd < 0 || (!write && !f->text) || aio_submit(f, write, write ? write_complete : read_complete) != 0) {
+        f->error = 1;
+        if (f->fd >= 0) close(f->fd);
+        omp_fulfill_event(event);
+    }
+}
+
+// Reads and writes are detached tasks completed by POSIX AIO: a thread that
+// starts a transfer moves on to other tasks instead of blocking in the kernel
+static void pipeline_detached(PipelineFile* files, int num_files) {
+    #pragma omp parallel
+    #pragma omp single
+    {
+        for (int i = 0; i < num_files; i++) {
+            PipelineFile* f = &files[i];
+            omp_event_handle_t read_done, write_done;
+
+            #pragma omp task detach(read_done) depend(out: f->text)
+            aio_start(f, 0, read_done);
+
+            #pragma omp task depend(in: f->text) depend(out: f->output)
+            {
+                stage_parse(f);
+                stage_compute(f);
+            }
+
+            #pragma omp task detach(write_done) depend(in: f->output)
+            aio_start(f, 1, write_done);
+        }
+
+        // Wait here rather than in the barrier: with a single thread, libgomp
+        // can miss the last omp_fulfill_event() while sleeping in the barrier
+        #pragma omp taskwait
+    }
+}
+
+// Submit a read or write of f to the engine; on failure the event is fulfilled right away
+static void async_start(PipelineFile* f, async_io_t* io, int write, omp_event_handle_t event) {
+    f->io_result = -1;
+    f->fd = -1;
+    if (write && f->error) {
+        omp_fulfill_event(event);
+        return;
+    }
+
+    if (write) {
+        f->fd = open(f->out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    } else {
+        f->fd = open(f->in_path, O_RDONLY);
+        f->text = (char*)malloc(f->size + 1);
+    }
+    if (f->fd < 0 || (!write && !f->text)) {
+        f->error = 1;
+        omp_fulfill_event(event);
+        return;
+    }
+    if (write) {
+        async_io_write(io, f->fd, f->output, f->output_len, 0, &f->io_result, event);
+    } else {
+        async_io_read(io, f->fd, f->text, f->size, 0, &f->io_result, event);
+    }
+}
+
+// Close the file of a completed request and check that it moved every byte
+static void async_finish(PipelineFile* f, int write) {
+    if (f->fd >= 0) close(f->fd);
+    f->fd = -1;
+    if (f->io_result != (ssize_t)(write ? f->output_len : f->size)) f->error = 1;
+}
+
+// Same graph as pipeline_detached(), with the transfers going through
+// include/async_io.h (io_uring, or a pool of blocking I/O threads)
+static void pipeline_async(PipelineFile* files, int num_files, async_io_t* io) {
+    #pragma omp parallel
+    #pragma omp single
+    {
+        for (int i = 0; i < num_files; i++) {
+            PipelineFile* f = &files[i];
+            omp_event_handle_t read_done, write_done;
+
+            #pragma omp task detach(read_done) depend(out: f->text)
+            async_start(f, io, 0, read_done);
+
+            #pragma omp task depend(in: f->text) depend(out: f->output)
+            {
+                async_finish(f, 0);
+                stage_parse(f);
+                stage_compute(f);
+            }
+
+            #pragma omp task detach(write_done) depend(in: f->output)
+            async_start(f, io, 1, write_done);
+        }
+        #pragma omp taskwait
+    }
+    for (int i = 0; i < num_files; i++) {
+        if (!files[i].error) async_finish(&files[i], 1);
+    }
+}
+
+void run_pipeline(void* arg) {
+    PipelineArgs* args = (PipelineArgs*)arg;
+    pipeline_reset(args->files, args->num_files);
+
+    switch (args->strategy) {
+        case IO_THREAD: pipeline_io_thread(args->files, args->num_files); break;
+        case IO_DETACHED: pipeline_detached(args->files, args->num_files); break;
+        case IO_URING:
+        case IO_THREAD_POOL: pipeline_async(args->files, args->num_files, args->io); break;
+        default: pipeline_blocking(args->files, args->num_files); break;
+    }
+}
+
+// Generate the inputs in a fresh directory under BENCH_TMPDIR (default /tmp)
+static PipelineFile* pipeline_create(char* dir, size_t dir_len, int num_files, size_t size) {
+    const char* base = getenv("BENCH_TMPDIR");
+    snprintf(dir, dir_len, "%s/task_benchmark.XXXXXX", base && *base ? base : "/tmp");
+    if (!mkdtemp(dir)) return NULL;
+
+    PipelineFile* files = (PipelineFile*)calloc(num_files, sizeof(PipelineFile));
+    if (!files) {
+        rmdir(dir);
+        return NULL;
+    }
+    for (int i = 0; i < num_files; i++) {
+        PipelineFile* f = &files[i];
+        struct stat st;
+        snprintf(f->in_path, sizeof(f->in_path), "%s/file_%d.dat", dir, i + 1);
+        snprintf(f->out_path, sizeof(f->out_path), "%s/file_%d.out", dir, i + 1);
+        if (generate_input(f->in_path, size, i + 1) != 0 || stat(f->in_path, &st) != 0) {
+            // Inputs generated so far, including a partial one
+            for (int j = 0; j <= i; j++) unlink(files[j].in_path);
+            free(files);
+            rmdir(dir);
+            return NULL;
+        }
+        f->size = (size_t)st.st_size;
+        atomic_init(&f->ready, 0);
+    }
+    return files;
+}
+
+static void pipeline_destroy(const char* dir, PipelineFile* files, int num_files) {
+    if (files) {
+        pipeline_reset(files, num_files);
+        for (int i = 0; i < num_files; i++) {
+            unlink(files[i].in_path);
+            unlink(files[i].out_path);
+        }
+        free(files);
+    }
+    rmdir(dir);
+}
+
+// Parse "1,10,100" into stage times in microseconds
+static int parse_granularities(const char* list, double* out, int max) {
+    int n = 0;
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", list);
+    for (char* tok = strtok(buf, ","); tok && n < max; tok = strtok(NULL, ",")) {
+        double us = atof(tok);
+        if (us > 0.0) out[n++] = us;
+    }
+    return n;
+}
+
+int main(int argc, char* argv[]) {
+    // Busy time of every pipeline stage, 1 us .. 10 ms by default
+    double granularities[16] = {1, 10, 100, 1000, 10000};
+    int num_granularities = 5;
+    if (argc > 1) num_granularities = parse_granularities(argv[1], granularities, 16);
+    if (num_granularities == 0) {
+        fprintf(stderr, "Usage: %s [stage_us,stage_us,...]\n", argv[0]);
+        return 1;
+    }
+
+    char names[NUM_FILES][32];
+    const char* files[NUM_FILES];
+    for (int i = 0; i < NUM_FILES; i++) {
+        snprintf(names[i], sizeof(names[i]), "file_%d.dat", i + 1);
+        files[i] = names[i];
+    }
+    int num_files = NUM_FILES;
     
     // Define thread counts to test
     int thread_counts[] = {1, 2, 4, 8};
     int num_thread_counts = 4;
     
-    int num_runs = 3;  // Number of benchmark runs
-    
-    printf("Task Implementation Benchmark Results\n");
-    printf("=====================================\n\n");
-    
-    printf("Implementation,Threads,Files,Time(s)\n");
+    bench_report_begin("task_benchmark");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "Busy-work calibrated at %.1f M units/s\n\n", workload_calibrate() / 1e6);
     
     // Test each implementation
     ProcessFileFunc implementations[] = {
@@ -252,60 +708,183 @@ int main() {
         "Sequential Processing"
     };
     
+    double medians[3][16][4];
+    char name[BENCH_NAME_LEN];
+    
     // For each implementation
     for (int impl = 0; impl < 3; impl++) {
-        // For each thread count
-        for (int t = 0; t < num_thread_counts; t++) {
-            int threads = thread_counts[t];
-            double total_time = 0;
+        for (int g = 0; g < num_granularities; g++) {
+            BenchmarkArgs args = { implementations[impl], files, num_files, granularities[g] * 1e-6 };
+            snprintf(name, sizeof(name), "%s/%gus", implementation_names[impl], granularities[g]);
             
-            // Run multiple times and take average
-            for (int run = 0; run < num_runs; run++) {
-                double time = run_benchmark(implementations[impl], files, num_files, threads);
-                total_time += time;
+            // For each thread count
+            for (int t = 0; t < num_thread_counts; t++) {
+                bench_result_t result;
+                
+                omp_set_num_threads(thread_counts[t]);
+                bench_run(NULL, name, num_files * NUM_STAGES, run_benchmark, &args, &result);
+                bench_report_result(&result);
+                medians[impl][g][t] = result.median;
+                bench_result_free(&result);
             }
+        }
+    }
+    
+    // Real file pipeline over generated inputs
+    const size_t file_size = (size_t)bench_problem_size(IO_FILE_SIZE, 1);
+    char dir[256];
+    PipelineFile* pipeline = pipeline_create(dir, sizeof(dir), num_files, file_size);
+    if (!pipeline) {
+        fprintf(stderr, "Could not create the pipeline input files in %s\n", dir);
+        return 1;
+    }
+    
+    // Reference checksums from a sequential pass
+    long expected[NUM_FILES];
+    double input_bytes = 0.0;
+    for (int i = 0; i < num_files; i++) {
+        stage_read(&pipeline[i]);
+        stage_parse(&pipeline[i]);
+        stage_compute(&pipeline[i]);
+        expected[i] = pipeline[i].checksum;
+        input_bytes += pipeline[i].size;
+    }
+    fprintf(msg, "Pipeline: %d files of %.1f MB in %s\n", num_files, file_size / 1e6, dir);
+    
+    // Without io_uring (old kernel, seccomp) its strategy is skipped
+    async_io_t* engines[IO_NUM_STRATEGIES] = { NULL };
+    engines[IO_URING] = async_io_create(ASYNC_IO_URING, IO_DEPTH);
+    engines[IO_THREAD_POOL] = async_io_create(ASYNC_IO_THREADS, IO_DEPTH);
+    if (!engines[IO_URING]) fprintf(msg, "io_uring is not available, skipping %s\n", io_strategy_names[IO_URING]);
+    
+    double io_medians[IO_NUM_STRATEGIES][4] = { { 0.0 } };
+    int errors = 0;
+    for (int s = 0; s < IO_NUM_STRATEGIES; s++) {
+        PipelineArgs args = { pipeline, num_files, s, engines[s] };
+        if ((s == IO_URING || s == IO_THREAD_POOL) && !engines[s]) continue;
+        
+        for (int t = 0; t < num_thread_counts; t++) {
+            bench_result_t result;
             
-            double avg_time = total_time / num_runs;
+            omp_set_num_threads(thread_counts[t]);
+            bench_run(NULL, io_strategy_names[s], (long)input_bytes, run_pipeline, &args, &result);
+            bench_report_result(&result);
+            io_medians[s][t] = result.median;
+            bench_result_free(&result);
             
-            printf("%s,%d,%d,%f\n", 
-                   implementation_names[impl], threads, num_files, avg_time);
+            // Check the last run: checksums and the size of every output file
+            for (int i = 0; i < num_files; i++) {
+                struct stat st;
+                if (pipeline[i].error || pipeline[i].checksum != expected[i] ||
+                    stat(pipeline[i].out_path, &st) != 0 || (size_t)st.st_size != pipeline[i].output_len) {
+                    fprintf(msg, "%s: wrong output for %s\n", io_strategy_names[s], pipeline[i].in_path);
+                    errors++;
+                }
+            }
         }
-        printf("\n");
     }
+    pipeline_destroy(dir, pipeline, num_files);
+    async_io_destroy(engines[IO_URING]);
+    async_io_destroy(engines[IO_THREAD_POOL]);
     
-    return 0;
+    int regressions = bench_report_end();
+    
+    // Efficiency: busy-work time over thread-seconds spent, 1.0 means no overhead
+    for (int impl = 0; impl < 3; impl++) {
+        fprintf(msg, "\nParallel efficiency, %s\n%12s", implementation_names[impl], "stage");
+        for (int t = 0; t < num_thread_counts; t++) fprintf(msg, " %7d thr", thread_counts[t]);
+        fprintf(msg, "\n");
+        for (int g = 0; g < num_granularities; g++) {
+            double work = num_files * NUM_STAGES * granularities[g] * 1e-6;
+            fprintf(msg, "%10gus", granularities[g]);
+            for (int t = 0; t < num_thread_counts; t++) {
+                fprintf(msg, " %11.3f", work / (thread_counts[t] * medians[impl][g][t]));
+            }
+            fprintf(msg, "\n");
+        }
+    }
+    
+    // Smallest stage time that reaches 80% efficiency
+    fprintf(msg, "\nMinimum stage time for 80%% efficiency\n%-28s", "implementation");
+    for (int t = 0; t < num_thread_counts; t++) fprintf(msg, " %7d thr", thread_counts[t]);
+    fprintf(msg, "\n");
+    for (int impl = 0; impl < 3; impl++) {
+        fprintf(msg, "%-28s", implementation_names[impl]);
+        for (int t = 0; t < num_thread_counts; t++) {
+            double smallest = 0.0;
+            for (int g = 0; g < num_granularities; g++) {
+                double work = num_files * NUM_STAGES * granularities[g] * 1e-6;
+                if (work / (thread_counts[t] * medians[impl][g][t]) >= 0.8 &&
+                    (smallest == 0.0 || granularities[g] < smallest)) {
+                    smallest = granularities[g];
+                }
+            }
+            if (smallest > 0.0) {
+                fprintf(msg, " %9gus", smallest);
+            } else {
+                fprintf(msg, " %11s", "never");
+            }
+        }
+        fprintf(msg, "\n");
+    }
+    
+    // Input throughput of the file pipeline and speedup over one thread
+    fprintf(msg, "\nFile pipeline throughput (MB/s of input) and speedup\n%-32s", "strategy");
+    for (int t = 0; t < num_thread_counts; t++) fprintf(msg, " %7d thr", thread_counts[t]);
+    fprintf(msg, "\n");
+    for (int s = 0; s < IO_NUM_STRATEGIES; s++) {
+        if (io_medians[s][0] == 0.0) continue;
+        fprintf(msg, "%-32s", io_strategy_names[s]);
+        for (int t = 0; t < num_thread_counts; t++) {
+            fprintf(msg, " %5.0f %4.2fx", input_bytes / io_medians[s][t] / 1e6, io_medians[s][0] / io_medians[s][t]);
+        }
+        fprintf(msg, "\n");
+    }
+    if (errors) fprintf(msg, "\n%d pipeline run(s) produced wrong output!\n", errors);
+    
+    return errors || regressions ? 1 : 0;
 }
 
 /*
 Benchmark Results Analysis
-The benchmark compares three implementation strategies:
-
-Original with Nested Tasks: Using a nested parallel region inside process_file
-Tasks without Nested Parallel: Using tasks but without creating a nested parallel region
-Sequential Processing: Processing each file sequentially without using tasks
-Performance Results
-Here's what the benchmark revealed:
-
-Implementation	                1 Thread	2 Threads	4 Threads	8 Threads
-Original (Nested Tasks)	        2.40s	    1.20s	    0.80s	    0.40s
-Tasks (No Nested)	            2.40s	    1.20s	    0.80s	    0.41s
-Sequential Processing	        2.40s	    1.20s	    0.80s	    0.40s
-
-Key Observations
-All implementations scale similarly: All three implementations show nearly identical performance and scaling patterns across different thread counts.
-
-Perfect scaling: We see almost perfect linear scaling as we increase threads. With 2 threads, time is halved; with 4 threads, it's quartered; with 8 threads, it's reduced to about 1/6 of the single-thread time.
-
-No overhead difference: Surprisingly, we don't see measurable overhead from nested parallelism or task creation. This suggests that for this workload, the execution time is dominated by the simulated work (sleeps) rather than OpenMP overhead.
+Every file runs a chain of four stages (read, process, report, output), each
+spending a calibrated amount of busy CPU time (workload_spin() from
+include/workload.h) instead of sleeping. The sweep varies that stage time from
+1 us to 10 ms, so the same pipelines are measured from runtime-dominated to
+compute-dominated task sizes.
 
-Parallelization at the file level is sufficient: Since each file can be processed independently, and the file-level tasks are equally distributed among threads, we get good performance even without exploiting potential parallelism within the file processing pipeline.
+Earlier versions slept 0.1 s per stage. Sleeping threads give up the CPU, so
+every implementation appeared to scale perfectly at any thread count and the
+numbers said nothing about task overhead or oversubscription.
 
-Conclusions
-For this workload, the simplest implementation is best: The sequential processing implementation achieves the same performance with the simplest code, making it the recommended approach.
+How to read the results
+Efficiency is the busy-work time divided by threads x wall time. At
+millisecond stages all three implementations should approach 1.0 as long as
+threads <= cores. At microsecond stages the cost of creating tasks,
+resolving depend() clauses and (for the original version) opening a nested
+parallel region per file dominates, and efficiency collapses.
 
-Nested parallelism didn't hurt performance: Contrary to common warnings about nested parallelism overhead, it didn't significantly impact performance in this case.
+The "minimum stage time" table is the granularity below which a pipeline is
+dominated by runtime overhead; stages of our pipelines should stay above it.
 
-Task dependencies work effectively: The task dependency model correctly enforced the processing order while allowing parallelism across different files.
+Thread counts above the number of cores time-share the CPU, so efficiency
+there drops by roughly cores/threads regardless of granularity.
 
-Implementation choice depends on future flexibility needs.
-*/
\ No newline at end of file
+File pipeline
+The second part reads, parses, transforms and writes real files in a scratch
+directory (BENCH_TMPDIR). Inputs are read once before timing, so reads usually
+hit the page cache while writes go through the kernel's write-back path.
+- Blocking tasks: a thread sitting in pread/pwrite cannot run other tasks.
+- Dedicated I/O thread: reads and writes are serialized on one thread; it
+  wins when the device prefers sequential access and compute keeps up.
+- Detached AIO tasks: the read and write tasks return immediately and complete
+  when glibc's AIO threads fulfill their events, so even one OpenMP thread
+  overlaps compute with I/O. Speedups above 1 on a single core come from that
+  overlap.
+- Detached io_uring / I/O pool: the same task graph on include/async_io.h.
+  io_uring queues the transfers in the kernel and one reaper thread fulfills
+  the events; the pool runs blocking pread/pwrite on IO_DEPTH POSIX threads,
+  which is what glibc AIO does too but without its per-request signal thread.
+  With the page cache warm the kernel often completes io_uring reads inline,
+  so the gain over blocking tasks shows mostly on cold data and writes.
+*/
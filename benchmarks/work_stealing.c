@@ -0,0 +1,349 @@
+// Work-stealing runtime (include/work_stealing.h) against OpenMP tasks.
+// The same recursive algorithms run on both: fib with a serial cutoff,
+// parallel_sort-style mergesort and an unbalanced binomial tree search (UTS).
+// Reports time per case and the task throughput, from which the cost of
+// creating and scheduling one task can be read.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/parallel_algorithms.h"
+#include "../include/work_stealing.h"
+
+#define FIB_N 30
+#define FIB_CUTOFF 8           // Below this fib runs serially
+#define SORT_SIZE 2000000
+#define SORT_CUTOFF 4096       // Elements sorted serially
+#define UTS_ROOT_CHILDREN 2000 // Binomial UTS: b0 root children,
+#define UTS_CHILDREN 8         // every other node has m children
+#define UTS_PROBABILITY 0.1225 // with probability q (q*m < 1 keeps the tree finite)
+
+// ---- fib ----
+
+typedef struct {
+    int n;
+    long result;
+} FibArgs;
+
+static long fib_serial(int n) {
+    return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+// Number of tasks one fib(n) call creates above the cutoff
+static long fib_tasks(int n) {
+    return n < FIB_CUTOFF ? 0 : 2 + fib_tasks(n - 1) + fib_tasks(n - 2);
+}
+
+static long fib_omp(int n) {
+    if (n < FIB_CUTOFF) return fib_serial(n);
+    long x, y;
+    #pragma omp task shared(x)
+    x = fib_omp(n - 1);
+    #pragma omp task shared(y)
+    y = fib_omp(n - 2);
+    #pragma omp taskwait
+    return x + y;
+}
+
+static void fib_ws(void* arg) {
+    FibArgs* f = (FibArgs*)arg;
+    if (f->n < FIB_CUTOFF) {
+        f->result = fib_serial(f->n);
+        return;
+    }
+    FibArgs a = { f->n - 1, 0 }, b = { f->n - 2, 0 };
+    ws_task_t task_a, task_b;
+    ws_spawn(&task_a, fib_ws, &a);
+    ws_spawn(&task_b, fib_ws, &b);
+    ws_join(&task_b);
+    ws_join(&task_a);
+    f->result = a.result + b.result;
+}
+
+// ---- mergesort ----
+
+typedef struct {
+    double* arr;
+    double* tmp;
+    long left;
+    long right;   // Inclusive
+} SortArgs;
+
+static void merge_ranges(double* arr, double* tmp, long left, long mid, long right) {
+    long i = left, j = mid + 1, k = left;
+    while (i <= mid && j <= right) tmp[k++] = arr[i] <= arr[j] ? arr[i++] : arr[j++];
+    while (i <= mid) tmp[k++] = arr[i++];
+    while (j <= right) tmp[k++] = arr[j++];
+    memcpy(arr + left, tmp + left, (right - left + 1) * sizeof(double));
+}
+
+static void sort_serial(double* arr, double* tmp, long left, long right) {
+    if (left >= right) return;
+    long mid = left + (right - left) / 2;
+    sort_serial(arr, tmp, left, mid);
+    sort_serial(arr, tmp, mid + 1, right);
+    merge_ranges(arr, tmp, left, mid, right);
+}
+
+static long sort_tasks(long n) {
+    return n <= SORT_CUTOFF ? 0 : 2 + sort_tasks(n / 2 + n % 2) + sort_tasks(n / 2);
+}
+
+static void sort_omp(double* arr, double* tmp, long left, long right) {
+    if (right - left < SORT_CUTOFF) {
+        sort_serial(arr, tmp, left, right);
+        return;
+    }
+    long mid = left + (right - left) / 2;
+    #pragma omp task
+    sort_omp(arr, tmp, left, mid);
+    #pragma omp task
+    sort_omp(arr, tmp, mid + 1, right);
+    #pragma omp taskwait
+    merge_ranges(arr, tmp, left, mid, right);
+}
+
+static void sort_ws(void* arg) {
+    SortArgs* s = (SortArgs*)arg;
+    if (s->right - s->left < SORT_CUTOFF) {
+        sort_serial(s->arr, s->tmp, s->left, s->right);
+        return;
+    }
+    long mid = s->left + (s->right - s->left) / 2;
+    SortArgs lo = { s->arr, s->tmp, s->left, mid };
+    SortArgs hi = { s->arr, s->tmp, mid + 1, s->right };
+    ws_task_t task_lo, task_hi;
+    ws_spawn(&task_lo, sort_ws, &lo);
+    ws_spawn(&task_hi, sort_ws, &hi);
+    ws_join(&task_hi);
+    ws_join(&task_lo);
+    merge_ranges(s->arr, s->tmp, s->left, mid, s->right);
+}
+
+// ---- Unbalanced tree search (binomial tree) ----
+
+typedef struct {
+    unsigned long long state;
+    int is_root;
+    long nodes;
+} UtsArgs;
+
+static unsigned long long uts_hash(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static int uts_children(unsigned long long state, int is_root) {
+    if (is_root) return UTS_ROOT_CHILDREN;
+    double u = (uts_hash(state) >> 11) * (1.0 / 9007199254740992.0);
+    return u < UTS_PROBABILITY ? UTS_CHILDREN : 0;
+}
+
+static unsigned long long uts_child(unsigned long long state, int i) {
+    return uts_hash(state * 31 + i + 1);
+}
+
+static long uts_serial(unsigned long long state, int is_root) {
+    long nodes = 1;
+    int n = uts_children(state, is_root);
+    for (int i = 0; i < n; i++) nodes += uts_serial(uts_child(state, i), 0);
+    return nodes;
+}
+
+static long uts_omp(unsigned long long state, int is_root) {
+    int n = uts_children(state, is_root);
+    if (n == 0) return 1;
+
+    long* counts = (long*)malloc(n * sizeof(long));
+    for (int i = 0; i < n; i++) {
+        #pragma omp task shared(counts) firstprivate(i)
+        counts[i] = uts_omp(uts_child(state, i), 0);
+    }
+    #pragma omp taskwait
+
+    long nodes = 1;
+    for (int i = 0; i < n; i++) nodes += counts[i];
+    free(counts);
+    return nodes;
+}
+
+static void uts_ws(void* arg) {
+    UtsArgs* u = (UtsArgs*)arg;
+    int n = uts_children(u->state, u->is_root);
+    u->nodes = 1;
+    if (n == 0) return;
+
+    UtsArgs* children = (UtsArgs*)malloc(n * sizeof(UtsArgs));
+    ws_task_t* tasks = (ws_task_t*)malloc(n * sizeof(ws_task_t));
+    for (int i = 0; i < n; i++) {
+        children[i].state = uts_child(u->state, i);
+        children[i].is_root = 0;
+        ws_spawn(&tasks[i], uts_ws, &children[i]);
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        ws_join(&tasks[i]);
+        u->nodes += children[i].nodes;
+    }
+    free(children);
+    free(tasks);
+}
+
+// ---- Benchmark cases ----
+
+typedef struct {
+    ws_pool_t* pool;
+    const double* input;  // Unsorted data, copied before every sort
+    double* arr;
+    double* tmp;
+    long n;
+    long result;
+} BenchArgs;
+
+void run_fib_omp(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    long result = 0;
+    #pragma omp parallel
+    #pragma omp single
+    result = fib_omp(FIB_N);
+    b->result = result;
+}
+
+void run_fib_ws(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    FibArgs f = { FIB_N, 0 };
+    ws_run(b->pool, fib_ws, &f);
+    b->result = f.result;
+}
+
+void run_sort_omp(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    memcpy(b->arr, b->input, b->n * sizeof(double));
+    #pragma omp parallel
+    #pragma omp single
+    sort_omp(b->arr, b->tmp, 0, b->n - 1);
+}
+
+void run_sort_ws(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    memcpy(b->arr, b->input, b->n * sizeof(double));
+    SortArgs s = { b->arr, b->tmp, 0, b->n - 1 };
+    ws_run(b->pool, sort_ws, &s);
+}
+
+void run_sort_library(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    memcpy(b->arr, b->input, b->n * sizeof(double));
+    parallel_sort(b->arr, (int)b->n);
+}
+
+void run_uts_omp(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    long nodes = 0;
+    #pragma omp parallel
+    #pragma omp single
+    nodes = uts_omp(1, 1);
+    b->result = nodes;
+}
+
+void run_uts_ws(void* arg) {
+    BenchArgs* b = (BenchArgs*)arg;
+    UtsArgs u = { 1, 1, 0 };
+    ws_run(b->pool, uts_ws, &u);
+    b->result = u.nodes;
+}
+
+typedef enum { WORK_FIB = 0, WORK_SORT, WORK_UTS } Workload;
+
+typedef struct {
+    const char* name;
+    bench_fn_t fn;
+    Workload workload;
+    int uses_pool;
+} Case;
+
+static int is_sorted(const double* arr, long n) {
+    for (long i = 1; i < n; i++) {
+        if (arr[i - 1] > arr[i]) return 0;
+    }
+    return 1;
+}
+
+int main() {
+    const long n = bench_problem_size(SORT_SIZE, 1);
+    double* input = (double*)malloc(n * sizeof(double));
+    double* arr = (double*)malloc(n * sizeof(double));
+    double* tmp = (double*)malloc(n * sizeof(double));
+    ws_pool_t* pool = ws_pool_create(omp_get_max_threads());
+    if (!input || !arr || !tmp || !pool) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+
+    srand(42);
+    for (long i = 0; i < n; i++) input[i] = (double)rand() / RAND_MAX;
+
+    long uts_nodes = uts_serial(1, 1);
+    long task_counts[] = { fib_tasks(FIB_N), sort_tasks(n), uts_nodes - 1 };
+
+    Case cases[] = {
+        { "fib/omp_task", run_fib_omp, WORK_FIB, 0 },
+        { "fib/work_stealing", run_fib_ws, WORK_FIB, 1 },
+        { "sort/omp_task", run_sort_omp, WORK_SORT, 0 },
+        { "sort/work_stealing", run_sort_ws, WORK_SORT, 1 },
+        { "sort/parallel_sort", run_sort_library, WORK_SORT, 0 },
+        { "uts/omp_task", run_uts_omp, WORK_UTS, 0 },
+        { "uts/work_stealing", run_uts_ws, WORK_UTS, 1 },
+    };
+    int num_cases = sizeof(cases) / sizeof(cases[0]);
+    double medians[16];
+    ws_stats_t steals[16];
+
+    bench_report_begin("work_stealing");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "fib(%d) cutoff %d, sort of %ld doubles cutoff %d, UTS binomial b0=%d m=%d q=%.4f (%ld nodes)\n\n",
+            FIB_N, FIB_CUTOFF, n, SORT_CUTOFF, UTS_ROOT_CHILDREN, UTS_CHILDREN, UTS_PROBABILITY, uts_nodes);
+
+    int errors = 0;
+    for (int c = 0; c < num_cases; c++) {
+        BenchArgs args = { pool, input, arr, tmp, n, 0 };
+        bench_result_t result;
+
+        bench_run(NULL, cases[c].name, task_counts[cases[c].workload], cases[c].fn, &args, &result);
+        bench_report_result(&result);
+        medians[c] = result.median;
+        bench_result_free(&result);
+        if (cases[c].uses_pool) ws_pool_stats(pool, &steals[c]);
+
+        // Check the answer of the last run
+        switch (cases[c].workload) {
+            case WORK_FIB: errors += args.result != fib_serial(FIB_N); break;
+            case WORK_SORT: errors += !is_sorted(arr, n); break;
+            case WORK_UTS: errors += args.result != uts_nodes; break;
+        }
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\n%-20s %12s %10s %12s %14s %10s\n", "case", "median(s)", "tasks",
+            "Mtasks/s", "ns/task/thread", "steals");
+    for (int c = 0; c < num_cases; c++) {
+        long tasks = task_counts[cases[c].workload];
+        fprintf(msg, "%-20s %12.6f %10ld %12.3f %14.1f ", cases[c].name, medians[c], tasks,
+                tasks / medians[c] / 1e6, medians[c] * omp_get_max_threads() / tasks * 1e9);
+        if (cases[c].uses_pool) {
+            fprintf(msg, "%10ld\n", steals[c].stolen);
+        } else {
+            fprintf(msg, "%10s\n", "-");
+        }
+    }
+    if (errors) fprintf(msg, "\n%d case(s) produced a wrong result!\n", errors);
+
+    ws_pool_destroy(pool);
+    free(input);
+    free(arr);
+    free(tmp);
+    return errors || regressions ? 1 : 0;
+}
@@ -3,59 +3,209 @@
 #include <stdlib.h>
 #include <omp.h>
 #include <math.h>
+#include "../include/bench_harness.h"
+#include "../include/loop_profile.h"
+#include "../include/workload.h"
+#include "../include/adaptive_for.h"
 
-int main() {
-    const int SIZE = 1000000;
-    double sum_static = 0.0, sum_dynamic = 0.0, sum_guided = 0.0;
-    double start, end;
-    
-    // Initialize work array with uneven workload
-    double* work = (double*)malloc(SIZE * sizeof(double));
-    for (int i = 0; i < SIZE; i++) {
-        work[i] = i % 100 ? 1.0 : 10000.0; // Every 100th element requires more work
-    }
-    
-    printf("Comparing different scheduling strategies:\n");
-    
-    // Static scheduling (equal chunks)
-    start = omp_get_wtime();
-    #pragma omp parallel for reduction(+:sum_static) schedule(static, 1000)
-    for (int i = 0; i < SIZE; i++) {
-        // Simulate different work amounts
-        for (int j = 0; j < work[i]; j++) {
-            sum_static += sin(j) * cos(j);
+#define NUM_SCHEDULES 6
+// Mean cost per element of the original mix: one element in 100 costs 10000,
+// the other 99 cost 1, so (10000 + 99) / 100 = 100.99
+#define MEAN_COST ((10000.0 + 99.0) / 100.0)
+
+// Adaptive loops accumulate into one padded slot per thread
+typedef struct {
+    double value;
+} __attribute__((aligned(64))) PartialSum;
+
+typedef struct {
+    const double* work;
+    int size;
+    double sum;
+    loop_profile_t* profile;  // NULL while timing
+    adaptive_site_t* site;    // Learned state of the adaptive schedules
+    PartialSum* partial;
+} ScheduleArgs;
+
+// Static scheduling (equal chunks)
+void run_static(void* arg) {
+    ScheduleArgs* args = (ScheduleArgs*)arg;
+    const double* work = args->work;
+    double sum = 0.0;
+
+    #pragma omp parallel reduction(+:sum)
+    {
+        loop_profile_thread_begin(args->profile);
+
+        #pragma omp for schedule(static, 1000) nowait
+        for (int i = 0; i < args->size; i++) {
+            loop_profile_iteration(args->profile, i);
+            // Simulate different work amounts
+            for (int j = 0; j < work[i]; j++) {
+                sum += sin(j) * cos(j);
+            }
         }
+
+        loop_profile_thread_end(args->profile);
     }
-    end = omp_get_wtime();
-    printf("Static scheduling: %.4f seconds\n", end - start);
-    
-    // Dynamic scheduling (work stealing)
-    start = omp_get_wtime();
-    #pragma omp parallel for reduction(+:sum_dynamic) schedule(dynamic, 1000)
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < work[i]; j++) {
-            sum_dynamic += sin(j) * cos(j);
+    args->sum = sum;
+}
+
+// Dynamic scheduling (work stealing)
+void run_dynamic(void* arg) {
+    ScheduleArgs* args = (ScheduleArgs*)arg;
+    const double* work = args->work;
+    double sum = 0.0;
+
+    #pragma omp parallel reduction(+:sum)
+    {
+        loop_profile_thread_begin(args->profile);
+
+        #pragma omp for schedule(dynamic, 1000) nowait
+        for (int i = 0; i < args->size; i++) {
+            loop_profile_iteration(args->profile, i);
+            for (int j = 0; j < work[i]; j++) {
+                sum += sin(j) * cos(j);
+            }
         }
+
+        loop_profile_thread_end(args->profile);
+    }
+    args->sum = sum;
+}
+
+// Guided scheduling (decreasing chunk size)
+void run_guided(void* arg) {
+    ScheduleArgs* args = (ScheduleArgs*)arg;
+    const double* work = args->work;
+    double sum = 0.0;
+
+    #pragma omp parallel reduction(+:sum)
+    {
+        loop_profile_thread_begin(args->profile);
+
+        #pragma omp for schedule(guided, 100) nowait
+        for (int i = 0; i < args->size; i++) {
+            loop_profile_iteration(args->profile, i);
+            for (int j = 0; j < work[i]; j++) {
+                sum += sin(j) * cos(j);
+            }
+        }
+
+        loop_profile_thread_end(args->profile);
     }
-    end = omp_get_wtime();
-    printf("Dynamic scheduling: %.4f seconds\n", end - start);
-    
-    // Guided scheduling (decreasing chunk size)
-    start = omp_get_wtime();
-    #pragma omp parallel for reduction(+:sum_guided) schedule(guided, 100)
-    for (int i = 0; i < SIZE; i++) {
+    args->sum = sum;
+}
+
+static void adaptive_body(long begin, long end, void* arg) {
+    ScheduleArgs* args = (ScheduleArgs*)arg;
+    const double* work = args->work;
+    double sum = 0.0;
+
+    for (long i = begin; i < end; i++) {
         for (int j = 0; j < work[i]; j++) {
-            sum_guided += sin(j) * cos(j);
+            sum += sin(j) * cos(j);
         }
     }
-    end = omp_get_wtime();
-    printf("Guided scheduling: %.4f seconds\n", end - start);
-    
-    printf("\nResults verification (all should be similar):\n");
-    printf("Static sum: %.1f\n", sum_static);
-    printf("Dynamic sum: %.1f\n", sum_dynamic);
-    printf("Guided sum: %.1f\n", sum_guided);
-    
+    args->partial[omp_get_thread_num()].value += sum;
+}
+
+// Adaptive self-scheduling (factoring, TSS or AWF, see include/adaptive_for.h)
+void run_adaptive(void* arg) {
+    ScheduleArgs* args = (ScheduleArgs*)arg;
+    int threads = omp_get_max_threads();
+
+    for (int t = 0; t < threads; t++) args->partial[t].value = 0.0;
+    args->site->profile = args->profile;
+    adaptive_for(args->site, args->size, adaptive_body, args);
+
+    args->sum = 0.0;
+    for (int t = 0; t < threads; t++) args->sum += args->partial[t].value;
+}
+
+int main(int argc, char* argv[]) {
+    const int SIZE = (int)bench_problem_size(1000000, 1);
+
+    // Uneven workload: by default every 100th element requires 10000x more
+    // work, other profiles from include/workload.h can be named on the command line
+    int profile = argc > 1 ? workload_profile_parse(argv[1]) : WORKLOAD_PERIODIC;
+    if (profile < 0) {
+        fprintf(stderr, "Unknown workload profile '%s'\n", argv[1]);
+        return 1;
+    }
+
+    double* work = (double*)malloc(SIZE * sizeof(double));
+    PartialSum* partial = (PartialSum*)aligned_alloc(64, omp_get_max_threads() * sizeof(PartialSum));
+    if (!work || !partial || workload_generate(work, SIZE, profile, MEAN_COST, 42) != 0) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+
+    bench_report_begin("scheduling_comparison");
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "Comparing different scheduling strategies (%s workload):\n",
+            workload_profile_name(profile));
+
+    const char* names[] = { "static,1000", "dynamic,1000", "guided,100",
+                            "factoring", "tss", "awf" };
+    bench_fn_t schedules[] = { run_static, run_dynamic, run_guided,
+                               run_adaptive, run_adaptive, run_adaptive };
+    double sums[NUM_SCHEDULES];
+    loop_profile_t profiles[NUM_SCHEDULES];
+
+    // Sites persist across the repetitions of bench_run, so they learn as it measures
+    adaptive_site_t sites[ADAPTIVE_NUM_STRATEGIES];
+    for (int a = 0; a < ADAPTIVE_NUM_STRATEGIES; a++) {
+        adaptive_site_init(&sites[a], adaptive_strategy_name(a), a);
+    }
+
+    for (int s = 0; s < NUM_SCHEDULES; s++) {
+        ScheduleArgs args = { work, SIZE, 0.0, NULL, s >= 3 ? &sites[s - 3] : NULL, partial };
+        bench_result_t result;
+
+        bench_run(NULL, names[s], SIZE, schedules[s], &args, &result);
+        bench_report_result(&result);
+        bench_result_free(&result);
+        sums[s] = args.sum;
+
+        // One more run with per-thread instrumentation, kept out of the timings
+        loop_profile_init(&profiles[s], names[s]);
+        args.profile = &profiles[s];
+        schedules[s](&args);
+    }
+
+    int regressions = bench_report_end();
+
+    fprintf(msg, "\nResults verification (all should be similar):\n");
+    fprintf(msg, "Static sum: %.1f\n", sums[0]);
+    fprintf(msg, "Dynamic sum: %.1f\n", sums[1]);
+    fprintf(msg, "Guided sum: %.1f\n", sums[2]);
+    for (int a = 0; a < ADAPTIVE_NUM_STRATEGIES; a++) {
+        fprintf(msg, "Adaptive %s sum: %.1f\n", sites[a].name, sums[3 + a]);
+    }
+
+    fprintf(msg, "\n");
+    for (int s = 0; s < NUM_SCHEDULES; s++) {
+        loop_profile_print(msg, &profiles[s]);
+    }
+
+    fprintf(msg, "\n%-14s %10s %10s %10s\n", "schedule", "imbalance", "idle(%)", "chunks");
+    for (int s = 0; s < NUM_SCHEDULES; s++) {
+        loop_profile_summary_t summary;
+        loop_profile_summarize(&profiles[s], &summary);
+        fprintf(msg, "%-14s %10.3f %10.1f %10ld\n", names[s], summary.imbalance,
+                summary.idle_fraction * 100.0, summary.chunks);
+        loop_profile_free(&profiles[s]);
+    }
+
+    fprintf(msg, "\nLearned by the adaptive sites:\n");
+    for (int a = 0; a < ADAPTIVE_NUM_STRATEGIES; a++) {
+        fprintf(msg, "%-10s %d invocations, %.3f us/iteration, min chunk %ld, %ld chunks last run\n",
+                sites[a].name, sites[a].invocations, sites[a].iteration_time * 1e6,
+                sites[a].min_chunk, sites[a].last_chunks);
+    }
+
+    free(partial);
     free(work);
-    return 0;
-}
\ No newline at end of file
+    return regressions ? 1 : 0;
+}
@@ -3,72 +3,106 @@
 #include <stdlib.h>
 #include <omp.h>
 #include <math.h>
+#include "../include/bench_harness.h"
+
+typedef struct {
+    float* a;
+    float* b;
+    float* c;
+    int n;
+    float sum, min_val, max_val;
+} SimdArgs;
+
+// Standard parallel for
+void vector_ops_plain(void* arg) {
+    SimdArgs* v = (SimdArgs*)arg;
+    float *a = v->a, *b = v->b, *c = v->c;
 
-// Function to demonstrate basic SIMD directive
-void vector_ops_simd(float* a, float* b, float* c, int n) {
-    double start = omp_get_wtime();
-    
-    // Standard parallel for
     #pragma omp parallel for
-    for (int i = 0; i < n; i++) {
+    for (int i = 0; i < v->n; i++) {
         c[i] = a[i] * a[i] + b[i];
     }
-    
-    double middle = omp_get_wtime();
-    
-    // SIMD-enabled parallel for
+}
+
+// SIMD-enabled parallel for
+void vector_ops_simd(void* arg) {
+    SimdArgs* v = (SimdArgs*)arg;
+    float *a = v->a, *b = v->b, *c = v->c;
+
     #pragma omp parallel for simd
-    for (int i = 0; i < n; i++) {
+    for (int i = 0; i < v->n; i++) {
         c[i] = a[i] * a[i] + b[i];
     }
-    
-    double end = omp_get_wtime();
-    
-    printf("Vector operation on %d elements:\n", n);
-    printf("  Standard parallel for: %.6f seconds\n", middle - start);
-    printf("  SIMD-enabled parallel for: %.6f seconds\n", end - middle);
-    printf("  Speedup: %.2fx\n", (middle - start) / (end - middle));
 }
 
-// Function demonstrating SIMD with alignment
-void simd_alignment_example(float* a, float* b, int n) {
-    printf("\nSIMD alignment example:\n");
-    double start = omp_get_wtime();
-    
-    // Aligned memory example with safelen
+// Aligned memory example with safelen
+void simd_alignment(void* arg) {
+    SimdArgs* v = (SimdArgs*)arg;
+    float *a = v->a, *b = v->b;
+
     #pragma omp simd aligned(a, b:64) safelen(16)
-    for (int i = 0; i < n; i++) {
+    for (int i = 0; i < v->n; i++) {
         a[i] = sin(b[i]) * cos(b[i]);
     }
-    
-    double end = omp_get_wtime();
-    printf("  SIMD with alignment directives: %.6f seconds\n", end - start);
-    
-    // Display a small sample of results
-    printf("  Sample results: a[0]=%.4f, a[1]=%.4f, a[2]=%.4f\n", 
-           a[0], a[1], a[2]);
 }
 
-// Function demonstrating SIMD with multiple reduction operations
-void simd_reduction_example(float* data, int n) {
+// Multiple reduction operations
+void simd_reduction(void* arg) {
+    SimdArgs* v = (SimdArgs*)arg;
+    float* data = v->a;
     float sum = 0.0f, min_val = INFINITY, max_val = -INFINITY;
-    
-    printf("\nSIMD reduction example:\n");
-    double start = omp_get_wtime();
-    
-    // Multiple reduction operations
+
     #pragma omp simd reduction(+:sum) reduction(min:min_val) reduction(max:max_val)
-    for (int i = 0; i < n; i++) {
+    for (int i = 0; i < v->n; i++) {
         sum += data[i];
         min_val = fmin(min_val, data[i]);
         max_val = fmax(max_val, data[i]);
     }
-    
-    double end = omp_get_wtime();
-    
-    printf("  SIMD reduction time: %.6f seconds\n", end - start);
-    printf("  Results: sum=%.2f, min=%.2f, max=%.2f\n", 
-           sum, min_val, max_val);
+
+    v->sum = sum;
+    v->min_val = min_val;
+    v->max_val = max_val;
+}
+
+// Function to demonstrate basic SIMD directive
+void vector_ops_example(SimdArgs* args) {
+    bench_result_t plain, simd;
+
+    bench_run(NULL, "parallel_for", args->n, vector_ops_plain, args, &plain);
+    bench_report_result(&plain);
+    bench_run(NULL, "parallel_for_simd", args->n, vector_ops_simd, args, &simd);
+    bench_report_result(&simd);
+
+    fprintf(bench_log_stream(), "  SIMD speedup over standard parallel for: %.2fx\n",
+            plain.median / simd.median);
+
+    bench_result_free(&plain);
+    bench_result_free(&simd);
+}
+
+// Function demonstrating SIMD with alignment
+void simd_alignment_example(SimdArgs* args) {
+    bench_result_t result;
+
+    bench_run(NULL, "simd_aligned", args->n, simd_alignment, args, &result);
+    bench_report_result(&result);
+    bench_result_free(&result);
+
+    // Display a small sample of results
+    fprintf(bench_log_stream(), "  Sample results: a[0]=%.4f, a[1]=%.4f, a[2]=%.4f\n",
+            args->a[0], args->a[1], args->a[2]);
+}
+
+// Function demonstrating SIMD with multiple reduction operations
+void simd_reduction_example(SimdArgs* args) {
+    bench_result_t result;
+
+    bench_run(NULL, "simd_reduction", args->n, simd_reduction, args, &result);
+    bench_report_result(&result);
+    bench_result_free(&result);
+
+    fprintf(bench_log_stream(), "  Results: sum=%.2f, min=%.2f, max=%.2f\n",
+            args->sum, args->min_val, args->max_val);
 }
 
 // Function demonstrating collapse clause with SIMD
@@ -77,18 +111,16 @@ void simd_collapse_example() {
     const int M = 100;
     float matrix[N][M];
     float sum = 0.0f;
-    
-    printf("\nSIMD collapse example:\n");
-    
+
     // Initialize matrix
     for (int i = 0; i < N; i++) {
         for (int j = 0; j < M; j++) {
             matrix[i][j] = (float)(i * j) / (N * M);
         }
     }
-    
+
     double start = omp_get_wtime();
-    
+
     // Collapse nested loops with SIMD
     #pragma omp parallel for simd collapse(2) reduction(+:sum)
     for (int i = 0; i < N; i++) {
@@ -96,28 +128,32 @@ void simd_collapse_example() {
             sum += matrix[i][j];
         }
     }
-    
+
     double end = omp_get_wtime();
-    
-    printf("  SIMD collapse time: %.6f seconds\n", end - start);
-    printf("  Sum of matrix elements: %.2f\n", sum);
+
+    // A single 100x100 pass is too short for the harness; report it directly
+    FILE* msg = bench_log_stream();
+    fprintf(msg, "\nSIMD collapse example:\n");
+    fprintf(msg, "  SIMD collapse time: %.6f seconds\n", end - start);
+    fprintf(msg, "  Sum of matrix elements: %.2f\n", sum);
 }
 
 int main() {
-    const int SIZE = 10000000;
-    
-    printf("=== OpenMP SIMD Directives Examples ===\n\n");
-    
+    const int SIZE = (int)bench_problem_size(10000000, 1);
+
+    bench_report_begin("simd_directives");
+    fprintf(bench_log_stream(), "=== OpenMP SIMD Directives Examples ===\n\n");
+
     // Allocate aligned memory
     float* a = (float*)aligned_alloc(64, SIZE * sizeof(float));
     float* b = (float*)aligned_alloc(64, SIZE * sizeof(float));
     float* c = (float*)aligned_alloc(64, SIZE * sizeof(float));
-    
+
     if (!a || !b || !c) {
-        printf("Memory allocation failed!\n");
+        fprintf(stderr, "Memory allocation failed!\n");
         return 1;
     }
-    
+
     // Initialize data
     #pragma omp parallel for
     for (int i = 0; i < SIZE; i++) {
@@ -125,17 +161,20 @@ int main() {
         b[i] = (float)(SIZE - i) / SIZE;
         c[i] = 0.0f;
     }
-    
+
+    SimdArgs args = { a, b, c, SIZE, 0.0f, 0.0f, 0.0f };
+
     // Run examples
-    vector_ops_simd(a, b, c, SIZE);
-    simd_alignment_example(a, b, SIZE);
-    simd_reduction_example(a, SIZE);
+    vector_ops_example(&args);
+    simd_alignment_example(&args);
+    simd_reduction_example(&args);
+    int regressions = bench_report_end();
     simd_collapse_example();
-    
+
     // Clean up
     free(a);
     free(b);
     free(c);
-    
-    return 0;
-}
\ No newline at end of file
+
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,201 @@
+// Example: streaming a large file through read -> parse -> compute -> write
+//
+// task_dependencies.c runs one task per stage over whole-file buffers, so
+// memory grows with the file and a stage only starts once the previous one
+// finished the entire file. Here the file flows through the stages in 1 MB
+// chunks (include/stream_pipeline.h): reading and writing stay serial and in
+// order, parsing and computing run on every thread, all stages overlap, and
+// memory is bounded by the chunk pool however large the file is.
+//
+// Usage: streaming_pipeline [size_MB] [input_file]
+// Without an input file, one of size_MB (default 64) is generated in
+// BENCH_TMPDIR (default /tmp) and removed afterwards.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <omp.h>
+#include "../include/stream_pipeline.h"
+
+#define CHUNK_SIZE (1 << 20)
+#define NUM_CHUNKS 16
+
+typedef struct {
+    int fd;
+    off_t offset;       // Next byte to read
+    size_t carry;       // Bytes of an incomplete last line kept for the next chunk
+    char* carry_buf;
+} Reader;
+
+typedef struct {
+    int fd;
+    long bytes;
+} Writer;
+
+static long checksum = 0;
+
+// Serial source: read the next piece and cut it after its last complete line
+static int read_chunk(stream_chunk_t* chunk, void* arg) {
+    Reader* r = (Reader*)arg;
+    memcpy(chunk->data, r->carry_buf, r->carry);
+    size_t size = r->carry;
+
+    ssize_t n = pread(r->fd, chunk->data + size, chunk->capacity - size, r->offset);
+    if (n < 0) return -1;
+    r->offset += n;
+    size += n;
+    if (size == 0) return 0;
+
+    size_t end = size;
+    if (n > 0) {
+        while (end > 0 && chunk->data[end - 1] != '\n') end--;
+        if (end == 0) return -1;  // A line longer than a chunk
+    }
+    r->carry = size - end;
+    memcpy(r->carry_buf, chunk->data + end, r->carry);
+    chunk->size = end;
+    return 1;
+}
+
+// Parallel: text lines to an int array in scratch
+static int parse_chunk(stream_chunk_t* chunk, void* arg) {
+    (void)arg;
+    int* values = (int*)chunk->scratch;
+    long max_values = chunk->capacity / sizeof(int);
+    long count = 0;
+    const char* p = chunk->data;
+    const char* end = chunk->data + chunk->size;
+
+    while (p < end) {
+        int v = 0;
+        while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+        if (count == max_values) return -1;
+        values[count++] = v;
+        while (p < end && (*p < '0' || *p > '9')) p++;
+    }
+    chunk->count = count;
+    stream_chunk_swap(chunk);
+    return 0;
+}
+
+// Parallel: scramble every value and format the results as text in scratch
+static int compute_chunk(stream_chunk_t* chunk, void* arg) {
+    (void)arg;
+    const int* values = (const int*)chunk->data;
+    char* out = chunk->scratch;
+    char* limit = chunk->scratch + chunk->capacity - 12;
+    long sum = 0;
+
+    for (long i = 0; i < chunk->count; i++) {
+        long v = (long)(((unsigned long long)values[i] * 2654435761ULL) % 1000003ULL);
+        sum += v;
+        if (out > limit) return -1;
+
+        char digits[12];
+        int n = 0;
+        do {
+            digits[n++] = (char)('0' + v % 10);
+            v /= 10;
+        } while (v);
+        while (n) *out++ = digits[--n];
+        *out++ = '\n';
+    }
+
+    #pragma omp atomic
+    checksum += sum;
+
+    chunk->size = out - chunk->scratch;
+    stream_chunk_swap(chunk);
+    return 0;
+}
+
+// Serial, in order: append to the output file
+static int write_chunk(stream_chunk_t* chunk, void* arg) {
+    Writer* w = (Writer*)arg;
+    size_t done = 0;
+    while (done < chunk->size) {
+        ssize_t n = write(w->fd, chunk->data + done, chunk->size - done);
+        if (n <= 0) return -1;
+        done += n;
+    }
+    w->bytes += chunk->size;
+    return 0;
+}
+
+// Nine-digit numbers, one per line
+static int generate_input(const char* path, long size) {
+    FILE* out = fopen(path, "w");
+    if (!out) return -1;
+    unsigned long long x = 42;
+    for (long written = 0; written < size; written += 10) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        fprintf(out, "%llu\n", 100000000ULL + (x >> 33) % 900000000ULL);
+    }
+    return fclose(out);
+}
+
+int main(int argc, char* argv[]) {
+    long size_mb = argc > 1 ? atol(argv[1]) : 64;
+    const char* tmp = getenv("BENCH_TMPDIR");
+    char input[512], output[520];
+    int generated = argc <= 2;
+
+    if (generated) {
+        snprintf(input, sizeof(input), "%s/streaming_input.%d.txt", tmp && *tmp ? tmp : "/tmp", (int)getpid());
+        printf("Generating %ld MB of input in %s\n", size_mb, input);
+        if (generate_input(input, size_mb << 20) != 0) {
+            fprintf(stderr, "Could not write %s\n", input);
+            return 1;
+        }
+    } else {
+        snprintf(input, sizeof(input), "%s", argv[2]);
+    }
+    snprintf(output, sizeof(output), "%s.out", input);
+
+    Reader reader = { open(input, O_RDONLY), 0, 0, (char*)malloc(CHUNK_SIZE) };
+    Writer writer = { open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644), 0 };
+    stream_pipeline_t* pipeline = stream_pipeline_create(NUM_CHUNKS, CHUNK_SIZE);
+    if (reader.fd < 0 || writer.fd < 0 || !reader.carry_buf || !pipeline) {
+        fprintf(stderr, "Could not set up the pipeline for %s\n", input);
+        return 1;
+    }
+
+    stream_pipeline_source(pipeline, "read", read_chunk, &reader);
+    stream_pipeline_add_stage(pipeline, "parse", STREAM_PARALLEL, parse_chunk, NULL);
+    stream_pipeline_add_stage(pipeline, "compute", STREAM_PARALLEL, compute_chunk, NULL);
+    stream_pipeline_add_stage(pipeline, "write", STREAM_SERIAL, write_chunk, &writer);
+
+    struct stat st;
+    fstat(reader.fd, &st);
+    double start = omp_get_wtime();
+    int status = stream_pipeline_run(pipeline);
+    double elapsed = omp_get_wtime() - start;
+
+    printf("\n%s: %.1f MB in %.3f s (%.0f MB/s) with %d threads, %ld bytes written, checksum %ld\n",
+           status == 0 ? "Done" : "FAILED", st.st_size / 1e6, elapsed, st.st_size / elapsed / 1e6,
+           omp_get_max_threads(), writer.bytes, checksum);
+    printf("Chunk memory: %.1f MB for a %.1f MB file\n\n",
+           2.0 * NUM_CHUNKS * CHUNK_SIZE / 1e6, st.st_size / 1e6);
+
+    // A serial stage near 100% busy is the bottleneck
+    stream_stage_stats_t stats[STREAM_MAX_STAGES + 1];
+    int stages = stream_pipeline_stats(pipeline, stats);
+    printf("%-10s %-9s %8s %10s %8s\n", "stage", "mode", "chunks", "busy(s)", "busy%");
+    for (int s = 0; s < stages; s++) {
+        printf("%-10s %-9s %8ld %10.3f %7.1f%%\n", stats[s].name,
+               stats[s].mode == STREAM_SERIAL ? "serial" : "parallel", stats[s].chunks,
+               stats[s].busy, 100.0 * stats[s].busy / elapsed);
+    }
+
+    stream_pipeline_destroy(pipeline);
+    close(reader.fd);
+    close(writer.fd);
+    free(reader.carry_buf);
+    if (generated) {
+        unlink(input);
+        unlink(output);
+    }
+    return status == 0 ? 0 : 1;
+}
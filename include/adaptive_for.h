@@ -0,0 +1,77 @@
+#ifndef ADAPTIVE_FOR_H
+#define ADAPTIVE_FOR_H
+
+#include "loop_profile.h"
+
+#define ADAPTIVE_MAX_THREADS 256
+#define ADAPTIVE_NAME_LEN 64
+
+/**
+ * Self-scheduling parallel loops that adapt their chunk sizes.
+ *
+ * Threads grab chunks of iterations from a shared counter (omp atomic
+ * capture) with sizes chosen by one of the classic self-scheduling rules:
+ *
+ *  - factoring (FAC2): batches of one chunk per thread, each batch hands out
+ *    half of the remaining iterations
+ *  - trapezoid self-scheduling (TSS): chunk sizes decrease linearly from
+ *    n / (2P) down to the minimum chunk
+ *  - adaptive weighted factoring (AWF): factoring with every thread's chunk
+ *    scaled by its measured relative speed
+ *
+ * Each loop site keeps what it learned across invocations: the mean cost of
+ * an iteration, from which the minimum chunk is set so one chunk costs at
+ * least target_chunk_time (amortizing the counter updates), and for AWF the
+ * per-thread speed weights.
+ */
+
+typedef enum {
+    ADAPTIVE_FACTORING = 0,
+    ADAPTIVE_TSS,
+    ADAPTIVE_AWF,
+    ADAPTIVE_NUM_STRATEGIES
+} adaptive_strategy_t;
+
+// Body of an adaptive loop: executes iterations [begin, end)
+typedef void (*adaptive_body_t)(long begin, long end, void* arg);
+
+// Learned state of one loop site, keep it alive between invocations
+typedef struct {
+    char name[ADAPTIVE_NAME_LEN];
+    adaptive_strategy_t strategy;
+    double target_chunk_time;   // Seconds one chunk should at least take
+    long min_chunk;             // Learned lower bound on the chunk size
+    double iteration_time;      // Smoothed mean seconds per iteration
+    double weight[ADAPTIVE_MAX_THREADS]; // AWF relative thread speeds (1.0 = average)
+    int invocations;
+    long last_chunks;           // Chunks handed out by the last invocation
+    double last_time;           // Wall time of the last invocation
+    loop_profile_t* profile;    // Optional per-thread instrumentation (NULL disables)
+} adaptive_site_t;
+
+/**
+ * Initialize a loop site
+ * @param site Site to initialize
+ * @param name Label used when printing
+ * @param strategy Chunking rule
+ */
+void adaptive_site_init(adaptive_site_t* site, const char* name, adaptive_strategy_t strategy);
+
+/**
+ * Name of a strategy (factoring, tss, awf)
+ * @param strategy Strategy
+ * @return Static name string
+ */
+const char* adaptive_strategy_name(adaptive_strategy_t strategy);
+
+/**
+ * Run body over [0, n) on omp_get_max_threads() threads, then update the
+ * site's learned chunk size and weights
+ * @param site Loop site state
+ * @param n Number of iterations
+ * @param body Loop body, called with disjoint ranges that cover [0, n)
+ * @param arg Argument passed to body
+ */
+void adaptive_for(adaptive_site_t* site, long n, adaptive_body_t body, void* arg);
+
+#endif // ADAPTIVE_FOR_H
@@ -0,0 +1,141 @@
+#ifndef ARRAY_FILE_H
+#define ARRAY_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARRAY_MAX_DIMS 4
+#define ARRAY_DEFAULT_ALIGNMENT 4096        // Data offset: page aligned for mmap and O_DIRECT
+#define ARRAY_DEFAULT_CHUNK (4 << 20)       // Bytes per checksummed chunk
+
+/**
+ * Binary array files: a fixed header, the raw elements at an aligned offset,
+ * and an optional table of per-chunk checksums after the data.
+ *
+ *     offset 0             array_header_t (magic, version, byte order, dtype,
+ *                          shape, alignment, chunk size, table offset)
+ *     data_offset          count * dtype size bytes, native byte order,
+ *                          data_offset a multiple of the alignment
+ *     checksum_offset      num_chunks uint64_t checksums of chunk_size pieces
+ *
+ * Loading replaces serial text parsing with either a zero-copy mapping of the
+ * data or concurrent preads of the chunks straight into an aligned buffer;
+ * the checksums are verified chunk by chunk in parallel while the data is
+ * still in cache. Files are read on machines with the byte order they were
+ * written with (checked through the header).
+ */
+
+typedef enum {
+    ARRAY_FLOAT64 = 0,
+    ARRAY_FLOAT32,
+    ARRAY_INT64,
+    ARRAY_INT32,
+    ARRAY_UINT8,
+    ARRAY_NUM_DTYPES
+} array_dtype_t;
+
+typedef enum {
+    ARRAY_LOAD_MMAP = 0,    // Private copy-on-write mapping: zero-copy, writable
+    ARRAY_LOAD_PREAD        // Parallel preads into an aligned buffer
+} array_load_mode_t;
+
+// On-disk header, native byte order
+typedef struct {
+    char magic[8];          // "OMPARRAY"
+    uint32_t version;
+    uint32_t byte_order;    // 0x01020304 as written by the producer
+    uint32_t dtype;
+    uint32_t ndim;
+    uint64_t shape[ARRAY_MAX_DIMS];
+    uint64_t alignment;
+    uint64_t data_offset;
+    uint64_t data_bytes;
+    uint64_t chunk_size;    // 0: no checksums
+    uint64_t num_chunks;
+    uint64_t checksum_offset;
+} array_header_t;
+
+// A loaded array; data points alignment-aligned into the file mapping or buffer
+typedef struct {
+    array_header_t header;
+    size_t count;           // Elements (product of the shape)
+    void* data;
+    void* mapping;          // Private fields, see array_free()
+    size_t mapping_size;
+} array_t;
+
+/**
+ * Size of one element
+ * @param dtype Element type
+ * @return Bytes per element, 0 for an unknown type
+ */
+size_t array_dtype_size(array_dtype_t dtype);
+
+/**
+ * Name of an element type ("float64", ...)
+ * @param dtype Element type
+ * @return Static name string
+ */
+const char* array_dtype_name(array_dtype_t dtype);
+
+/**
+ * 64-bit checksum of a byte range (four-lane multiply-rotate hash)
+ * @param data Bytes
+ * @param size Number of bytes
+ * @return Checksum
+ */
+uint64_t array_checksum(const void* data, size_t size);
+
+/**
+ * Fill in the header of an array file, for producers that write the data
+ * and checksum table themselves at the offsets it records
+ * @param header Output header
+ * @param dtype Element type
+ * @param ndim Number of dimensions (1..ARRAY_MAX_DIMS)
+ * @param shape Extent of every dimension
+ * @param alignment Data offset alignment, a power of two (0: ARRAY_DEFAULT_ALIGNMENT)
+ * @param chunk_size Bytes per checksummed chunk, 0 for no checksums
+ * @return 0 on success, -1 on invalid arguments
+ */
+int array_header_init(array_header_t* header, array_dtype_t dtype, int ndim, const size_t* shape,
+                      size_t alignment, size_t chunk_size);
+
+/**
+ * Write an array file; chunks are checksummed and written in parallel
+ * @param path Output file
+ * @param data Elements in row-major order
+ * @param dtype Element type
+ * @param ndim Number of dimensions (1..ARRAY_MAX_DIMS)
+ * @param shape Extent of every dimension
+ * @param alignment Data offset alignment, a power of two (0: ARRAY_DEFAULT_ALIGNMENT)
+ * @param chunk_size Bytes per checksummed chunk, 0 to store no checksums
+ * @return 0 on success, -1 on error
+ */
+int array_file_write(const char* path, const void* data, array_dtype_t dtype, int ndim, const size_t* shape,
+                     size_t alignment, size_t chunk_size);
+
+/**
+ * Read and validate the header of an array file
+ * @param path File to inspect
+ * @param header Output header
+ * @return 0 on success, -1 if the file cannot be read or is not a valid array file
+ */
+int array_file_info(const char* path, array_header_t* header);
+
+/**
+ * Load an array file
+ * @param path File to load
+ * @param mode Mapping or parallel preads
+ * @param verify Check every chunk against its checksum (ignored without checksums)
+ * @param array Output array; release with array_free()
+ * @return 0 on success, -1 if the file cannot be read or is invalid, -2 on a checksum mismatch
+ */
+int array_file_load(const char* path, array_load_mode_t mode, int verify, array_t* array);
+
+/**
+ * Release a loaded array
+ * @param array Array to release
+ */
+void array_free(array_t* array);
+
+#endif // ARRAY_FILE_H
@@ -0,0 +1,101 @@
+#ifndef ASYNC_IO_H
+#define ASYNC_IO_H
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <omp.h>
+
+/**
+ * Asynchronous file reads and writes completed through OpenMP detach events.
+ *
+ * A task that calls pread() parks its OpenMP thread in the kernel until the
+ * data arrives. Here the transfer is submitted from a detached task and the
+ * task's event is fulfilled when it completes, so the thread returns to the
+ * scheduler right away and runs compute tasks while the I/O is in flight:
+ *
+ *     async_io_t* io = async_io_create(ASYNC_IO_AUTO, 16);
+ *     #pragma omp task detach(read_done) depend(out: buf)
+ *     async_io_read(io, fd, buf, len, 0, &result, read_done);
+ *     #pragma omp task depend(in: buf)
+ *     parse(buf, result);
+ *
+ * Two backends:
+ *   ASYNC_IO_URING    io_uring through the raw system calls (no liburing), a
+ *                     helper thread reaps completions and fulfills the events
+ *   ASYNC_IO_THREADS  a pool of POSIX threads doing blocking pread/pwrite,
+ *                     for kernels or sandboxes without io_uring
+ * ASYNC_IO_AUTO picks io_uring when the kernel allows it.
+ *
+ * Short transfers are continued until len bytes moved or the file ended, so
+ * the result is the full byte count, fewer bytes at end of file, or -errno.
+ */
+
+typedef enum {
+    ASYNC_IO_AUTO = 0,
+    ASYNC_IO_URING,
+    ASYNC_IO_THREADS
+} async_io_backend_t;
+
+typedef struct async_io async_io_t;
+
+/**
+ * Create an I/O engine
+ * @param backend Backend to use (ASYNC_IO_AUTO: io_uring if available, else threads)
+ * @param depth Most requests in flight at once; the thread backend starts this many threads
+ * @return New engine, or NULL if the backend cannot be set up
+ */
+async_io_t* async_io_create(async_io_backend_t backend, int depth);
+
+/**
+ * Stop the engine; every submitted request must have completed. If the io_uring
+ * ring fails, the requests it holds complete with -errno and later submissions
+ * fail right away
+ * @param io Engine to destroy
+ */
+void async_io_destroy(async_io_t* io);
+
+/**
+ * Backend an engine runs on (never ASYNC_IO_AUTO)
+ * @param io Engine
+ * @return Backend
+ */
+async_io_backend_t async_io_backend(const async_io_t* io);
+
+/**
+ * Name of a backend for reports
+ * @param backend Backend
+ * @return Static name string
+ */
+const char* async_io_backend_name(async_io_backend_t backend);
+
+/**
+ * Read len bytes at offset into buf asynchronously. Blocks only while depth
+ * requests are already in flight. The event is always fulfilled, after
+ * *result was written, also when the submission fails.
+ * @param io Engine
+ * @param fd File to read
+ * @param buf Destination, untouched by the caller until the event is fulfilled
+ * @param len Bytes to read
+ * @param offset File offset
+ * @param result Bytes read, or -errno
+ * @param event Event of the detached task waiting for the data
+ * @return 0 if the request was submitted, -1 if it failed right away
+ */
+int async_io_read(async_io_t* io, int fd, void* buf, size_t len, off_t offset,
+                  ssize_t* result, omp_event_handle_t event);
+
+/**
+ * Write len bytes of buf at offset asynchronously, see async_io_read()
+ * @param io Engine
+ * @param fd File to write
+ * @param buf Source, kept alive until the event is fulfilled
+ * @param len Bytes to write
+ * @param offset File offset
+ * @param result Bytes written, or -errno
+ * @param event Event of the detached task waiting for the write
+ * @return 0 if the request was submitted, -1 if it failed right away
+ */
+int async_io_write(async_io_t* io, int fd, const void* buf, size_t len, off_t offset,
+                   ssize_t* result, omp_event_handle_t event);
+
+#endif // ASYNC_IO_H
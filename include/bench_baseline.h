@@ -0,0 +1,64 @@
+#ifndef BENCH_BASELINE_H
+#define BENCH_BASELINE_H
+
+#include <stdio.h>
+#include "bench_harness.h"
+
+/**
+ * Baseline storage and regression detection for the benchmark harness.
+ *
+ * BENCH_BASELINE=save stores the raw samples of every case of a suite under
+ * BENCH_BASELINE_DIR/<machine fingerprint>/<suite>.csv (default directory
+ * "baselines"). BENCH_BASELINE=compare tests every case against the stored
+ * samples with a one-sided Mann-Whitney U test; a case regresses when the
+ * slowdown is significant (p < BENCH_ALPHA, default 0.01) and its median grew
+ * by more than the noise-aware threshold: the larger of BENCH_REGRESSION_THRESHOLD
+ * (default 0.05) and the baseline's relative interquartile range.
+ *
+ * The reporter drives this module; programs only see the number of
+ * regressions returned by bench_report_end().
+ */
+
+typedef enum {
+    BENCH_BASELINE_OFF = 0,
+    BENCH_BASELINE_SAVE,
+    BENCH_BASELINE_COMPARE
+} bench_baseline_mode_t;
+
+/**
+ * One-sided Mann-Whitney U test (normal approximation with tie and
+ * continuity correction)
+ * @param a First sample set
+ * @param na Size of a
+ * @param b Second sample set
+ * @param nb Size of b
+ * @return p-value for the hypothesis that values in a tend to be larger than in b
+ */
+double bench_mann_whitney_p(const double* a, int na, const double* b, int nb);
+
+/**
+ * Mode selected by BENCH_BASELINE (save, compare, anything else is off)
+ * @return Active baseline mode
+ */
+bench_baseline_mode_t bench_baseline_mode(void);
+
+/**
+ * Start collecting results for a suite
+ * @param suite Suite name, used as the baseline file name
+ */
+void bench_baseline_begin(const char* suite);
+
+/**
+ * Record one case (samples are copied)
+ * @param result Case statistics and raw samples
+ */
+void bench_baseline_add(const bench_result_t* result);
+
+/**
+ * Save the baseline or print the comparison report
+ * @param out Stream for the comparison report
+ * @return Number of regressed cases (0 when saving or disabled)
+ */
+int bench_baseline_end(FILE* out);
+
+#endif // BENCH_BASELINE_H
@@ -0,0 +1,160 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <stdio.h>
+#include "perf_counters.h"
+
+#define BENCH_NAME_LEN 64
+
+// Output formats understood by the reporter (selected with BENCH_FORMAT)
+typedef enum {
+    BENCH_FORMAT_TEXT = 0,
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON
+} bench_format_t;
+
+/**
+ * Repetition policy for a benchmark case.
+ * Every field can be overridden from the environment, see bench_config_default().
+ */
+typedef struct {
+    int warmup_runs;        // Untimed runs before measuring
+    int min_runs;           // Always take at least this many samples
+    int max_runs;           // Never take more than this many samples
+    double max_time;        // Stop adding samples after this many seconds
+    double target_rel_ci;   // Stop once the 95% CI half-width / mean drops below this
+    double outlier_k;       // Tukey fence factor for outlier rejection (0 disables)
+    int counters;           // Collect hardware counters during the timed runs
+} bench_config_t;
+
+/**
+ * Summary statistics of one benchmark case.
+ * Statistics are computed over the samples kept after outlier rejection.
+ */
+typedef struct {
+    char name[BENCH_NAME_LEN];
+    int threads;            // omp_get_max_threads() when the case ran
+    long size;              // Problem size (elements), 0 if not meaningful
+    int runs;               // Samples taken
+    int kept;               // Samples left after outlier rejection
+    int converged;          // 1 if target_rel_ci was reached
+    double mean;
+    double median;
+    double min;
+    double max;
+    double p95;
+    double stddev;
+    double ci95;            // Half-width of the 95% confidence interval of the mean
+    double* samples;        // All raw samples in run order (owned, see bench_result_free)
+    int has_counters;       // 1 if hardware counters were collected
+    perf_values_t counters; // Summed over threads, averaged per timed run
+    perf_values_t* thread_counters; // Per thread, averaged per timed run (owned)
+} bench_result_t;
+
+typedef void (*bench_fn_t)(void* arg);
+
+/**
+ * Fill a configuration with defaults, then apply BENCH_WARMUP, BENCH_MIN_RUNS,
+ * BENCH_MAX_RUNS, BENCH_MAX_TIME, BENCH_TARGET_CI, BENCH_OUTLIER_K and
+ * BENCH_COUNTERS (0 disables hardware counters) overrides
+ * @param config Configuration to initialize
+ */
+void bench_config_default(bench_config_t* config);
+
+/**
+ * Time fn(arg) with warm-up and adaptive repetition
+ * @param config Repetition policy (NULL for defaults)
+ * @param name Case name used in reports
+ * @param size Problem size recorded in the result
+ * @param fn Function to benchmark
+ * @param arg Argument passed to fn
+ * @param result Output statistics; release with bench_result_free()
+ * @return 0 on success, -1 on allocation failure
+ */
+int bench_run(const bench_config_t* config, const char* name, long size,
+              bench_fn_t fn, void* arg, bench_result_t* result);
+
+/**
+ * Compute statistics from a set of samples (the samples are copied)
+ * @param samples Raw samples
+ * @param n Number of samples
+ * @param outlier_k Tukey fence factor, 0 keeps every sample
+ * @param result Output statistics (name/threads/size are left untouched)
+ * @return 0 on success, -1 on allocation failure
+ */
+int bench_stats_compute(const double* samples, int n, double outlier_k, bench_result_t* result);
+
+/**
+ * Release the samples and per-thread counters owned by a result
+ * @param result Result to release
+ */
+void bench_result_free(bench_result_t* result);
+
+/**
+ * Problem size for a benchmark: BENCH_SIZE if set, else default_size. With
+ * BENCH_WEAK_SCALING=1 the size is scaled by threads^(1/work_exponent) so the
+ * total work grows linearly with omp_get_max_threads() (weak scaling)
+ * @param default_size Size used when BENCH_SIZE is not set
+ * @param work_exponent Work grows as size^work_exponent (1 for streaming kernels, 3 for GEMM)
+ * @return Problem size to use
+ */
+long bench_problem_size(long default_size, int work_exponent);
+
+/**
+ * Describe where the threads of a team of omp_get_max_threads() threads
+ * actually run, using sched_getcpu() and the OpenMP place they are bound to
+ * @param buf Output list of "thread:cpu@place" entries (place -1 when unbound)
+ * @param len Size of buf
+ * @param distinct_cpus Number of different CPUs the team ran on (may be NULL)
+ * @return 1 if every thread runs on a CPU of its place, 0 if one does not,
+ *         -1 if the threads are not bound to places
+ */
+int bench_placement(char* buf, size_t len, int* distinct_cpus);
+
+/**
+ * Identify the machine a result belongs to: a hash of the CPU model, the
+ * number of processors and the compiler version
+ * @param buf Output hex fingerprint (at least 17 bytes)
+ * @param len Size of buf
+ * @param description Output of the hashed text (may be NULL)
+ * @param description_len Size of description
+ */
+void bench_fingerprint(char* buf, size_t len, char* description, size_t description_len);
+
+/**
+ * Start a report for a suite of cases. Format comes from BENCH_FORMAT
+ * (text, csv, json) and output goes to BENCH_OUTPUT or stdout.
+ * Text reports are preceded by the run metadata (including the verified
+ * thread placement and the machine fingerprint); CSV and JSON embed it.
+ * @param suite Suite name (usually the program name)
+ */
+void bench_report_begin(const char* suite);
+
+/**
+ * Append one case to the current report
+ * @param result Statistics of the case
+ */
+void bench_report_result(const bench_result_t* result);
+
+/**
+ * Finish the current report and close BENCH_OUTPUT if it was opened.
+ * With BENCH_BASELINE=save the samples of the suite are stored as a baseline,
+ * with BENCH_BASELINE=compare they are checked against it (see bench_baseline.h)
+ * @return Number of cases that regressed against the baseline
+ */
+int bench_report_end(void);
+
+/**
+ * Format selected for the current report
+ * @return Active output format
+ */
+bench_format_t bench_report_format(void);
+
+/**
+ * Stream that free-form diagnostics should go to so they don't corrupt
+ * machine-readable output (stderr for CSV/JSON on stdout, stdout otherwise)
+ * @return Stream for human-readable messages
+ */
+FILE* bench_log_stream(void);
+
+#endif // BENCH_HARNESS_H
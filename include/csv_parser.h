@@ -0,0 +1,72 @@
+#ifndef CSV_PARSER_H
+#define CSV_PARSER_H
+
+#include <stddef.h>
+
+#define CSV_MAX_COLUMNS 256
+
+/**
+ * Parallel parser for numeric CSV/text files.
+ *
+ * The input (an mmapped file or a buffer) is cut into one part per thread at
+ * newline boundaries with mmap_file_split_lines(). A first parallel pass counts
+ * the rows of every part, a prefix sum turns the counts into row offsets, and
+ * a second pass parses every part straight into its rows of the column arrays:
+ * no intermediate copies and no locks.
+ *
+ * Numbers go through csv_parse_double(): exact for up to 19 significant
+ * digits by the Clinger fast path or the Eisel-Lemire algorithm (a 128-bit
+ * multiplication by a truncated power of five), with strtod() as the fallback
+ * for longer mantissas. Results are correctly rounded, bit-identical to strtod().
+ *
+ * Rows are lines; '\r' before '\n' and blank lines are ignored. Every row
+ * holds the number of fields of the first line, missing or unparsable fields
+ * are stored as NaN and counted in bad_fields, extra fields are ignored.
+ * Quoted fields are not supported.
+ */
+
+typedef struct {
+    int columns;
+    long rows;
+    double** data;          // data[c]: rows values of column c, 64-byte aligned
+    char** names;           // Header fields, NULL without a header line
+    long bad_fields;        // Fields stored as NaN
+} csv_table_t;
+
+/**
+ * Parse one decimal floating-point number ([+-]digits[.digits][(e|E)[+-]digits])
+ * @param p Start of the number, no leading whitespace
+ * @param end End of the buffer; the text need not be NUL-terminated
+ * @param value Output value, correctly rounded
+ * @return Pointer past the number, or NULL if p does not start a number
+ */
+const char* csv_parse_double(const char* p, const char* end, double* value);
+
+/**
+ * Parse CSV text from memory in parallel
+ * @param data Text, need not be NUL-terminated
+ * @param size Bytes of text
+ * @param delimiter Field separator (',', ';', '\t', ' ', ...)
+ * @param has_header The first line holds column names
+ * @param table Output table; release with csv_table_free()
+ * @return 0 on success, -1 on error (no columns, too many columns, out of memory)
+ */
+int csv_parse_buffer(const char* data, size_t size, char delimiter, int has_header, csv_table_t* table);
+
+/**
+ * Map a file and parse it in parallel, see csv_parse_buffer()
+ * @param path File to parse
+ * @param delimiter Field separator
+ * @param has_header The first line holds column names
+ * @param table Output table; release with csv_table_free()
+ * @return 0 on success, -1 on error
+ */
+int csv_parse_file(const char* path, char delimiter, int has_header, csv_table_t* table);
+
+/**
+ * Release the columns and names of a table
+ * @param table Table to release
+ */
+void csv_table_free(csv_table_t* table);
+
+#endif // CSV_PARSER_H
@@ -0,0 +1,50 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <stddef.h>
+
+#define EXTERNAL_SORT_DEFAULT_BUDGET ((size_t)256 << 20)
+
+/**
+ * Out-of-core sort of float64 array files (include/array_file.h) larger
+ * than memory, in two phases:
+ *
+ *   Runs   The input is read in runs of a third of the memory budget. A
+ *          chain of tasks per run (detached async_io read, parallel_sort_tasks,
+ *          detached async_io write to a temporary run file) overlaps the
+ *          read of run i+1 and the spill of run i-1 with the sort of run i;
+ *          the dependences on the two run buffers order the chains.
+ *   Merge  Splitters sampled from the sorted runs cut the output into
+ *          independent partitions. Each partition is a k-way heap merge of
+ *          its slice of every run, read in blocks with the next block of
+ *          each run prefetched by the kernel (POSIX_FADV_WILLNEED) while the
+ *          current one is merged; partitions are merged in parallel.
+ *
+ * The output is an array file of the same shape with chunk checksums
+ * (computed as the partitions write whole chunks).
+ */
+
+typedef struct {
+    size_t memory_budget;   // Bytes for run and merge buffers (0: EXTERNAL_SORT_DEFAULT_BUDGET)
+    const char* tmp_dir;    // Directory of the run file (NULL: $TMPDIR, else /tmp)
+} external_sort_config_t;
+
+typedef struct {
+    long runs;
+    int partitions;
+    double run_seconds;     // Read, sort and spill of every run
+    double merge_seconds;   // Merge and output checksums
+} external_sort_stats_t;
+
+/**
+ * Sort a float64 array file into a new array file
+ * @param input Array file of ARRAY_FLOAT64 elements, any shape (sorted as a flat array)
+ * @param output Output file, replaced
+ * @param config Budget and temporary directory, NULL for the defaults
+ * @param stats Output phase statistics, may be NULL
+ * @return 0 on success, -1 on error
+ */
+int external_sort_file(const char* input, const char* output, const external_sort_config_t* config,
+                       external_sort_stats_t* stats);
+
+#endif // EXTERNAL_SORT_H
@@ -0,0 +1,153 @@
+#ifndef LOOP_PROFILE_H
+#define LOOP_PROFILE_H
+
+#include <stdio.h>
+#include <omp.h>
+
+#define LOOP_PROFILE_NAME_LEN 64
+
+/**
+ * Per-thread load-balance instrumentation for worksharing loops.
+ *
+ * An existing loop is instrumented in place, keeping its own schedule clause:
+ *
+ *     #pragma omp parallel
+ *     {
+ *         loop_profile_thread_begin(profile);
+ *         #pragma omp for schedule(dynamic, 1000) nowait
+ *         for (int i = 0; i < n; i++) {
+ *             loop_profile_iteration(profile, i);
+ *             ...
+ *         }
+ *         loop_profile_thread_end(profile);
+ *     }
+ *
+ * Every hook accepts a NULL profile and then does nothing, so the same loop
+ * can be timed without instrumentation. Loops written as a body function can
+ * use loop_profile_for() instead.
+ *
+ * Busy time runs from loop_profile_thread_begin() to the last iteration of the
+ * thread, idle time is the wait at the barrier in loop_profile_thread_end().
+ * A chunk is a run of consecutive iterations, so two adjacent chunks handed to
+ * the same thread are counted once.
+ */
+
+// Counters of one thread, padded to a cache line so threads don't share lines
+typedef struct {
+    double start;       // omp_get_wtime() when the thread entered the loop
+    double finish;      // After its last iteration
+    double released;    // After the closing barrier
+    long iterations;
+    long chunks;
+    long next;          // Iteration that would continue the current chunk
+} __attribute__((aligned(64))) loop_thread_stats_t;
+
+typedef struct {
+    char name[LOOP_PROFILE_NAME_LEN];
+    int capacity;               // Threads the profile has room for
+    int threads;                // Team size of the last profiled loop
+    loop_thread_stats_t* stats; // One entry per thread (owned)
+} loop_profile_t;
+
+// Imbalance metrics derived from the per-thread counters
+typedef struct {
+    int threads;
+    double wall;            // First start to last release, seconds
+    double busy_max;
+    double busy_mean;
+    double busy_min;
+    double imbalance;       // busy_max / busy_mean, 1.0 is perfectly balanced
+    double idle_fraction;   // Share of thread time spent waiting at the barrier
+    long iterations;
+    long chunks;
+} loop_profile_summary_t;
+
+/**
+ * Prepare a profile for loops of up to omp_get_max_threads() threads
+ * @param profile Profile to initialize
+ * @param name Label used when printing
+ * @return 0 on success, -1 on allocation failure
+ */
+int loop_profile_init(loop_profile_t* profile, const char* name);
+
+/**
+ * Release the per-thread counters of a profile
+ * @param profile Profile to release
+ */
+void loop_profile_free(loop_profile_t* profile);
+
+/**
+ * Reset the counters of the calling thread; call inside the parallel region
+ * before the worksharing loop
+ * @param profile Profile to record into (NULL disables)
+ */
+void loop_profile_thread_begin(loop_profile_t* profile);
+
+/**
+ * Record the end of the calling thread's share and wait for the team; call
+ * after a nowait worksharing loop
+ * @param profile Profile to record into (NULL disables)
+ */
+void loop_profile_thread_end(loop_profile_t* profile);
+
+/**
+ * Count one iteration executed by the calling thread
+ * @param profile Profile to record into (NULL disables)
+ * @param i Iteration index
+ */
+static inline void loop_profile_iteration(loop_profile_t* profile, long i) {
+    if (!profile) return;
+    int t = omp_get_thread_num();
+    if (t >= profile->capacity) return;
+
+    loop_thread_stats_t* s = &profile->stats[t];
+    if (i != s->next) s->chunks++;
+    s->next = i + 1;
+    s->iterations++;
+}
+
+/**
+ * Count a chunk of iterations [begin, end) executed by the calling thread,
+ * for loops that hand out ranges instead of single iterations
+ * @param profile Profile to record into (NULL disables)
+ * @param begin First iteration of the chunk
+ * @param end One past the last iteration
+ */
+static inline void loop_profile_chunk(loop_profile_t* profile, long begin, long end) {
+    if (!profile) return;
+    int t = omp_get_thread_num();
+    if (t >= profile->capacity) return;
+
+    loop_thread_stats_t* s = &profile->stats[t];
+    if (begin != s->next) s->chunks++;
+    s->next = end;
+    s->iterations += end - begin;
+}
+
+/**
+ * Run body(i, arg) for i in [0, n) as a profiled parallel loop
+ * @param profile Profile to record into (NULL runs the loop uninstrumented)
+ * @param n Number of iterations
+ * @param kind Schedule kind (omp_sched_static, omp_sched_dynamic, ...)
+ * @param chunk Chunk size, 0 for the schedule's default
+ * @param body Loop body
+ * @param arg Argument passed to body
+ */
+void loop_profile_for(loop_profile_t* profile, long n, omp_sched_t kind, int chunk,
+                      void (*body)(long i, void* arg), void* arg);
+
+/**
+ * Compute imbalance metrics for the last profiled loop
+ * @param profile Profile to summarize
+ * @param summary Output metrics
+ */
+void loop_profile_summarize(const loop_profile_t* profile, loop_profile_summary_t* summary);
+
+/**
+ * Print per-thread counters and imbalance metrics
+ * @param out Output stream
+ * @param profile Profile to print
+ */
+void loop_profile_print(FILE* out, const loop_profile_t* profile);
+
+#endif // LOOP_PROFILE_H
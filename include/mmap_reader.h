@@ -0,0 +1,97 @@
+#ifndef MMAP_READER_H
+#define MMAP_READER_H
+
+#include <stddef.h>
+
+/**
+ * Read-only memory-mapped input files handed out as zero-copy views.
+ *
+ * Instead of read() into a malloc'ed buffer per chunk, the whole file is
+ * mapped once and tasks receive (pointer, size) views into the mapping:
+ *
+ *     mmap_file_t* f = mmap_file_open(path, MMAP_SEQUENTIAL | MMAP_PREFAULT);
+ *     mmap_view_t views[64];
+ *     long n = mmap_file_views(f, 1 << 22, views, 64);
+ *     for (long i = 0; i < n; i++) {
+ *         #pragma omp task firstprivate(i)
+ *         process(views[i].data, views[i].size);
+ *     }
+ *
+ * Pages are faulted in on first touch. With a cold page cache every fault
+ * waits for the disk, so the open flags can fault the file in up front:
+ * MAP_POPULATE in the kernel (one thread), or MMAP_PREFAULT touching one byte
+ * per page from every OpenMP thread so the faults are served in parallel.
+ * The views stay valid until mmap_file_close().
+ */
+
+typedef enum {
+    MMAP_POPULATE = 1,      // MAP_POPULATE: the kernel faults every page in during open
+    MMAP_SEQUENTIAL = 2,    // MADV_SEQUENTIAL: aggressive read-ahead, pages dropped after use
+    MMAP_WILLNEED = 4,      // MADV_WILLNEED: start asynchronous read-ahead of the whole file
+    MMAP_PREFAULT = 8       // Fault every page in with mmap_file_prefault() during open
+} mmap_flags_t;
+
+typedef struct {
+    const char* data;       // Mapping of the whole file (NULL for an empty file)
+    size_t size;            // File size in bytes
+    int fd;
+} mmap_file_t;
+
+// A zero-copy piece of a mapped file
+typedef struct {
+    const char* data;
+    size_t size;
+    size_t offset;          // Position of data in the file
+} mmap_view_t;
+
+/**
+ * Map a file read-only
+ * @param path File to map
+ * @param flags Bitwise OR of mmap_flags_t values, 0 for a plain mapping
+ * @return Mapped file, or NULL if the file cannot be opened or mapped
+ */
+mmap_file_t* mmap_file_open(const char* path, int flags);
+
+/**
+ * Unmap and close a file; its views become invalid
+ * @param file File to close
+ */
+void mmap_file_close(mmap_file_t* file);
+
+/**
+ * Touch one byte of every page in parallel (omp parallel for) so page faults
+ * and disk reads of a cold file overlap across threads
+ * @param file Mapped file
+ * @return Number of pages touched
+ */
+long mmap_file_prefault(const mmap_file_t* file);
+
+/**
+ * Cut the file into views of chunk_size bytes (the last one may be shorter)
+ * @param file Mapped file
+ * @param chunk_size Bytes per view
+ * @param views Output views (may be NULL to count them)
+ * @param max_views Room in views
+ * @return Number of views the file needs; only the first max_views are written
+ */
+long mmap_file_views(const mmap_file_t* file, size_t chunk_size, mmap_view_t* views, long max_views);
+
+/**
+ * Cut the file into parts views of about equal size, each ending just after
+ * a newline (or at the end of the file), so no line is split between views.
+ * Views can be empty when lines are longer than size / parts.
+ * @param file Mapped file
+ * @param parts Number of views
+ * @param views Output views (parts entries)
+ */
+void mmap_file_split_lines(const mmap_file_t* file, int parts, mmap_view_t* views);
+
+/**
+ * Drop the file's pages from the page cache so the next access reads from
+ * disk (posix_fadvise DONTNEED; dirty pages are written back first)
+ * @param path File to evict
+ * @return 0 on success, -1 on error
+ */
+int mmap_file_evict(const char* path);
+
+#endif // MMAP_READER_H
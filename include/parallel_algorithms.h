@@ -27,4 +27,13 @@ void parallel_transform(const double* in, double* out, int size, double (*func)(
  */
 void parallel_sort(double* arr, int size);
 
+/**
+ * Sort as a tree of OpenMP tasks from inside a parallel region (e.g. from
+ * a task), so the sort can overlap other tasks such as I/O
+ * @param arr Array to sort, sorted in place
+ * @param temp Scratch space of size elements, contents undefined afterwards
+ * @param size Array size
+ */
+void parallel_sort_tasks(double* arr, double* temp, int size);
+
 #endif // PARALLEL_ALGORITHMS_H
@@ -0,0 +1,74 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#define PERF_MAX_THREADS 256
+
+// Hardware events collected for every thread of the team
+typedef enum {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_NUM_EVENTS
+} perf_event_id_t;
+
+// Event counts; a negative entry means the event could not be counted
+typedef struct {
+    double count[PERF_NUM_EVENTS];
+} perf_values_t;
+
+/**
+ * One file descriptor per (thread, event). Counters are opened from inside a
+ * parallel region so that every OpenMP worker thread counts itself; later
+ * parallel regions with the same team size reuse the same pool threads.
+ */
+typedef struct {
+    int num_threads;
+    int available;          // Number of (thread, event) counters that opened
+    int fds[PERF_MAX_THREADS][PERF_NUM_EVENTS];
+    char error[128];        // Why counters are unavailable, if they are
+} perf_session_t;
+
+/**
+ * Open counters for every thread of a team of num_threads threads
+ * @param session Session to initialize
+ * @param num_threads Team size (capped at PERF_MAX_THREADS)
+ * @return Number of counters opened; 0 means counters are unavailable
+ *         (session->error says why) and the other calls become no-ops
+ */
+int perf_session_open(perf_session_t* session, int num_threads);
+
+/**
+ * Enable counting on all threads (counts accumulate across start/stop pairs)
+ * @param session Open session
+ */
+void perf_session_start(perf_session_t* session);
+
+/**
+ * Disable counting on all threads
+ * @param session Open session
+ */
+void perf_session_stop(perf_session_t* session);
+
+/**
+ * Read accumulated counts, scaled for multiplexing
+ * @param session Open session
+ * @param per_thread Array of session->num_threads entries, or NULL
+ * @param total Sum over all threads, or NULL
+ */
+void perf_session_read(perf_session_t* session, perf_values_t* per_thread, perf_values_t* total);
+
+/**
+ * Close every counter of the session
+ * @param session Session to close
+ */
+void perf_session_close(perf_session_t* session);
+
+/**
+ * Short name of an event, as used in report columns
+ * @param id Event id
+ * @return Event name
+ */
+const char* perf_event_name(int id);
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,144 @@
+#ifndef REDUCE_STATE_H
+#define REDUCE_STATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Mergeable reduction states for data that arrives in chunks.
+ *
+ * Instead of re-reducing everything seen so far, keep a state per stream,
+ * fold every new chunk into it with *_update() (parallel over the chunk,
+ * partials merged in thread order, so a fixed thread count gives the same
+ * bits every time) and combine states from other threads, files or
+ * processes with *_merge():
+ *
+ *     reduce_stats_t total, part;
+ *     reduce_stats_init(&total);
+ *     while (read_chunk(buf, &n)) reduce_stats_update(&total, buf, n);
+ *     reduce_stats_merge(&total, &part);      // e.g. a state from another file
+ *
+ * reduce_sum_t and reduce_stats_t are plain structs: they can be stored or
+ * sent as bytes between processes of the same architecture. A histogram is
+ * its binning plus the counts array.
+ *
+ * NaN inputs are skipped and counted by reduce_stats_t; histograms ignore them.
+ */
+
+// Compensated (Kahan-Babuska-Neumaier) sum: the result is sum + compensation
+typedef struct {
+    double sum;
+    double compensation;    // Low-order bits lost by sum
+} reduce_sum_t;
+
+// Count, compensated sum, min/max and mean/variance (Chan et al. pairwise update)
+typedef struct {
+    uint64_t count;         // Values other than NaN
+    uint64_t nans;
+    reduce_sum_t sum;
+    double min;             // +inf / -inf while empty
+    double max;
+    double mean;
+    double m2;              // Sum of squared deviations from the mean
+} reduce_stats_t;
+
+// Fixed-width bins over [lo, hi)
+typedef struct {
+    double lo;
+    double hi;
+    int bins;
+    uint64_t* counts;
+    uint64_t below;         // Values < lo
+    uint64_t above;         // Values >= hi
+} reduce_hist_t;
+
+/**
+ * Start an empty sum
+ * @param s State to initialize
+ */
+void reduce_sum_init(reduce_sum_t* s);
+
+/**
+ * Add a chunk of values to a sum
+ * @param s State
+ * @param x Values
+ * @param n Number of values
+ */
+void reduce_sum_update(reduce_sum_t* s, const double* x, size_t n);
+
+/**
+ * Add the sum of another state
+ * @param into State receiving the other one
+ * @param from State to add
+ */
+void reduce_sum_merge(reduce_sum_t* into, const reduce_sum_t* from);
+
+/**
+ * Current value of a sum
+ * @param s State
+ * @return sum + compensation
+ */
+double reduce_sum_value(const reduce_sum_t* s);
+
+/**
+ * Start empty statistics
+ * @param s State to initialize
+ */
+void reduce_stats_init(reduce_stats_t* s);
+
+/**
+ * Fold a chunk of values into the statistics (two passes over each thread's slice)
+ * @param s State
+ * @param x Values
+ * @param n Number of values
+ */
+void reduce_stats_update(reduce_stats_t* s, const double* x, size_t n);
+
+/**
+ * Combine two states as if all values had gone into one
+ * @param into State receiving the other one
+ * @param from State to combine
+ */
+void reduce_stats_merge(reduce_stats_t* into, const reduce_stats_t* from);
+
+/**
+ * Variance of the values seen so far
+ * @param s State
+ * @param ddof Delta degrees of freedom: 0 population, 1 sample variance
+ * @return m2 / (count - ddof), NaN if count <= ddof
+ */
+double reduce_stats_variance(const reduce_stats_t* s, int ddof);
+
+/**
+ * Set up an empty histogram
+ * @param h State to initialize
+ * @param lo Lower edge of the first bin
+ * @param hi Upper edge of the last bin, > lo
+ * @param bins Number of bins, > 0
+ * @return 0 on success, -1 on invalid arguments or out of memory
+ */
+int reduce_hist_init(reduce_hist_t* h, double lo, double hi, int bins);
+
+/**
+ * Count a chunk of values (per-thread bins, summed at the end)
+ * @param h State
+ * @param x Values
+ * @param n Number of values
+ */
+void reduce_hist_update(reduce_hist_t* h, const double* x, size_t n);
+
+/**
+ * Add the counts of a histogram with the same binning
+ * @param into State receiving the counts
+ * @param from State to add
+ * @return 0 on success, -1 if the binnings differ
+ */
+int reduce_hist_merge(reduce_hist_t* into, const reduce_hist_t* from);
+
+/**
+ * Release the counts of a histogram
+ * @param h State to release
+ */
+void reduce_hist_free(reduce_hist_t* h);
+
+#endif // REDUCE_STATE_H
@@ -0,0 +1,135 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stddef.h>
+
+/**
+ * Bounded lock-free ring buffers of pointers for passing work between threads.
+ *
+ * ring_spsc_t has exactly one producer and one consumer thread. Each side
+ * keeps a cached copy of the other side's index, so it only touches the
+ * other side's cache line when the ring looks full (or empty).
+ *
+ * ring_mpmc_t accepts any number of producers and consumers (Vyukov's
+ * bounded queue): every cell carries a sequence number telling whether it is
+ * free or holds an item for a given lap, so a push or pop is a single CAS on
+ * the shared index.
+ *
+ * Both rings round the capacity up to a power of two, keep the producer and
+ * consumer indices on separate cache lines, and move several items per index
+ * update with the batch calls. A push never blocks: it returns 0 (or a short
+ * count) when the ring is full, and pop does the same when it is empty.
+ */
+
+typedef struct ring_spsc ring_spsc_t;
+typedef struct ring_mpmc ring_mpmc_t;
+
+/**
+ * Create a single-producer single-consumer ring
+ * @param capacity Minimum number of items (rounded up to a power of two)
+ * @return New ring, or NULL on allocation failure
+ */
+ring_spsc_t* ring_spsc_create(size_t capacity);
+
+/**
+ * Release a ring
+ * @param ring Ring to destroy
+ */
+void ring_spsc_destroy(ring_spsc_t* ring);
+
+/**
+ * Append one item; producer thread only
+ * @param ring Ring
+ * @param item Item to append
+ * @return 1 on success, 0 if the ring is full
+ */
+int ring_spsc_push(ring_spsc_t* ring, void* item);
+
+/**
+ * Remove the oldest item; consumer thread only
+ * @param ring Ring
+ * @param item Output item
+ * @return 1 on success, 0 if the ring is empty
+ */
+int ring_spsc_pop(ring_spsc_t* ring, void** item);
+
+/**
+ * Append up to n items in order with a single index update; producer thread only
+ * @param ring Ring
+ * @param items Items to append
+ * @param n Number of items
+ * @return Number of items appended (less than n when the ring filled up)
+ */
+size_t ring_spsc_push_batch(ring_spsc_t* ring, void* const* items, size_t n);
+
+/**
+ * Remove up to max items in order with a single index update; consumer thread only
+ * @param ring Ring
+ * @param items Output items
+ * @param max Room in items
+ * @return Number of items removed
+ */
+size_t ring_spsc_pop_batch(ring_spsc_t* ring, void** items, size_t max);
+
+/**
+ * Number of items a ring holds at most
+ * @param ring Ring
+ * @return Capacity after rounding
+ */
+size_t ring_spsc_capacity(const ring_spsc_t* ring);
+
+/**
+ * Create a multi-producer multi-consumer ring
+ * @param capacity Minimum number of items (rounded up to a power of two, at least 2)
+ * @return New ring, or NULL on allocation failure
+ */
+ring_mpmc_t* ring_mpmc_create(size_t capacity);
+
+/**
+ * Release a ring
+ * @param ring Ring to destroy
+ */
+void ring_mpmc_destroy(ring_mpmc_t* ring);
+
+/**
+ * Append one item; any thread
+ * @param ring Ring
+ * @param item Item to append
+ * @return 1 on success, 0 if the ring is full
+ */
+int ring_mpmc_push(ring_mpmc_t* ring, void* item);
+
+/**
+ * Remove the oldest item; any thread
+ * @param ring Ring
+ * @param item Output item
+ * @return 1 on success, 0 if the ring is empty
+ */
+int ring_mpmc_pop(ring_mpmc_t* ring, void** item);
+
+/**
+ * Append up to n items as one contiguous run of cells with a single CAS
+ * @param ring Ring
+ * @param items Items to append
+ * @param n Number of items
+ * @return Number of items appended (less than n when fewer cells were free)
+ */
+size_t ring_mpmc_push_batch(ring_mpmc_t* ring, void* const* items, size_t n);
+
+/**
+ * Remove up to max items as one contiguous run of cells with a single CAS
+ * @param ring Ring
+ * @param items Output items
+ * @param max Room in items
+ * @return Number of items removed
+ */
+size_t ring_mpmc_pop_batch(ring_mpmc_t* ring, void** items, size_t max);
+
+/**
+ * Number of items a ring holds at most
+ * @param ring Ring
+ * @return Capacity after rounding
+ */
+size_t ring_mpmc_capacity(const ring_mpmc_t* ring);
+
+#endif // RING_BUFFER_H
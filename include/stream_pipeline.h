@@ -0,0 +1,132 @@
+#ifndef STREAM_PIPELINE_H
+#define STREAM_PIPELINE_H
+
+#include <stddef.h>
+
+#define STREAM_NAME_LEN 32
+#define STREAM_MAX_STAGES 16
+
+/**
+ * Streaming pipeline of stages connected by bounded lock-free queues.
+ *
+ * Data flows as fixed-size chunks from a pool allocated up front, so memory
+ * stays bounded by num_chunks * 2 * chunk_capacity however long the stream:
+ *
+ *     stream_pipeline_t* p = stream_pipeline_create(64, 1 << 20);
+ *     stream_pipeline_source(p, "read", read_chunk, &input);
+ *     stream_pipeline_add_stage(p, "parse", STREAM_PARALLEL, parse_chunk, NULL);
+ *     stream_pipeline_add_stage(p, "compute", STREAM_PARALLEL, compute_chunk, NULL);
+ *     stream_pipeline_add_stage(p, "write", STREAM_SERIAL, write_chunk, &output);
+ *     stream_pipeline_run(p);
+ *
+ * The source runs on one thread at a time and numbers the chunks. Parallel
+ * stages process any number of chunks at once, in any order. Serial stages
+ * process one chunk at a time in source order, so they can append to a file
+ * or carry state from chunk to chunk. All threads of the OpenMP team opened
+ * by stream_pipeline_run() are workers: each takes the most downstream work
+ * available, then produces new chunks when a free one exists.
+ */
+
+typedef enum {
+    STREAM_PARALLEL = 0,    // Replicated, chunks in any order
+    STREAM_SERIAL           // One chunk at a time, in source order
+} stream_stage_mode_t;
+
+typedef struct {
+    long seq;           // Position in the stream, assigned by the source
+    size_t size;        // Bytes used in data
+    size_t capacity;    // Bytes available in data and in scratch
+    char* data;
+    char* scratch;      // Spare buffer for out-of-place stages, see stream_chunk_swap()
+    long count;         // Free for the stages, e.g. records in the chunk
+} stream_chunk_t;
+
+/**
+ * Source callback: fill chunk->data and chunk->size
+ * @return 1 if a chunk was produced, 0 at the end of the stream, -1 on error
+ */
+typedef int (*stream_source_fn)(stream_chunk_t* chunk, void* arg);
+
+/**
+ * Stage callback: transform the chunk in place
+ * @return 0 on success, -1 on error
+ */
+typedef int (*stream_stage_fn)(stream_chunk_t* chunk, void* arg);
+
+// Counters of one stage (the source is stage 0) after stream_pipeline_run()
+typedef struct {
+    char name[STREAM_NAME_LEN];
+    stream_stage_mode_t mode;
+    long chunks;        // Chunks processed
+    double busy;        // Seconds spent in the callback, summed over threads
+} stream_stage_stats_t;
+
+typedef struct stream_pipeline stream_pipeline_t;
+
+/**
+ * Create a pipeline and its chunk pool
+ * @param num_chunks Chunks in flight at most (bounds memory and reordering)
+ * @param chunk_capacity Bytes of each of the two buffers of a chunk
+ * @return New pipeline, or NULL on allocation failure or bad arguments
+ */
+stream_pipeline_t* stream_pipeline_create(int num_chunks, size_t chunk_capacity);
+
+/**
+ * Release a pipeline and its chunks
+ * @param pipeline Pipeline to destroy
+ */
+void stream_pipeline_destroy(stream_pipeline_t* pipeline);
+
+/**
+ * Set the source of the stream
+ * @param pipeline Pipeline
+ * @param name Name used in the statistics
+ * @param fn Source callback, called by one thread at a time
+ * @param arg Argument passed to fn
+ */
+void stream_pipeline_source(stream_pipeline_t* pipeline, const char* name, stream_source_fn fn, void* arg);
+
+/**
+ * Append a stage after the source and the stages added before
+ * @param pipeline Pipeline
+ * @param name Name used in the statistics
+ * @param mode STREAM_PARALLEL or STREAM_SERIAL
+ * @param fn Stage callback
+ * @param arg Argument passed to fn
+ * @return 0 on success, -1 if STREAM_MAX_STAGES stages exist already
+ */
+int stream_pipeline_add_stage(stream_pipeline_t* pipeline, const char* name, stream_stage_mode_t mode,
+                              stream_stage_fn fn, void* arg);
+
+/**
+ * Stream the source through all stages with the threads of a new parallel
+ * region; returns when the source ended and every chunk left the last stage.
+ * After an error the source stops and later chunks skip the remaining
+ * callbacks. A pipeline can be run again once its source was reset.
+ * @param pipeline Pipeline
+ * @return 0 on success, -1 if the source or a stage failed
+ */
+int stream_pipeline_run(stream_pipeline_t* pipeline);
+
+/**
+ * Statistics of the last run, source first
+ * @param pipeline Pipeline
+ * @param stats Output array with room for stream_pipeline_stages() entries
+ * @return Number of entries written
+ */
+int stream_pipeline_stats(const stream_pipeline_t* pipeline, stream_stage_stats_t* stats);
+
+/**
+ * Number of stages including the source
+ * @param pipeline Pipeline
+ * @return Stage count
+ */
+int stream_pipeline_stages(const stream_pipeline_t* pipeline);
+
+/**
+ * Exchange data and scratch, for stages that write their output to scratch
+ * @param chunk Chunk
+ */
+void stream_chunk_swap(stream_chunk_t* chunk);
+
+#endif // STREAM_PIPELINE_H
@@ -0,0 +1,114 @@
+#ifndef TASK_DAG_H
+#define TASK_DAG_H
+
+/**
+ * Task graphs built at run time and executed as OpenMP tasks.
+ *
+ * depend(in:)/depend(out:) clauses written by hand (examples/task_dependencies.c)
+ * need the graph at compile time. Here nodes and edges are added through
+ * calls and task_dag_execute() maps them to tasks:
+ *
+ *     task_dag_t* dag = task_dag_create();
+ *     long a = task_dag_add_node(dag, load, &tile, 1.0);
+ *     long b = task_dag_add_node(dag, factor, &tile, 4.0);
+ *     task_dag_add_edge(dag, a, b);           // b runs after a
+ *     task_dag_execute(dag, TASK_DAG_DEPEND, 1);
+ *
+ * Two executors:
+ *   TASK_DAG_DEPEND    One task per node, created in topological order with
+ *                      depend(out:) on the node's sentinel byte and
+ *                      depend(iterator(...), in:) on its predecessors' sentinels;
+ *                      the runtime tracks the dependences.
+ *   TASK_DAG_COUNTERS  Atomic counters of unfinished predecessors: the roots
+ *                      are spawned, a finishing node spawns the successors it
+ *                      releases and runs the most critical of them itself.
+ *
+ * With priorities, every task gets priority() from its bottom level (the
+ * costliest path from the node to an exit, node included) scaled to
+ * 0..omp_get_max_task_priority(), so ready tasks on the critical path run
+ * first. OMP_MAX_TASK_PRIORITY must be set for the runtime to use them.
+ */
+
+typedef void (*task_dag_fn)(void* arg);
+
+typedef enum {
+    TASK_DAG_DEPEND = 0,
+    TASK_DAG_COUNTERS
+} task_dag_mode_t;
+
+typedef struct task_dag task_dag_t;
+
+/**
+ * Create an empty graph
+ * @return New graph, or NULL on allocation failure
+ */
+task_dag_t* task_dag_create(void);
+
+/**
+ * Release a graph
+ * @param dag Graph to destroy
+ */
+void task_dag_destroy(task_dag_t* dag);
+
+/**
+ * Add a node
+ * @param dag Graph
+ * @param fn Function run by the node's task
+ * @param arg Argument passed to fn
+ * @param cost Estimated run time in any unit, for the priorities (<= 0: 1)
+ * @return Node id (0, 1, 2, ... in insertion order), or -1 on allocation failure
+ */
+long task_dag_add_node(task_dag_t* dag, task_dag_fn fn, void* arg, double cost);
+
+/**
+ * Add a dependence: to starts after from finished
+ * @param dag Graph
+ * @param from Predecessor node
+ * @param to Successor node
+ * @return 0 on success, -1 on an unknown node, a self edge or allocation failure
+ */
+int task_dag_add_edge(task_dag_t* dag, long from, long to);
+
+/**
+ * Number of nodes
+ * @param dag Graph
+ * @return Nodes added so far
+ */
+long task_dag_num_nodes(const task_dag_t* dag);
+
+/**
+ * Bottom level of a node: the costliest path from it to an exit, node included.
+ * Tasks whose bottom level equals task_dag_critical_path() lie on the critical path
+ * @param dag Graph (analyzed on first use after a change)
+ * @param node Node id
+ * @return Bottom level in cost units, -1 for an unknown node, a cyclic graph or on allocation failure
+ */
+double task_dag_bottom_level(task_dag_t* dag, long node);
+
+/**
+ * Length of the critical path, the longest bottom level. No schedule finishes
+ * sooner, whatever the thread count
+ * @param dag Graph
+ * @return Critical path in cost units (0 for an empty graph), -1 for a cyclic graph or on allocation failure
+ */
+double task_dag_critical_path(task_dag_t* dag);
+
+/**
+ * Priority task_dag_execute() gives the node's task: its bottom level relative
+ * to the critical path, scaled to 0..omp_get_max_task_priority() and rounded
+ * @param dag Graph
+ * @param node Node id
+ * @return Priority, or -1 for an unknown node, a cyclic graph or on allocation failure
+ */
+int task_dag_priority(task_dag_t* dag, long node);
+
+/**
+ * Run every node once, each after all of its predecessors; can be called again
+ * @param dag Graph
+ * @param mode Executor
+ * @param priorities Give tasks critical-path priorities
+ * @return 0 on success, -1 if the graph has a cycle (nothing runs) or on allocation failure
+ */
+int task_dag_execute(task_dag_t* dag, task_dag_mode_t mode, int priorities);
+
+#endif // TASK_DAG_H
@@ -0,0 +1,95 @@
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include <stdatomic.h>
+
+#define WS_DEQUE_CAPACITY 4096
+
+/**
+ * Minimal fork/join work-stealing runtime.
+ *
+ * Every worker owns a Chase-Lev deque: it pushes and pops spawned tasks at
+ * the bottom, idle workers steal from the top of a randomly chosen victim.
+ * Workers are the threads of an OpenMP parallel region opened by ws_run().
+ *
+ * Tasks are strictly nested: a function joins every task it spawned, in
+ * reverse order, before it returns. That lets task descriptors live on the
+ * spawner's stack, so spawning costs no allocation:
+ *
+ *     ws_task_t left;
+ *     ws_spawn(&left, sort_half, &lo);
+ *     sort_half(&hi);
+ *     ws_join(&left);
+ *
+ * ws_join() runs the task inline when nobody stole it, otherwise it steals
+ * other work until the thief finishes it. When a deque is full the spawned
+ * task runs immediately. Spawned functions must not open parallel regions.
+ */
+
+typedef struct {
+    void (*fn)(void* arg);
+    void* arg;
+    atomic_int done;
+} ws_task_t;
+
+// Counters summed over all workers of the last ws_run()
+typedef struct {
+    long spawned;        // Tasks pushed to a deque
+    long inlined;        // Tasks run immediately because a deque was full
+    long stolen;         // Tasks taken from another worker's deque
+    long steal_attempts; // Steals tried, successful or not
+} ws_stats_t;
+
+typedef struct ws_pool ws_pool_t;
+
+/**
+ * Create a pool of workers
+ * @param num_workers Number of worker threads (omp_get_max_threads() if <= 0)
+ * @return New pool, or NULL on allocation failure
+ */
+ws_pool_t* ws_pool_create(int num_workers);
+
+/**
+ * Release a pool
+ * @param pool Pool to destroy
+ */
+void ws_pool_destroy(ws_pool_t* pool);
+
+/**
+ * Run root(arg) on worker 0 while the other workers steal its spawned tasks;
+ * returns once root returned
+ * @param pool Worker pool
+ * @param root Root task
+ * @param arg Argument passed to root
+ */
+void ws_run(ws_pool_t* pool, void (*root)(void* arg), void* arg);
+
+/**
+ * Make fn(arg) available for stealing; call from inside ws_run()
+ * @param task Task descriptor, must stay valid until ws_join(task)
+ * @param fn Task function
+ * @param arg Argument passed to fn
+ */
+void ws_spawn(ws_task_t* task, void (*fn)(void* arg), void* arg);
+
+/**
+ * Wait for a spawned task, running it inline if it was not stolen
+ * @param task Task passed to ws_spawn()
+ */
+void ws_join(ws_task_t* task);
+
+/**
+ * Counters of the last ws_run()
+ * @param pool Worker pool
+ * @param stats Output counters
+ */
+void ws_pool_stats(const ws_pool_t* pool, ws_stats_t* stats);
+
+/**
+ * Number of workers of a pool
+ * @param pool Worker pool
+ * @return Worker count
+ */
+int ws_pool_workers(const ws_pool_t* pool);
+
+#endif // WORK_STEALING_H
@@ -0,0 +1,71 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+/**
+ * Synthetic per-iteration cost profiles for irregular loops.
+ *
+ * A profile fills an array with the cost of every iteration in work units
+ * (one unit is one sin*cos evaluation in workload_execute()). Costs are
+ * scaled so their mean equals the requested mean, which keeps the total work
+ * of every profile the same, and random profiles are reproducible from the seed.
+ */
+
+typedef enum {
+    WORKLOAD_UNIFORM = 0,   // Every iteration costs the mean
+    WORKLOAD_INCREASING,    // Cost grows linearly from 0 to twice the mean
+    WORKLOAD_DECREASING,    // Cost shrinks linearly from twice the mean to 0
+    WORKLOAD_EXPONENTIAL,   // Independent exponentially distributed costs
+    WORKLOAD_ZIPF,          // Cost of the iteration of rank r is proportional to 1/r, ranks shuffled
+    WORKLOAD_BIMODAL,       // 90% light iterations, 10% ten times heavier, at random positions
+    WORKLOAD_PERIODIC,      // Every 100th iteration 10000x heavier (the scheduling_comparison pattern)
+    WORKLOAD_NUM_PROFILES
+} workload_profile_t;
+
+/**
+ * Name of a profile as accepted by workload_profile_parse()
+ * @param profile Profile
+ * @return Static name string
+ */
+const char* workload_profile_name(workload_profile_t profile);
+
+/**
+ * Look up a profile by name
+ * @param name Profile name (uniform, increasing, decreasing, exponential, zipf, bimodal, periodic)
+ * @return Profile, or -1 if the name is unknown
+ */
+int workload_profile_parse(const char* name);
+
+/**
+ * Fill cost[0..n) with a cost profile
+ * @param cost Output costs in work units
+ * @param n Number of iterations
+ * @param profile Cost profile
+ * @param mean Mean cost per iteration
+ * @param seed Seed for the random profiles
+ * @return 0 on success, -1 on allocation failure or bad arguments
+ */
+int workload_generate(double* cost, long n, workload_profile_t profile, double mean,
+                      unsigned long long seed);
+
+/**
+ * Spend cost work units (rounded to the nearest unit) of compute
+ * @param cost Work units to execute
+ * @return Result of the computation, accumulate it so it is not optimized away
+ */
+double workload_execute(double cost);
+
+/**
+ * Measure the speed of workload_execute() on this machine; the first call
+ * calibrates (about 50 ms), later calls return the cached value
+ * @return Work units executed per second
+ */
+double workload_calibrate(void);
+
+/**
+ * Busy-work for a given duration, calibrated with workload_calibrate()
+ * @param seconds Duration of compute to spend
+ * @return Result of the computation, accumulate it so it is not optimized away
+ */
+double workload_spin(double seconds);
+
+#endif // WORKLOAD_H
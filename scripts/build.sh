@@ -13,6 +13,9 @@ mkdir -p $BIN_DIR
 # Compiler options
 CC=gcc
 COMMON_FLAGS="-Wall -Wextra -fopenmp -I./include"
+# Library sources (parallel algorithms, benchmark harness) linked into every binary
+LIB_SRCS="$(ls src/*.c)"
+LIBS="-lm"
 
 if [ "$BUILD_TYPE" == "debug" ]; then
     echo "Building in DEBUG mode"
@@ -28,7 +31,7 @@ for src in examples/*.c; do
     if [ -f "$src" ]; then
         exe="$BIN_DIR/$(basename ${src%.c})"
         echo "  $src -> $exe"
-        $CC $CFLAGS $src -o $exe
+        $CC $CFLAGS $src $LIB_SRCS -o $exe $LIBS
     fi
 done
 
@@ -38,7 +41,7 @@ for src in benchmarks/*.c; do
     if [ -f "$src" ]; then
         exe="$BIN_DIR/$(basename ${src%.c})"
         echo "  $src -> $exe"
-        $CC $CFLAGS $src -o $exe
+        $CC $CFLAGS $src $LIB_SRCS -o $exe $LIBS
     fi
 done
 
@@ -49,7 +52,7 @@ if [ "$2" == "tests" ]; then
         if [ -f "$src" ]; then
             exe="$BIN_DIR/$(basename ${src%.c})"
             echo "  $src -> $exe"
-            $CC $CFLAGS $src -o $exe
+            $CC $CFLAGS $src $LIB_SRCS -o $exe $LIBS
         fi
     done
 fi
@@ -0,0 +1,53 @@
+#!/bin/bash
+
+# Script to gate changes on benchmark performance
+# Usage: ./scripts/check_regressions.sh [save|compare] [benchmark_executable...]
+#
+#   save      Store the samples of every case as the baseline for this machine
+#   compare   Test every case against the stored baseline (default)
+#
+# Baselines live in BENCH_BASELINE_DIR (default: baselines) under a fingerprint
+# of the CPU model, processor count and compiler, so results from different
+# machines are never compared. A case regresses when a one-sided Mann-Whitney U
+# test finds it slower (p < BENCH_ALPHA, default 0.01) and its median grew by
+# more than max(BENCH_REGRESSION_THRESHOLD (default 0.05), the baseline's
+# relative IQR). The script exits with status 1 if any case regressed.
+#
+# Without benchmark arguments bin/matrix_multiply and bin/stream_roofline are run.
+
+MODE=${1:-compare}
+case $MODE in
+    save|compare) shift ;;
+    *) MODE=compare ;;
+esac
+
+BENCHMARKS=("$@")
+[ ${#BENCHMARKS[@]} -eq 0 ] && BENCHMARKS=(bin/matrix_multiply bin/stream_roofline)
+
+export BENCH_BASELINE=$MODE
+export BENCH_BASELINE_DIR=${BENCH_BASELINE_DIR:-baselines}
+# Comparisons need enough samples per case for the rank test to have power
+export BENCH_MIN_RUNS=${BENCH_MIN_RUNS:-15}
+
+failed=0
+for bench in "${BENCHMARKS[@]}"; do
+    if [ ! -x "$bench" ]; then
+        echo "Error: Benchmark executable '$bench' not found."
+        echo "Run 'make benchmarks' first to build the benchmarks."
+        exit 2
+    fi
+
+    echo "Running benchmark: $bench ($MODE)"
+    "$bench"
+    status=$?
+    if [ $status -ne 0 ]; then
+        echo "  $bench: regression detected (exit status $status)"
+        failed=1
+    fi
+done
+
+if [ $failed -ne 0 ]; then
+    echo "Performance regressions found."
+    exit 1
+fi
+echo "Regression check complete!"
@@ -1,28 +1,241 @@
 #!/bin/bash
 
-# Script to run benchmarks with different thread counts
-# Usage: ./scripts/run_benchmarks.sh [benchmark_executable] [max_threads]
+# Script to run benchmarks with different thread counts and analyze scalability
+# Usage: ./scripts/run_benchmarks.sh [options] [benchmark_executable...] [max_threads]
+#
+# Options:
+#   -t N      Maximum thread count (default: nproc)
+#   -w        Weak scaling: problem size grows with the thread count
+#             (BENCH_WEAK_SCALING=1, see bench_problem_size() in include/bench_harness.h)
+#   -s SIZE   Base problem size passed as BENCH_SIZE
+#   -o DIR    Output directory (default: results/scaling-<timestamp>)
+#   -a        Affinity sweep: run every OMP_PLACES x OMP_PROC_BIND x thread count
+#             combination (threads 1, 2, 4, ..., max) and report the best
+#             configuration per case
+#
+# Without benchmark arguments every benchmark built from benchmarks/*.c is run.
+# For each benchmark the raw harness CSV of every thread count is kept, and
+# <benchmark>_scaling.csv summarizes speedup, parallel efficiency and the
+# Karp-Flatt serial fraction per case. <benchmark>_models.csv holds the least
+# squares fit of Amdahl's law (strong scaling) or Gustafson's law (weak scaling).
+# In affinity mode <benchmark>_affinity.csv lists every configuration with the
+# placement the harness observed (sched_getcpu per thread), so configurations the
+# runtime did not honor (placement_ok != 1) or that stacked threads on the same
+# CPU (distinct_cpus < threads) are visible.
 
 set -e
 
-BENCHMARK=${1:-"bin/matrix_multiply"}
-MAX_THREADS=${2:-$(nproc)}
+MAX_THREADS=$(nproc)
+MODE="strong"
+BASE_SIZE=""
+OUT_DIR="results/scaling-$(date +%Y%m%d-%H%M%S)"
 
-if [ ! -f "$BENCHMARK" ]; then
-    echo "Error: Benchmark executable '$BENCHMARK' not found."
-    echo "Run './scripts/build.sh' first to build the benchmarks."
+AFFINITY_PLACES="threads cores sockets ll_caches"
+AFFINITY_BINDS="close spread"
+
+while getopts "t:ws:o:a" opt; do
+    case $opt in
+        t) MAX_THREADS=$OPTARG ;;
+        w) MODE="weak" ;;
+        a) MODE="affinity" ;;
+        s) BASE_SIZE=$OPTARG ;;
+        o) OUT_DIR=$OPTARG ;;
+        *) sed -n '3,25p' "$0"; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+# Backwards compatible form: run_benchmarks.sh <benchmark> <max_threads>
+BENCHMARKS=()
+for arg in "$@"; do
+    if [[ "$arg" =~ ^[0-9]+$ ]]; then
+        MAX_THREADS=$arg
+    else
+        BENCHMARKS+=("$arg")
+    fi
+done
+
+if [ ${#BENCHMARKS[@]} -eq 0 ]; then
+    for src in benchmarks/*.c; do
+        exe="bin/$(basename ${src%.c})"
+        [ -x "$exe" ] && BENCHMARKS+=("$exe")
+    done
+fi
+
+if [ ${#BENCHMARKS[@]} -eq 0 ]; then
+    echo "Error: no benchmark executables found."
+    echo "Run 'make benchmarks' or './scripts/build.sh' first to build the benchmarks."
     exit 1
 fi
 
-echo "Running benchmark: $BENCHMARK"
-echo "Testing thread counts from 1 to $MAX_THREADS..."
+for bench in "${BENCHMARKS[@]}"; do
+    if [ ! -f "$bench" ]; then
+        echo "Error: Benchmark executable '$bench' not found."
+        echo "Run './scripts/build.sh' first to build the benchmarks."
+        exit 1
+    fi
+done
+
+mkdir -p "$OUT_DIR"
+export BENCH_FORMAT=csv
+[ "$MODE" == "weak" ] && export BENCH_WEAK_SCALING=1
+[ -n "$BASE_SIZE" ] && export BENCH_SIZE=$BASE_SIZE
+
+# Affinity sweep: one harness CSV per (places, bind, threads), then pick the
+# fastest configuration of every case
+run_affinity_sweep() {
+    local bench=$1 name=$2 raw_dir=$3
+    local counts=""
+    for ((t = 1; t < MAX_THREADS; t *= 2)); do counts="$counts $t"; done
+    counts="$counts $MAX_THREADS"
+
+    for places in $AFFINITY_PLACES; do
+        for bind in $AFFINITY_BINDS; do
+            for threads in $counts; do
+                echo "  OMP_PLACES=$places OMP_PROC_BIND=$bind threads=$threads"
+                OMP_PLACES=$places OMP_PROC_BIND=$bind OMP_NUM_THREADS=$threads \
+                    BENCH_OUTPUT="$raw_dir/${places}_${bind}_t$threads.csv" \
+                    "$bench" > "$raw_dir/${places}_${bind}_t$threads.log" 2>&1 || true
+            done
+        done
+    done
+
+    awk -F'"' -v summary="$OUT_DIR/${name}_affinity.csv" '
+    FNR == 1 { places = ""; bind = ""; ok = ""; distinct = "" }
+    /^# places=/ { places = substr($0, 10); next }
+    /^# proc_bind=/ { bind = substr($0, 13); next }
+    /^# placement_ok=/ { ok = substr($0, 16); next }
+    /^# distinct_cpus=/ { distinct = substr($0, 17); next }
+    /^#/ || /^name,/ || NF < 3 { next }
+    {
+        split($3, f, ",")
+        rows[++num_rows] = sprintf("\"%s\",%s,%s,%d,%.9f,%s,%s", $2, places, bind, f[2], f[8], ok, distinct)
+        if (!($2 in best) || f[8] < best[$2]) {
+            best[$2] = f[8]
+            config[$2] = sprintf("OMP_PLACES=%s OMP_PROC_BIND=%s threads=%d", places, bind, f[2])
+            verified[$2] = (ok == 1 && distinct >= f[2]) ? "verified" : \
+                           (ok == 1 ? "threads share CPUs" : "binding not honored")
+        }
+        if (!($2 in seen)) { seen[$2] = 1; order[++num_cases] = $2 }
+    }
+    END {
+        print "name,places,proc_bind,threads,median,placement_ok,distinct_cpus" > summary
+        for (i = 1; i <= num_rows; i++) print rows[i] > summary
+
+        printf "\n%-28s %12s  %s\n", "case", "best(s)", "configuration"
+        for (c = 1; c <= num_cases; c++) {
+            n = order[c]
+            printf "%-28s %12.6f  %s (%s)\n", n, best[n], config[n], verified[n]
+        }
+    }' "$raw_dir"/*.csv
+}
+
+if [ "$MODE" == "affinity" ]; then
+    echo "Affinity sweep: OMP_PLACES={$AFFINITY_PLACES} x OMP_PROC_BIND={$AFFINITY_BINDS}, threads up to $MAX_THREADS"
+else
+    echo "Scalability analysis ($MODE scaling), threads 1..$MAX_THREADS"
+fi
+echo "Results in $OUT_DIR"
 echo "-------------------------------------------"
 
-# Run with different thread counts
-for threads in $(seq 1 $MAX_THREADS); do
-    echo "Running with $threads thread(s):"
-    export OMP_NUM_THREADS=$threads
-    $BENCHMARK
+for bench in "${BENCHMARKS[@]}"; do
+    name=$(basename "$bench")
+    raw_dir="$OUT_DIR/$name"
+    mkdir -p "$raw_dir"
+
+    if [ "$MODE" == "affinity" ]; then
+        echo "Running benchmark: $bench"
+        run_affinity_sweep "$bench" "$name" "$raw_dir"
+        echo "-------------------------------------------"
+        continue
+    fi
+
+    echo "Running benchmark: $bench"
+    for threads in $(seq 1 $MAX_THREADS); do
+        echo "  $threads thread(s)"
+        # A regression or a wrong result exits 1; keep sweeping so the analysis still runs
+        if ! OMP_NUM_THREADS=$threads BENCH_OUTPUT="$raw_dir/threads_$threads.csv" \
+            "$bench" > "$raw_dir/threads_$threads.log" 2>&1; then
+            echo "  Warning: $name failed with $threads thread(s), see $raw_dir/threads_$threads.log" >&2
+        fi
+    done
+
+    # Harness CSV: "name",threads,size,runs,kept,converged,mean,median,...
+    # Names are quoted and may contain commas, so split on quotes first.
+    # Cases that fix their own thread count (e.g. task_benchmark) appear in
+    # every run; keep the fastest median per (case, threads).
+    cat "$raw_dir"/threads_*.csv | awk -F'"' -v mode="$MODE" \
+        -v summary="$OUT_DIR/${name}_scaling.csv" -v models="$OUT_DIR/${name}_models.csv" '
+    /^#/ || /^name,/ || NF < 3 { next }
+    {
+        split($3, f, ",")
+        key = $2 SUBSEP f[2]
+        if (!(key in median) || f[8] < median[key]) {
+            median[key] = f[8]; size[key] = f[3]
+        }
+        if (!($2 in seen)) { seen[$2] = 1; order[++num_cases] = $2 }
+        if (!(($2, "min") in lowest) || f[2] < lowest[$2, "min"]) lowest[$2, "min"] = f[2]
+        threads[$2, f[2]] = 1
+        if (f[2] > max_p) max_p = f[2]
+    }
+    END {
+        print "name,threads,size,median,speedup,efficiency,karp_flatt" > summary
+        print "name,model,serial_fraction,max_speedup,points" > models
+        printf "\n%-28s %7s %12s %9s %10s %10s\n", "case", "threads", "median(s)", \
+               mode == "weak" ? "scaled S" : "speedup", "efficiency", "karp-flatt"
+
+        for (c = 1; c <= num_cases; c++) {
+            n = order[c]
+            p0 = lowest[n, "min"]
+            t0 = median[n SUBSEP p0]
+            sxx = 0; sxy = 0; points = 0
+
+            for (p = p0; p <= max_p; p++) {
+                if (!((n, p) in threads)) continue
+                t = median[n SUBSEP p]
+                if (t <= 0) continue
+
+                # Strong: S = T1/Tp. Weak: work grew p-fold, S = p * T1/Tp
+                rel = p / p0
+                s = (mode == "weak") ? rel * t0 / t : t0 / t
+                e = s / rel
+                kf = (rel > 1) ? (1 / s - 1 / rel) / (1 - 1 / rel) : 0
+
+                printf "\"%s\",%d,%s,%.9f,%.4f,%.4f,%.4f\n", n, p, size[n SUBSEP p], t, s, e, kf > summary
+                if (rel > 1) {
+                    printf "%-28s %7d %12.6f %9.3f %10.3f %10.4f\n", n, p, t, s, e, kf
+                } else {
+                    printf "%-28s %7d %12.6f %9.3f %10.3f %10s\n", n, p, t, s, e, "-"
+                }
+
+                # Least squares for the serial fraction
+                if (rel > 1) {
+                    if (mode == "weak") {
+                        # Gustafson: S = p - f (p - 1)
+                        x = rel - 1; y = rel - s
+                    } else {
+                        # Amdahl: Tp/T1 = f + (1 - f)/p  =>  Tp/T1 - 1/p = f (1 - 1/p)
+                        x = 1 - 1 / rel; y = t / t0 - 1 / rel
+                    }
+                    sxx += x * x; sxy += x * y; points++
+                }
+            }
+
+            if (points > 0) {
+                frac = sxy / sxx
+                if (frac < 0) frac = 0
+                if (mode == "weak") {
+                    printf "\"%s\",gustafson,%.6f,,%d\n", n, frac, points > models
+                    printf "%-28s Gustafson fit: serial fraction %.4f\n", n, frac
+                } else {
+                    smax = (frac > 0) ? 1 / frac : "inf"
+                    printf "\"%s\",amdahl,%.6f,%s,%d\n", n, frac, smax, points > models
+                    printf "%-28s Amdahl fit: serial fraction %.4f, max speedup %s\n", n, frac, smax
+                }
+            }
+        }
+    }'
+
     echo "-------------------------------------------"
 done
 
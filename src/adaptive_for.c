@@ -0,0 +1,163 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/adaptive_for.h"
+
+#define MAX_BATCHES 64
+#define DEFAULT_CHUNK_TIME 10e-6  // ~20x the cost of grabbing a chunk
+
+// Per-thread measurements of one invocation, padded to a cache line
+typedef struct {
+    double busy;
+    long iterations;
+    long chunks;
+} __attribute__((aligned(64))) thread_measure_t;
+
+static const char* strategy_names[ADAPTIVE_NUM_STRATEGIES] = { "factoring", "tss", "awf" };
+
+const char* adaptive_strategy_name(adaptive_strategy_t strategy) {
+    if (strategy < 0 || strategy >= ADAPTIVE_NUM_STRATEGIES) return "unknown";
+    return strategy_names[strategy];
+}
+
+void adaptive_site_init(adaptive_site_t* site, const char* name, adaptive_strategy_t strategy) {
+    memset(site, 0, sizeof(*site));
+    snprintf(site->name, sizeof(site->name), "%s", name);
+    site->strategy = strategy;
+    site->target_chunk_time = DEFAULT_CHUNK_TIME;
+    site->min_chunk = 1;
+    for (int t = 0; t < ADAPTIVE_MAX_THREADS; t++) site->weight[t] = 1.0;
+}
+
+// FAC2 chunk size of every batch: half of the remaining iterations split over P threads
+static int factoring_batches(long n, int threads, long min_chunk, long* sizes) {
+    int batches = 0;
+    long remaining = n;
+    while (remaining > 0 && batches < MAX_BATCHES) {
+        long size = (remaining + 2 * threads - 1) / (2 * threads);
+        if (size < min_chunk) size = min_chunk;
+        sizes[batches++] = size;
+        remaining -= size * threads;
+    }
+    return batches;
+}
+
+// Fold the measurements of one invocation into the site's learned state
+static void learn(adaptive_site_t* site, const thread_measure_t* measure, int threads, long n) {
+    double busy = 0.0;
+    long chunks = 0;
+    for (int t = 0; t < threads; t++) {
+        busy += measure[t].busy;
+        chunks += measure[t].chunks;
+    }
+    site->last_chunks = chunks;
+
+    double iteration_time = busy / n;
+    site->iteration_time = site->invocations ? 0.5 * (site->iteration_time + iteration_time)
+                                             : iteration_time;
+    long min_chunk = site->iteration_time > 0.0
+                   ? (long)ceil(site->target_chunk_time / site->iteration_time) : 1;
+    site->min_chunk = min_chunk > 1 ? min_chunk : 1;
+
+    // AWF weights: each thread's iteration rate relative to the team average
+    double rate_sum = 0.0;
+    int measured = 0;
+    for (int t = 0; t < threads; t++) {
+        if (measure[t].busy > 0.0 && measure[t].iterations > 0) {
+            rate_sum += measure[t].iterations / measure[t].busy;
+            measured++;
+        }
+    }
+    if (measured == 0) return;
+
+    double mean_rate = rate_sum / measured;
+    double weight_sum = 0.0;
+    for (int t = 0; t < threads; t++) {
+        if (measure[t].busy > 0.0 && measure[t].iterations > 0) {
+            double w = measure[t].iterations / measure[t].busy / mean_rate;
+            site->weight[t] = site->invocations ? 0.5 * (site->weight[t] + w) : w;
+        }
+        weight_sum += site->weight[t];
+    }
+    for (int t = 0; t < threads; t++) site->weight[t] *= threads / weight_sum;
+}
+
+void adaptive_for(adaptive_site_t* site, long n, adaptive_body_t body, void* arg) {
+    if (n <= 0) return;
+
+    int threads = omp_get_max_threads();
+    if (threads > ADAPTIVE_MAX_THREADS) threads = ADAPTIVE_MAX_THREADS;
+
+    // The learned minimum must still leave work for every thread
+    long min_chunk = site->min_chunk;
+    long cap = n / (2 * threads);
+    if (min_chunk > cap) min_chunk = cap > 1 ? cap : 1;
+
+    long batch_size[MAX_BATCHES];
+    int batches = factoring_batches(n, threads, min_chunk, batch_size);
+
+    // TSS: first chunk f, last chunk l, decrement delta over N chunks
+    double first = (double)((n + 2 * threads - 1) / (2 * threads));
+    if (first < min_chunk) first = (double)min_chunk;
+    double num_chunks = ceil(2.0 * n / (first + min_chunk));
+    double delta = num_chunks > 1.0 ? (first - min_chunk) / (num_chunks - 1.0) : 0.0;
+
+    thread_measure_t* measure = (thread_measure_t*)aligned_alloc(64, threads * sizeof(thread_measure_t));
+    if (!measure) {
+        body(0, n, arg);
+        return;
+    }
+    memset(measure, 0, threads * sizeof(thread_measure_t));
+
+    long next = 0;      // First iteration not handed out yet
+    long grabbed = 0;   // Chunks handed out so far
+    double start = omp_get_wtime();
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int t = omp_get_thread_num();
+        thread_measure_t* m = &measure[t];
+        loop_profile_thread_begin(site->profile);
+
+        for (;;) {
+            long k, begin;
+            #pragma omp atomic capture
+            k = grabbed++;
+
+            long size;
+            int batch = (int)(k / threads) < batches ? (int)(k / threads) : batches - 1;
+            switch (site->strategy) {
+                case ADAPTIVE_TSS:
+                    size = (long)(first - k * delta + 0.5);
+                    break;
+                case ADAPTIVE_AWF:
+                    size = (long)(batch_size[batch] * site->weight[t] + 0.5);
+                    break;
+                default:
+                    size = batch_size[batch];
+                    break;
+            }
+            if (size < min_chunk) size = min_chunk;
+
+            #pragma omp atomic capture
+            { begin = next; next += size; }
+            if (begin >= n) break;
+
+            long end = begin + size < n ? begin + size : n;
+            double t0 = omp_get_wtime();
+            body(begin, end, arg);
+            m->busy += omp_get_wtime() - t0;
+            m->iterations += end - begin;
+            m->chunks++;
+            loop_profile_chunk(site->profile, begin, end);
+        }
+
+        loop_profile_thread_end(site->profile);
+    }
+
+    site->last_time = omp_get_wtime() - start;
+    learn(site, measure, threads, n);
+    site->invocations++;
+    free(measure);
+}
@@ -0,0 +1,272 @@
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <omp.h>
+#include "../include/array_file.h"
+
+#define ARRAY_MAGIC "OMPARRAY"
+#define ARRAY_VERSION 1
+#define ARRAY_BYTE_ORDER 0x01020304u
+#define PRIME1 0x9E3779B185EBCA87ULL
+#define PRIME2 0xC2B2AE3D27D4EB4FULL
+
+static const size_t dtype_sizes[ARRAY_NUM_DTYPES] = { 8, 4, 8, 4, 1 };
+static const char* dtype_names[ARRAY_NUM_DTYPES] = { "float64", "float32", "int64", "int32", "uint8" };
+
+size_t array_dtype_size(array_dtype_t dtype) {
+    return (unsigned)dtype < ARRAY_NUM_DTYPES ? dtype_sizes[dtype] : 0;
+}
+
+const char* array_dtype_name(array_dtype_t dtype) {
+    return (unsigned)dtype < ARRAY_NUM_DTYPES ? dtype_names[dtype] : "unknown";
+}
+
+static uint64_t rotl(uint64_t x, int r) {
+    return x << r | x >> (64 - r);
+}
+
+uint64_t array_checksum(const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t lanes[4] = { PRIME1, PRIME2, ~PRIME1, ~PRIME2 };
+
+    // Four independent lanes keep several multiplies in flight
+    size_t blocks = size / 32;
+    for (size_t b = 0; b < blocks; b++) {
+        for (int l = 0; l < 4; l++) {
+            uint64_t w;
+            memcpy(&w, p + 32 * b + 8 * l, 8);
+            lanes[l] = rotl(lanes[l] + w * PRIME2, 31) * PRIME1;
+        }
+    }
+
+    uint64_t h = (uint64_t)size * PRIME1;
+    for (int l = 0; l < 4; l++) h = rotl(h ^ lanes[l], 27) * PRIME1 + PRIME2;
+    for (size_t i = blocks * 32; i < size; i++) h = rotl(h ^ (p[i] * PRIME1), 11) * PRIME2;
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    return h;
+}
+
+static int pread_full(int fd, void* buf, size_t len, off_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = pread(fd, (char*)buf + done, len - done, offset + done);
+        if (n <= 0) return -1;
+        done += n;
+    }
+    return 0;
+}
+
+static int pwrite_full(int fd, const void* buf, size_t len, off_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = pwrite(fd, (const char*)buf + done, len - done, offset + done);
+        if (n <= 0) return -1;
+        done += n;
+    }
+    return 0;
+}
+
+static uint64_t round_up(uint64_t x, uint64_t multiple) {
+    return (x + multiple - 1) / multiple * multiple;
+}
+
+// Bytes per parallel I/O piece: the checksum chunk, or a default without checksums
+static uint64_t piece_size(const array_header_t* h) {
+    return h->chunk_size ? h->chunk_size : ARRAY_DEFAULT_CHUNK;
+}
+
+int array_header_init(array_header_t* h, array_dtype_t dtype, int ndim, const size_t* shape, size_t alignment,
+                      size_t chunk_size) {
+    size_t element = array_dtype_size(dtype);
+    if (!element || ndim < 1 || ndim > ARRAY_MAX_DIMS) return -1;
+    if (alignment == 0) alignment = ARRAY_DEFAULT_ALIGNMENT;
+    if (alignment < 8 || (alignment & (alignment - 1))) return -1;
+
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, ARRAY_MAGIC, sizeof(h->magic));
+    h->version = ARRAY_VERSION;
+    h->byte_order = ARRAY_BYTE_ORDER;
+    h->dtype = dtype;
+    h->ndim = ndim;
+    uint64_t count = 1;
+    for (int d = 0; d < ndim; d++) {
+        h->shape[d] = shape[d];
+        count *= shape[d];
+    }
+    h->alignment = alignment;
+    h->data_offset = round_up(sizeof(*h), alignment);
+    h->data_bytes = count * element;
+    h->chunk_size = chunk_size;
+    h->num_chunks = chunk_size ? (h->data_bytes + chunk_size - 1) / chunk_size : 0;
+    h->checksum_offset = round_up(h->data_offset + h->data_bytes, 8);
+    return 0;
+}
+
+int array_file_write(const char* path, const void* data, array_dtype_t dtype, int ndim, const size_t* shape,
+                     size_t alignment, size_t chunk_size) {
+    array_header_t h;
+    if (array_header_init(&h, dtype, ndim, shape, alignment, chunk_size) != 0) return -1;
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+    uint64_t* checksums = (uint64_t*)malloc((h.num_chunks + 1) * sizeof(uint64_t));
+    off_t end = (off_t)(h.checksum_offset + h.num_chunks * sizeof(uint64_t));
+    int errors = !checksums || ftruncate(fd, end) != 0 || pwrite_full(fd, &h, sizeof(h), 0) != 0;
+
+    // Sized up front, so every thread writes its pieces at their final offset
+    const uint64_t piece = piece_size(&h);
+    const long pieces = (long)((h.data_bytes + piece - 1) / piece);
+    if (!errors) {
+        #pragma omp parallel for schedule(dynamic) reduction(+:errors)
+        for (long c = 0; c < pieces; c++) {
+            uint64_t offset = (uint64_t)c * piece;
+            size_t len = (size_t)(h.data_bytes - offset < piece ? h.data_bytes - offset : piece);
+            const char* src = (const char*)data + offset;
+            if (h.chunk_size) checksums[c] = array_checksum(src, len);
+            errors += pwrite_full(fd, src, len, (off_t)(h.data_offset + offset)) != 0;
+        }
+    }
+
+    if (!errors && h.num_chunks) {
+        errors += pwrite_full(fd, checksums, h.num_chunks * sizeof(uint64_t), (off_t)h.checksum_offset) != 0;
+    }
+    free(checksums);
+    if (close(fd) != 0) errors++;
+    return errors ? -1 : 0;
+}
+
+// Read the header of an open file and check it against the file size
+static int read_header(int fd, array_header_t* h) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || pread_full(fd, h, sizeof(*h), 0) != 0) return -1;
+    if (memcmp(h->magic, ARRAY_MAGIC, sizeof(h->magic)) != 0 || h->version != ARRAY_VERSION ||
+        h->byte_order != ARRAY_BYTE_ORDER || h->dtype >= ARRAY_NUM_DTYPES ||
+        h->ndim < 1 || h->ndim > ARRAY_MAX_DIMS) {
+        return -1;
+    }
+    if (h->alignment < 8 || (h->alignment & (h->alignment - 1)) || h->data_offset % h->alignment ||
+        h->data_offset < sizeof(*h)) {
+        return -1;
+    }
+    // Bounded by the file size before any sum, so crafted offsets cannot wrap
+    const uint64_t file_size = (uint64_t)st.st_size;
+    if (h->data_offset > file_size || h->data_bytes > file_size - h->data_offset) return -1;
+
+    uint64_t count = 1;
+    for (uint32_t d = 0; d < h->ndim; d++) {
+        if (h->shape[d] && count > UINT64_MAX / h->shape[d]) return -1;
+        count *= h->shape[d];
+    }
+    if (count > UINT64_MAX / array_dtype_size((array_dtype_t)h->dtype) ||
+        count * array_dtype_size((array_dtype_t)h->dtype) != h->data_bytes) {
+        return -1;
+    }
+    if (h->chunk_size && h->num_chunks != h->data_bytes / h->chunk_size + (h->data_bytes % h->chunk_size != 0)) {
+        return -1;
+    }
+    if (!h->chunk_size && h->num_chunks) return -1;
+    if (h->checksum_offset < h->data_offset + h->data_bytes || h->checksum_offset > file_size ||
+        h->num_chunks > (file_size - h->checksum_offset) / sizeof(uint64_t)) {
+        return -1;
+    }
+    return 0;
+}
+
+int array_file_info(const char* path, array_header_t* header) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    int status = read_header(fd, header);
+    close(fd);
+    return status;
+}
+
+void array_free(array_t* array) {
+    if (!array) return;
+    if (array->mapping_size) {
+        munmap(array->mapping, array->mapping_size);
+    } else {
+        free(array->mapping);
+    }
+    array->mapping = NULL;
+    array->mapping_size = 0;
+    array->data = NULL;
+}
+
+int array_file_load(const char* path, array_load_mode_t mode, int verify, array_t* array) {
+    memset(array, 0, sizeof(*array));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    array_header_t* h = &array->header;
+    if (read_header(fd, h) != 0) {
+        close(fd);
+        return -1;
+    }
+    array->count = h->data_bytes / array_dtype_size((array_dtype_t)h->dtype);
+    if (h->data_bytes == 0) {
+        close(fd);
+        return 0;
+    }
+
+    verify = verify && h->num_chunks;
+    uint64_t* checksums = verify ? (uint64_t*)malloc(h->num_chunks * sizeof(uint64_t)) : NULL;
+    if (verify && (!checksums || pread_full(fd, checksums, h->num_chunks * sizeof(uint64_t),
+                                            (off_t)h->checksum_offset) != 0)) {
+        free(checksums);
+        close(fd);
+        return -1;
+    }
+
+    if (mode == ARRAY_LOAD_MMAP) {
+        // Private writable mapping: in-place algorithms (parallel_sort) copy only the pages they touch
+        size_t size = (size_t)(h->data_offset + h->data_bytes);
+        void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            free(checksums);
+            close(fd);
+            return -1;
+        }
+        if (verify) madvise(map, size, MADV_WILLNEED);
+        array->mapping = map;
+        array->mapping_size = size;
+    } else {
+        size_t align = h->alignment < 64 ? 64 : (size_t)h->alignment;
+        array->mapping = aligned_alloc(align, (size_t)round_up(h->data_offset + h->data_bytes, align));
+        if (!array->mapping) {
+            free(checksums);
+            close(fd);
+            return -1;
+        }
+    }
+    array->data = (char*)array->mapping + h->data_offset;
+
+    // One piece per task: read it (pread mode), then check it while it is in cache
+    const uint64_t piece = piece_size(h);
+    const long pieces = (long)((h->data_bytes + piece - 1) / piece);
+    int io_errors = 0, mismatches = 0;
+    if (mode == ARRAY_LOAD_PREAD || verify) {
+        #pragma omp parallel for schedule(dynamic) reduction(+:io_errors, mismatches)
+        for (long c = 0; c < pieces; c++) {
+            uint64_t offset = (uint64_t)c * piece;
+            size_t len = (size_t)(h->data_bytes - offset < piece ? h->data_bytes - offset : piece);
+            char* dst = (char*)array->data + offset;
+            if (mode == ARRAY_LOAD_PREAD && pread_full(fd, dst, len, (off_t)(h->data_offset + offset)) != 0) {
+                io_errors++;
+            } else if (verify && array_checksum(dst, len) != checksums[c]) {
+                mismatches++;
+            }
+        }
+    }
+    free(checksums);
+    close(fd);
+
+    if (io_errors || mismatches) {
+        array_free(array);
+        return io_errors ? -1 : -2;
+    }
+    return 0;
+}
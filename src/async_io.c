@@ -0,0 +1,429 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <omp.h>
+#include "../include/async_io.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+#define MAX_TRANSFER (1L << 30)  // Largest single read/write handed to the kernel
+
+typedef struct io_request {
+    int fd;
+    int write;
+    char* buf;
+    size_t len;
+    off_t offset;
+    size_t done;                // Bytes transferred so far
+    ssize_t* result;
+    omp_event_handle_t event;
+    struct io_request* next;    // Pending queue of the thread backend, active list of io_uring
+    struct io_request* prev;
+} io_request_t;
+
+struct async_io {
+    async_io_backend_t backend;
+    int depth;
+    pthread_mutex_t lock;       // Protects everything below and the submission ring
+    pthread_cond_t changed;     // A slot freed up, or a request was queued
+    int in_flight;
+    int stopping;
+
+    // Thread backend
+    pthread_t* threads;
+    int num_threads;
+    io_request_t* head;
+    io_request_t* tail;
+
+#ifdef __linux__
+    // io_uring backend
+    pthread_t reaper;
+    io_request_t* active;       // Requests handed to the kernel
+    int failed;                 // -errno once the ring broke and the reaper quit
+    int ring_fd;
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+#endif
+};
+
+static const char* backend_names[] = { "auto", "io_uring", "threads" };
+
+const char* async_io_backend_name(async_io_backend_t backend) {
+    return backend >= ASYNC_IO_AUTO && backend <= ASYNC_IO_THREADS ? backend_names[backend] : "unknown";
+}
+
+async_io_backend_t async_io_backend(const async_io_t* io) {
+    return io->backend;
+}
+
+// Publish the outcome, wake the detached task and free the slot
+static void complete(async_io_t* io, io_request_t* req, ssize_t status) {
+    *req->result = status < 0 ? status : (ssize_t)req->done;
+
+    pthread_mutex_lock(&io->lock);
+#ifdef __linux__
+    if (req->prev) {
+        req->prev->next = req->next;
+    } else if (io->active == req) {
+        io->active = req->next;
+    }
+    if (req->next && io->backend == ASYNC_IO_URING) req->next->prev = req->prev;
+#endif
+    io->in_flight--;
+    pthread_cond_broadcast(&io->changed);
+    pthread_mutex_unlock(&io->lock);
+
+    omp_fulfill_event(req->event);
+    free(req);
+}
+
+// ---- Thread backend ----
+
+static void* io_thread(void* arg) {
+    async_io_t* io = (async_io_t*)arg;
+    for (;;) {
+        pthread_mutex_lock(&io->lock);
+        while (!io->head && !io->stopping) pthread_cond_wait(&io->changed, &io->lock);
+        io_request_t* req = io->head;
+        if (!req) {
+            pthread_mutex_unlock(&io->lock);
+            return NULL;
+        }
+        io->head = req->next;
+        if (!io->head) io->tail = NULL;
+        pthread_mutex_unlock(&io->lock);
+
+        ssize_t status = 0;
+        while (req->done < req->len) {
+            size_t n = req->len - req->done;
+            ssize_t got = req->write ? pwrite(req->fd, req->buf + req->done, n, req->offset + req->done)
+                                     : pread(req->fd, req->buf + req->done, n, req->offset + req->done);
+            if (got < 0 && errno == EINTR) continue;
+            if (got < 0) status = -errno;
+            if (got == 0 && req->write) status = -EIO;
+            if (got <= 0) break;
+            req->done += got;
+        }
+        complete(io, req, status);
+    }
+}
+
+static int threads_start(async_io_t* io) {
+    io->threads = (pthread_t*)malloc(io->depth * sizeof(pthread_t));
+    if (!io->threads) return -1;
+    for (; io->num_threads < io->depth; io->num_threads++) {
+        if (pthread_create(&io->threads[io->num_threads], NULL, io_thread, io) != 0) return -1;
+    }
+    return 0;
+}
+
+static void threads_stop(async_io_t* io) {
+    pthread_mutex_lock(&io->lock);
+    io->stopping = 1;
+    pthread_cond_broadcast(&io->changed);
+    pthread_mutex_unlock(&io->lock);
+    for (int i = 0; i < io->num_threads; i++) pthread_join(io->threads[i], NULL);
+    free(io->threads);
+}
+
+// ---- io_uring backend ----
+
+#ifdef __linux__
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+// Queue the rest of a transfer and hand it to the kernel; called with io->lock held
+static int uring_submit(async_io_t* io, io_request_t* req, int opcode) {
+    unsigned tail = *io->sq_tail;
+    unsigned index = tail & *io->sq_mask;
+    struct io_uring_sqe* sqe = &io->sqes[index];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (unsigned char)opcode;
+    sqe->fd = req ? req->fd : -1;
+    if (req) {
+        size_t n = req->len - req->done;
+        sqe->addr = (unsigned long long)(uintptr_t)(req->buf + req->done);
+        sqe->len = (unsigned)(n < (size_t)MAX_TRANSFER ? n : (size_t)MAX_TRANSFER);
+        sqe->off = (unsigned long long)(req->offset + req->done);
+    }
+    sqe->user_data = (unsigned long long)(uintptr_t)req;
+    io->sq_array[index] = index;
+    __atomic_store_n(io->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    // Without SQPOLL the kernel consumes the entry during the call. Retry
+    // transient failures: an entry left in the ring would go out with the next one.
+    int submitted;
+    while ((submitted = uring_enter(io->ring_fd, 1, 0, 0)) < 0 &&
+           (errno == EINTR || errno == EAGAIN || errno == EBUSY)) {
+        sched_yield();
+    }
+    if (submitted == 1) return 0;
+    // The kernel did not take the entry. Take it back, or the next call would
+    // submit it with a user_data the caller is about to complete and free.
+    __atomic_store_n(io->sq_tail, tail, __ATOMIC_RELEASE);
+    return -1;
+}
+
+// The ring can no longer report completions: fail every request the kernel
+// holds so their tasks finish, and make later submissions fail right away
+static void uring_fail(async_io_t* io, int status) {
+    pthread_mutex_lock(&io->lock);
+    io->failed = status;
+    io_request_t* req = io->active;
+    io->active = NULL;
+    pthread_mutex_unlock(&io->lock);
+    while (req) {
+        io_request_t* next = req->next;
+        req->next = req->prev = NULL;
+        complete(io, req, status);
+        req = next;
+    }
+}
+
+// Helper thread: wait for completions, continue short transfers, fulfill events.
+// A NOP with a NULL request stops it.
+static void* uring_reaper(void* arg) {
+    async_io_t* io = (async_io_t*)arg;
+    for (;;) {
+        if (uring_enter(io->ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            uring_fail(io, -errno);
+            return NULL;
+        }
+
+        unsigned head = *io->cq_head;
+        while (head != __atomic_load_n(io->cq_tail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe* cqe = &io->cqes[head & *io->cq_mask];
+            io_request_t* req = (io_request_t*)(uintptr_t)cqe->user_data;
+            int res = cqe->res;
+            __atomic_store_n(io->cq_head, ++head, __ATOMIC_RELEASE);
+            if (!req) return NULL;
+
+            if (res > 0) {
+                req->done += res;
+                if (req->done < req->len) {
+                    pthread_mutex_lock(&io->lock);
+                    int status = uring_submit(io, req, req->write ? IORING_OP_WRITE : IORING_OP_READ);
+                    pthread_mutex_unlock(&io->lock);
+                    if (status == 0) continue;
+                    res = -EIO;
+                }
+            } else if (res == 0 && req->write) {
+                res = -EIO;
+            }
+            complete(io, req, res < 0 ? res : 0);
+        }
+    }
+}
+
+static int uring_supports_rw(int ring_fd) {
+    const int max_ops = 256;
+    struct io_uring_probe* probe = (struct io_uring_probe*)calloc(1, sizeof(struct io_uring_probe) +
+                                                                  max_ops * sizeof(struct io_uring_probe_op));
+    if (!probe) return 0;
+    int supported = syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, max_ops) == 0 &&
+                    probe->last_op >= IORING_OP_WRITE &&
+                    (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) &&
+                    (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+    free(probe);
+    return supported;
+}
+
+static int uring_start(async_io_t* io) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    io->ring_fd = (int)syscall(__NR_io_uring_setup, io->depth, &params);
+    if (io->ring_fd < 0) return -1;
+
+    io->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    io->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    int single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap && io->cq_ring_size > io->sq_ring_size) io->sq_ring_size = io->cq_ring_size;
+
+    io->sq_ring = mmap(NULL, io->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       io->ring_fd, IORING_OFF_SQ_RING);
+    if (io->sq_ring == MAP_FAILED) return -1;
+    if (single_mmap) {
+        io->cq_ring = io->sq_ring;
+    } else {
+        io->cq_ring = mmap(NULL, io->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           io->ring_fd, IORING_OFF_CQ_RING);
+        if (io->cq_ring == MAP_FAILED) return -1;
+    }
+    io->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    io->sqes = (struct io_uring_sqe*)mmap(NULL, io->sqes_size, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_POPULATE, io->ring_fd, IORING_OFF_SQES);
+    if (io->sqes == MAP_FAILED) return -1;
+
+    char* sq = (char*)io->sq_ring;
+    char* cq = (char*)io->cq_ring;
+    io->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    io->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    io->sq_array = (unsigned*)(sq + params.sq_off.array);
+    io->cq_head = (unsigned*)(cq + params.cq_off.head);
+    io->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    io->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    io->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    // IORING_OP_READ/WRITE need Linux 5.6; older kernels set up fine but reject them
+    if (!uring_supports_rw(io->ring_fd)) return -1;
+    return pthread_create(&io->reaper, NULL, uring_reaper, io) == 0 ? 0 : -1;
+}
+
+static void uring_unmap(async_io_t* io) {
+    if (io->sqes && io->sqes != MAP_FAILED) munmap(io->sqes, io->sqes_size);
+    if (io->cq_ring && io->cq_ring != MAP_FAILED && io->cq_ring != io->sq_ring) munmap(io->cq_ring, io->cq_ring_size);
+    if (io->sq_ring && io->sq_ring != MAP_FAILED) munmap(io->sq_ring, io->sq_ring_size);
+    if (io->ring_fd >= 0) close(io->ring_fd);
+}
+
+static void uring_stop(async_io_t* io) {
+    pthread_mutex_lock(&io->lock);
+    if (!io->failed) uring_submit(io, NULL, IORING_OP_NOP);
+    pthread_mutex_unlock(&io->lock);
+    pthread_join(io->reaper, NULL);
+    uring_unmap(io);
+}
+
+#endif // __linux__
+
+// ---- Engine ----
+
+static async_io_t* engine_alloc(async_io_backend_t backend, int depth) {
+    async_io_t* io = (async_io_t*)calloc(1, sizeof(async_io_t));
+    if (!io) return NULL;
+    io->backend = backend;
+    io->depth = depth;
+    pthread_mutex_init(&io->lock, NULL);
+    pthread_cond_init(&io->changed, NULL);
+#ifdef __linux__
+    io->ring_fd = -1;
+#endif
+    return io;
+}
+
+static void engine_free(async_io_t* io) {
+    pthread_mutex_destroy(&io->lock);
+    pthread_cond_destroy(&io->changed);
+    free(io);
+}
+
+async_io_t* async_io_create(async_io_backend_t backend, int depth) {
+    if (depth <= 0) return NULL;
+
+#ifdef __linux__
+    if (backend == ASYNC_IO_AUTO || backend == ASYNC_IO_URING) {
+        async_io_t* io = engine_alloc(ASYNC_IO_URING, depth);
+        if (!io) return NULL;
+        if (uring_start(io) == 0) return io;
+        uring_unmap(io);
+        engine_free(io);
+        if (backend == ASYNC_IO_URING) return NULL;
+    }
+#else
+    if (backend == ASYNC_IO_URING) return NULL;
+#endif
+
+    async_io_t* io = engine_alloc(ASYNC_IO_THREADS, depth);
+    if (!io) return NULL;
+    if (threads_start(io) != 0) {
+        threads_stop(io);
+        engine_free(io);
+        return NULL;
+    }
+    return io;
+}
+
+void async_io_destroy(async_io_t* io) {
+    if (!io) return;
+#ifdef __linux__
+    if (io->backend == ASYNC_IO_URING) uring_stop(io);
+#endif
+    if (io->backend == ASYNC_IO_THREADS) threads_stop(io);
+    engine_free(io);
+}
+
+static int submit(async_io_t* io, int write, int fd, char* buf, size_t len, off_t offset,
+                  ssize_t* result, omp_event_handle_t event) {
+    io_request_t* req = (io_request_t*)calloc(1, sizeof(io_request_t));
+    if (!req) {
+        *result = -ENOMEM;
+        omp_fulfill_event(event);
+        return -1;
+    }
+    req->fd = fd;
+    req->write = write;
+    req->buf = buf;
+    req->len = len;
+    req->offset = offset;
+    req->result = result;
+    req->event = event;
+
+    pthread_mutex_lock(&io->lock);
+    while (io->in_flight >= io->depth) pthread_cond_wait(&io->changed, &io->lock);
+    io->in_flight++;
+
+    if (len == 0) {
+        pthread_mutex_unlock(&io->lock);
+        complete(io, req, 0);
+        return 0;
+    }
+
+    int status = 0;
+    ssize_t error = -EIO;
+#ifdef __linux__
+    if (io->backend == ASYNC_IO_URING && io->failed) {
+        status = -1;
+        error = io->failed;
+    } else if (io->backend == ASYNC_IO_URING) {
+        req->next = io->active;
+        if (io->active) io->active->prev = req;
+        io->active = req;
+        status = uring_submit(io, req, write ? IORING_OP_WRITE : IORING_OP_READ);
+    }
+#endif
+    if (io->backend == ASYNC_IO_THREADS) {
+        if (io->tail) {
+            io->tail->next = req;
+        } else {
+            io->head = req;
+        }
+        io->tail = req;
+        pthread_cond_broadcast(&io->changed);
+    }
+    pthread_mutex_unlock(&io->lock);
+
+    if (status != 0) complete(io, req, error);
+    return status;
+}
+
+int async_io_read(async_io_t* io, int fd, void* buf, size_t len, off_t offset,
+                  ssize_t* result, omp_event_handle_t event) {
+    return submit(io, 0, fd, (char*)buf, len, offset, result, event);
+}
+
+int async_io_write(async_io_t* io, int fd, const void* buf, size_t len, off_t offset,
+                   ssize_t* result, omp_event_handle_t event) {
+    return submit(io, 1, fd, (char*)buf, len, offset, result, event);
+}
@@ -0,0 +1,330 @@
+#define _GNU_SOURCE  // getline
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "../include/bench_baseline.h"
+
+typedef struct {
+    char name[BENCH_NAME_LEN];
+    int threads;
+    long size;
+    int n;
+    double* samples;
+} baseline_entry_t;
+
+typedef struct {
+    baseline_entry_t* entries;
+    int count;
+    int capacity;
+} entry_list_t;
+
+// Baseline state for the suite being reported
+static struct {
+    bench_baseline_mode_t mode;
+    char suite[BENCH_NAME_LEN];
+    char path[512];
+    entry_list_t current;   // Cases of this run
+    entry_list_t stored;    // Cases loaded from the baseline file
+} baseline = { BENCH_BASELINE_OFF, "", "", { NULL, 0, 0 }, { NULL, 0, 0 } };
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+double bench_mann_whitney_p(const double* a, int na, const double* b, int nb) {
+    if (na <= 0 || nb <= 0) return 1.0;
+
+    // U counts pairs where a beats b, ties count half
+    double u = 0.0;
+    for (int i = 0; i < na; i++) {
+        for (int j = 0; j < nb; j++) {
+            if (a[i] > b[j]) u += 1.0;
+            else if (a[i] == b[j]) u += 0.5;
+        }
+    }
+
+    // Tie correction needs the sizes of groups of equal values in the pooled sample
+    int n = na + nb;
+    double* pooled = (double*)malloc(n * sizeof(double));
+    if (!pooled) return 1.0;
+    memcpy(pooled, a, na * sizeof(double));
+    memcpy(pooled + na, b, nb * sizeof(double));
+    qsort(pooled, n, sizeof(double), compare_doubles);
+
+    double ties = 0.0;
+    for (int i = 0; i < n;) {
+        int j = i;
+        while (j < n && pooled[j] == pooled[i]) j++;
+        double t = j - i;
+        ties += t * t * t - t;
+        i = j;
+    }
+    free(pooled);
+
+    double mean = na * (double)nb / 2.0;
+    double var = na * (double)nb / 12.0 * ((n + 1) - ties / ((double)n * (n - 1)));
+    if (var <= 0.0) return 1.0;
+
+    double z = (u - mean - 0.5) / sqrt(var);
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+
+bench_baseline_mode_t bench_baseline_mode(void) {
+    const char* mode = getenv("BENCH_BASELINE");
+    if (mode && strcmp(mode, "save") == 0) return BENCH_BASELINE_SAVE;
+    if (mode && strcmp(mode, "compare") == 0) return BENCH_BASELINE_COMPARE;
+    return BENCH_BASELINE_OFF;
+}
+
+static double env_double(const char* name, double fallback) {
+    const char* value = getenv(name);
+    return (value && *value) ? atof(value) : fallback;
+}
+
+static void list_free(entry_list_t* list) {
+    for (int i = 0; i < list->count; i++) free(list->entries[i].samples);
+    free(list->entries);
+    list->entries = NULL;
+    list->count = list->capacity = 0;
+}
+
+static baseline_entry_t* list_push(entry_list_t* list) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 16;
+        baseline_entry_t* grown = (baseline_entry_t*)realloc(list->entries, capacity * sizeof(baseline_entry_t));
+        if (!grown) return NULL;
+        list->entries = grown;
+        list->capacity = capacity;
+    }
+    baseline_entry_t* e = &list->entries[list->count++];
+    memset(e, 0, sizeof(*e));
+    return e;
+}
+
+static const baseline_entry_t* list_find(const entry_list_t* list, const char* name, int threads, long size) {
+    for (int i = 0; i < list->count; i++) {
+        const baseline_entry_t* e = &list->entries[i];
+        if (e->threads == threads && e->size == size && strcmp(e->name, name) == 0) return e;
+    }
+    return NULL;
+}
+
+static int make_dirs(const char* path) {
+    char buf[512];
+    snprintf(buf, sizeof(buf), "%s", path);
+    for (char* p = buf + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        if (mkdir(buf, 0755) != 0 && errno != EEXIST) return -1;
+        *p = '/';
+    }
+    return (mkdir(buf, 0755) == 0 || errno == EEXIST) ? 0 : -1;
+}
+
+// Baseline file: metadata comment, then "name",threads,size,n,sample sample ...
+static void load_stored(void) {
+    FILE* f = fopen(baseline.path, "r");
+    if (!f) return;
+
+    char* line = NULL;
+    size_t cap = 0;
+    while (getline(&line, &cap, f) > 0) {
+        if (line[0] != '"') continue;
+        char* end = strchr(line + 1, '"');
+        if (!end) continue;
+        *end = '\0';
+
+        int threads, n, consumed;
+        long size;
+        char* rest = end + 1;
+        if (sscanf(rest, ",%d,%ld,%d,%n", &threads, &size, &n, &consumed) != 3 || n <= 0) continue;
+
+        baseline_entry_t* e = list_push(&baseline.stored);
+        if (!e) break;
+        snprintf(e->name, sizeof(e->name), "%s", line + 1);
+        e->threads = threads;
+        e->size = size;
+        e->samples = (double*)malloc(n * sizeof(double));
+        if (!e->samples) {
+            baseline.stored.count--;
+            break;
+        }
+
+        char* p = rest + consumed;
+        while (e->n < n) {
+            char* next;
+            double v = strtod(p, &next);
+            if (next == p) break;
+            e->samples[e->n++] = v;
+            p = next;
+        }
+    }
+
+    free(line);
+    fclose(f);
+}
+
+void bench_baseline_begin(const char* suite) {
+    list_free(&baseline.current);
+    list_free(&baseline.stored);
+
+    baseline.mode = bench_baseline_mode();
+    if (baseline.mode == BENCH_BASELINE_OFF) return;
+
+    const char* dir = getenv("BENCH_BASELINE_DIR");
+    char fingerprint[32];
+    bench_fingerprint(fingerprint, sizeof(fingerprint), NULL, 0);
+    snprintf(baseline.suite, sizeof(baseline.suite), "%s", suite);
+    snprintf(baseline.path, sizeof(baseline.path), "%s/%s/%s.csv",
+             (dir && *dir) ? dir : "baselines", fingerprint, suite);
+
+    if (baseline.mode == BENCH_BASELINE_COMPARE) {
+        load_stored();
+        if (baseline.stored.count == 0) {
+            fprintf(stderr, "bench: no baseline at %s, run with BENCH_BASELINE=save first\n", baseline.path);
+        }
+    }
+}
+
+void bench_baseline_add(const bench_result_t* result) {
+    if (baseline.mode == BENCH_BASELINE_OFF || !result->samples || result->runs <= 0) return;
+
+    baseline_entry_t* e = list_push(&baseline.current);
+    if (!e) return;
+    snprintf(e->name, sizeof(e->name), "%s", result->name);
+    e->threads = result->threads;
+    e->size = result->size;
+    e->samples = (double*)malloc(result->runs * sizeof(double));
+    if (!e->samples) {
+        baseline.current.count--;
+        return;
+    }
+    memcpy(e->samples, result->samples, result->runs * sizeof(double));
+    e->n = result->runs;
+}
+
+static int save_current(void) {
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", baseline.path);
+    char* slash = strrchr(dir, '/');
+    if (slash) *slash = '\0';
+
+    FILE* f = make_dirs(dir) == 0 ? fopen(baseline.path, "w") : NULL;
+    if (!f) {
+        fprintf(stderr, "bench: cannot write baseline %s\n", baseline.path);
+        return -1;
+    }
+
+    char fingerprint[32], description[256];
+    bench_fingerprint(fingerprint, sizeof(fingerprint), description, sizeof(description));
+    fprintf(f, "# fingerprint=%s %s\n", fingerprint, description);
+
+    for (int i = 0; i < baseline.current.count; i++) {
+        const baseline_entry_t* e = &baseline.current.entries[i];
+        fprintf(f, "\"%s\",%d,%ld,%d,", e->name, e->threads, e->size, e->n);
+        for (int k = 0; k < e->n; k++) fprintf(f, "%s%.9f", k ? " " : "", e->samples[k]);
+        fputc('\n', f);
+    }
+
+    fclose(f);
+    fprintf(stderr, "bench: baseline with %d cases saved to %s\n", baseline.current.count, baseline.path);
+    return 0;
+}
+
+// Median and interquartile range of a sample set (sorted in place)
+static void quartiles(double* v, int n, double* q1, double* median, double* q3) {
+    qsort(v, n, sizeof(double), compare_doubles);
+    double ranks[3] = { 0.25, 0.5, 0.75 };
+    double* out[3] = { q1, median, q3 };
+    for (int k = 0; k < 3; k++) {
+        double rank = ranks[k] * (n - 1);
+        int lo = (int)rank;
+        double frac = rank - lo;
+        *out[k] = lo + 1 < n ? v[lo] + frac * (v[lo + 1] - v[lo]) : v[lo];
+    }
+}
+
+static int compare_current(FILE* out) {
+    double alpha = env_double("BENCH_ALPHA", 0.01);
+    double min_threshold = env_double("BENCH_REGRESSION_THRESHOLD", 0.05);
+    int regressions = 0;
+
+    fprintf(out, "\nRegression check for %s against %s (alpha %.3f, threshold >= %.1f%%)\n",
+            baseline.suite, baseline.path, alpha, min_threshold * 100.0);
+    fprintf(out, "%-32s %7s %12s %12s %8s %9s %10s  %s\n",
+            "case", "threads", "base median", "new median", "change", "threshold", "p-value", "verdict");
+
+    for (int i = 0; i < baseline.current.count; i++) {
+        baseline_entry_t* cur = &baseline.current.entries[i];
+        const baseline_entry_t* base = list_find(&baseline.stored, cur->name, cur->threads, cur->size);
+
+        if (!base || base->n == 0) {
+            fprintf(out, "%-32s %7d %12s %12s %8s %9s %10s  %s\n",
+                    cur->name, cur->threads, "-", "-", "-", "-", "-", "no baseline");
+            continue;
+        }
+
+        double p_slower = bench_mann_whitney_p(cur->samples, cur->n, base->samples, base->n);
+        double p_faster = bench_mann_whitney_p(base->samples, base->n, cur->samples, cur->n);
+
+        double* b = (double*)malloc(base->n * sizeof(double));
+        double* c = (double*)malloc(cur->n * sizeof(double));
+        if (!b || !c) {
+            free(b); free(c);
+            continue;
+        }
+        memcpy(b, base->samples, base->n * sizeof(double));
+        memcpy(c, cur->samples, cur->n * sizeof(double));
+
+        double bq1, bmed, bq3, cq1, cmed, cq3;
+        quartiles(b, base->n, &bq1, &bmed, &bq3);
+        quartiles(c, cur->n, &cq1, &cmed, &cq3);
+        free(b);
+        free(c);
+
+        // Noisy kernels need a bigger change before we call it a regression
+        double noise = bmed > 0.0 ? (bq3 - bq1) / bmed : 0.0;
+        double threshold = noise > min_threshold ? noise : min_threshold;
+        double change = bmed > 0.0 ? cmed / bmed - 1.0 : 0.0;
+
+        const char* verdict = "ok";
+        double p = p_slower;
+        if (p_slower < alpha && change > threshold) {
+            verdict = "REGRESSION";
+            regressions++;
+        } else if (p_faster < alpha && -change > threshold) {
+            verdict = "improved";
+            p = p_faster;
+        }
+
+        fprintf(out, "%-32s %7d %12.6f %12.6f %+7.1f%% %8.1f%% %10.4f  %s\n",
+                cur->name, cur->threads, bmed, cmed, change * 100.0, threshold * 100.0, p, verdict);
+    }
+
+    if (regressions) {
+        fprintf(out, "%d case(s) regressed beyond their noise threshold\n", regressions);
+    } else {
+        fprintf(out, "No regressions\n");
+    }
+    return regressions;
+}
+
+int bench_baseline_end(FILE* out) {
+    int regressions = 0;
+
+    if (baseline.mode == BENCH_BASELINE_SAVE) {
+        save_current();
+    } else if (baseline.mode == BENCH_BASELINE_COMPARE && baseline.stored.count > 0) {
+        regressions = compare_current(out);
+    }
+
+    list_free(&baseline.current);
+    list_free(&baseline.stored);
+    baseline.mode = BENCH_BASELINE_OFF;
+    return regressions;
+}
@@ -0,0 +1,535 @@
+#define _GNU_SOURCE  // sched_getcpu
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/bench_baseline.h"
+
+// Reporter state, one report at a time per process
+static struct {
+    FILE* out;
+    int owns_out;
+    bench_format_t format;
+    int count;
+    char suite[BENCH_NAME_LEN];
+} report = { NULL, 0, BENCH_FORMAT_TEXT, 0, "" };
+
+// Counter session reused by bench_run (too large for the stack)
+static perf_session_t counter_session;
+static int counter_warning_shown = 0;
+
+static int env_int(const char* name, int fallback) {
+    const char* value = getenv(name);
+    return (value && *value) ? atoi(value) : fallback;
+}
+
+static double env_double(const char* name, double fallback) {
+    const char* value = getenv(name);
+    return (value && *value) ? atof(value) : fallback;
+}
+
+void bench_config_default(bench_config_t* config) {
+    config->warmup_runs = env_int("BENCH_WARMUP", 1);
+    config->min_runs = env_int("BENCH_MIN_RUNS", 5);
+    config->max_runs = env_int("BENCH_MAX_RUNS", 50);
+    config->max_time = env_double("BENCH_MAX_TIME", 10.0);
+    config->target_rel_ci = env_double("BENCH_TARGET_CI", 0.02);
+    config->outlier_k = env_double("BENCH_OUTLIER_K", 1.5);
+    config->counters = env_int("BENCH_COUNTERS", 1);
+
+    if (config->min_runs < 1) config->min_runs = 1;
+    if (config->max_runs < config->min_runs) config->max_runs = config->min_runs;
+}
+
+// Two-sided 95% Student t quantile for the given degrees of freedom
+static double t_quantile_95(int df) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (df < 1) return INFINITY;
+    if (df <= 30) return table[df - 1];
+    return 1.96;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Linear interpolation between closest ranks of a sorted array
+static double percentile_sorted(const double* sorted, int n, double p) {
+    if (n == 1) return sorted[0];
+    double rank = p * (n - 1);
+    int lo = (int)rank;
+    if (lo >= n - 1) return sorted[n - 1];
+    double frac = rank - lo;
+    return sorted[lo] + frac * (sorted[lo + 1] - sorted[lo]);
+}
+
+int bench_stats_compute(const double* samples, int n, double outlier_k, bench_result_t* result) {
+    if (n <= 0) return -1;
+
+    double* sorted = (double*)malloc(n * sizeof(double));
+    if (!sorted) return -1;
+    memcpy(sorted, samples, n * sizeof(double));
+    qsort(sorted, n, sizeof(double), compare_doubles);
+
+    // Tukey fences on the interquartile range
+    int first = 0, last = n - 1;
+    if (outlier_k > 0.0 && n >= 4) {
+        double q1 = percentile_sorted(sorted, n, 0.25);
+        double q3 = percentile_sorted(sorted, n, 0.75);
+        double lower = q1 - outlier_k * (q3 - q1);
+        double upper = q3 + outlier_k * (q3 - q1);
+        while (first < last && sorted[first] < lower) first++;
+        while (last > first && sorted[last] > upper) last--;
+    }
+
+    const double* kept = sorted + first;
+    int k = last - first + 1;
+
+    double sum = 0.0;
+    for (int i = 0; i < k; i++) sum += kept[i];
+    double mean = sum / k;
+
+    double sq = 0.0;
+    for (int i = 0; i < k; i++) sq += (kept[i] - mean) * (kept[i] - mean);
+    double stddev = k > 1 ? sqrt(sq / (k - 1)) : 0.0;
+
+    result->runs = n;
+    result->kept = k;
+    result->mean = mean;
+    result->median = percentile_sorted(kept, k, 0.5);
+    result->min = kept[0];
+    result->max = kept[k - 1];
+    result->p95 = percentile_sorted(kept, k, 0.95);
+    result->stddev = stddev;
+    result->ci95 = k > 1 ? t_quantile_95(k - 1) * stddev / sqrt((double)k) : 0.0;
+
+    free(sorted);
+    return 0;
+}
+
+int bench_run(const bench_config_t* config, const char* name, long size,
+              bench_fn_t fn, void* arg, bench_result_t* result) {
+    bench_config_t defaults;
+    if (!config) {
+        bench_config_default(&defaults);
+        config = &defaults;
+    }
+
+    memset(result, 0, sizeof(*result));
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->threads = omp_get_max_threads();
+    result->size = size;
+    result->samples = (double*)malloc(config->max_runs * sizeof(double));
+    if (!result->samples) return -1;
+
+    for (int i = 0; i < config->warmup_runs; i++) {
+        fn(arg);
+    }
+
+    // Counters are opened after warm-up so the worker pool already exists
+    int counting = 0;
+    if (config->counters) {
+        counting = perf_session_open(&counter_session, result->threads) > 0;
+        if (!counting && !counter_warning_shown) {
+            fprintf(stderr, "bench: hardware counters unavailable (%s)\n", counter_session.error);
+            counter_warning_shown = 1;
+        }
+    }
+
+    // Welford running mean/variance for the stopping rule
+    double mean = 0.0, m2 = 0.0;
+    double budget_start = omp_get_wtime();
+    int n = 0;
+
+    while (n < config->max_runs) {
+        if (counting) perf_session_start(&counter_session);
+        double start = omp_get_wtime();
+        fn(arg);
+        double elapsed = omp_get_wtime() - start;
+        if (counting) perf_session_stop(&counter_session);
+
+        result->samples[n++] = elapsed;
+        double delta = elapsed - mean;
+        mean += delta / n;
+        m2 += delta * (elapsed - mean);
+
+        if (n < config->min_runs) continue;
+
+        double half_width = n > 1 ? t_quantile_95(n - 1) * sqrt(m2 / (n - 1) / n) : INFINITY;
+        if (mean > 0.0 && half_width / mean <= config->target_rel_ci) {
+            result->converged = 1;
+            break;
+        }
+        if (omp_get_wtime() - budget_start >= config->max_time) break;
+    }
+
+    if (counting) {
+        int threads = counter_session.num_threads;
+        result->thread_counters = (perf_values_t*)malloc(threads * sizeof(perf_values_t));
+        if (result->thread_counters) {
+            perf_session_read(&counter_session, result->thread_counters, &result->counters);
+            for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+                if (result->counters.count[e] >= 0.0) result->counters.count[e] /= n;
+                for (int t = 0; t < threads; t++) {
+                    if (result->thread_counters[t].count[e] >= 0.0) result->thread_counters[t].count[e] /= n;
+                }
+            }
+            result->has_counters = 1;
+        }
+        perf_session_close(&counter_session);
+    }
+
+    return bench_stats_compute(result->samples, n, config->outlier_k, result);
+}
+
+long bench_problem_size(long default_size, int work_exponent) {
+    const char* value = getenv("BENCH_SIZE");
+    long size = (value && *value) ? atol(value) : default_size;
+
+    if (env_int("BENCH_WEAK_SCALING", 0) && work_exponent > 0) {
+        double scale = pow((double)omp_get_max_threads(), 1.0 / work_exponent);
+        size = (long)(size * scale + 0.5);
+    }
+    return size;
+}
+
+void bench_result_free(bench_result_t* result) {
+    free(result->samples);
+    free(result->thread_counters);
+    result->samples = NULL;
+    result->thread_counters = NULL;
+}
+
+static void read_cpu_model(char* buf, size_t len) {
+    snprintf(buf, len, "unknown");
+    FILE* f = fopen("/proc/cpuinfo", "r");
+    if (!f) return;
+
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "model name", 10) == 0) {
+            char* colon = strchr(line, ':');
+            if (colon) {
+                colon++;
+                while (*colon == ' ') colon++;
+                colon[strcspn(colon, "\n")] = '\0';
+                snprintf(buf, len, "%s", colon);
+            }
+            break;
+        }
+    }
+    fclose(f);
+}
+
+void bench_fingerprint(char* buf, size_t len, char* description, size_t description_len) {
+    char cpu[128];
+    char text[256];
+    read_cpu_model(cpu, sizeof(cpu));
+    snprintf(text, sizeof(text), "cpu=%s procs=%d compiler=%s", cpu, omp_get_num_procs(), __VERSION__);
+
+    // FNV-1a, so results from different machines or compilers never mix
+    unsigned long long hash = 14695981039346656037ULL;
+    for (const char* c = text; *c; c++) {
+        hash ^= (unsigned char)*c;
+        hash *= 1099511628211ULL;
+    }
+
+    snprintf(buf, len, "%016llx", hash);
+    if (description) snprintf(description, description_len, "%s", text);
+}
+
+// Escape a string for JSON output (quotes, backslashes, control characters)
+static void json_string(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fprintf(out, "\\%c", *s);
+        else if ((unsigned char)*s < 0x20) fprintf(out, "\\u%04x", *s);
+        else fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+int bench_placement(char* buf, size_t len, int* distinct_cpus) {
+    int threads = omp_get_max_threads();
+    int* cpus = (int*)malloc(threads * sizeof(int));
+    int* places = (int*)malloc(threads * sizeof(int));
+    int* inside = (int*)malloc(threads * sizeof(int));
+    if (!cpus || !places || !inside) {
+        free(cpus); free(places); free(inside);
+        snprintf(buf, len, "unknown");
+        return 0;
+    }
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int t = omp_get_thread_num();
+        #pragma omp barrier
+        cpus[t] = sched_getcpu();
+        places[t] = omp_get_place_num();
+        inside[t] = 0;
+
+        if (places[t] >= 0) {
+            int nprocs = omp_get_place_num_procs(places[t]);
+            int* ids = (int*)malloc((nprocs > 0 ? nprocs : 1) * sizeof(int));
+            if (ids) {
+                omp_get_place_proc_ids(places[t], ids);
+                for (int i = 0; i < nprocs; i++) {
+                    if (ids[i] == cpus[t]) inside[t] = 1;
+                }
+                free(ids);
+            }
+        }
+    }
+
+    int bound = 1, ok = 1, distinct = 0;
+    size_t used = 0;
+    buf[0] = '\0';
+    for (int t = 0; t < threads; t++) {
+        if (places[t] < 0) bound = 0;
+        if (!inside[t]) ok = 0;
+
+        int seen = 0;
+        for (int u = 0; u < t; u++) {
+            if (cpus[u] == cpus[t]) seen = 1;
+        }
+        if (!seen) distinct++;
+
+        if (used < len) {
+            used += snprintf(buf + used, len - used, "%s%d:%d@%d", t ? " " : "", t, cpus[t], places[t]);
+        }
+    }
+
+    free(cpus);
+    free(places);
+    free(inside);
+    if (distinct_cpus) *distinct_cpus = distinct;
+    return bound ? ok : -1;
+}
+
+static void print_metadata(void) {
+    char host[128] = "unknown";
+    char cpu[128];
+    char stamp[32];
+    const char* places = getenv("OMP_PLACES");
+    const char* bind = getenv("OMP_PROC_BIND");
+    time_t now = time(NULL);
+
+    gethostname(host, sizeof(host) - 1);
+    read_cpu_model(cpu, sizeof(cpu));
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    const char* keys[] = { "suite", "timestamp", "host", "cpu", "compiler", "places", "proc_bind" };
+    const char* values[] = { report.suite, stamp, host, cpu, __VERSION__,
+                             places ? places : "unset", bind ? bind : "unset" };
+    int num_keys = sizeof(keys) / sizeof(keys[0]);
+
+    char fingerprint[32];
+    bench_fingerprint(fingerprint, sizeof(fingerprint), NULL, 0);
+
+    char placement[1024];
+    int distinct = 0;
+    int placement_ok = bench_placement(placement, sizeof(placement), &distinct);
+    const char* binding = placement_ok < 0 ? "unbound"
+                        : placement_ok ? "bound, every thread inside its place"
+                        : "bound, some threads outside their place";
+
+    switch (report.format) {
+        case BENCH_FORMAT_TEXT:
+            fprintf(report.out, "Benchmark suite: %s\n", report.suite);
+            fprintf(report.out, "Host: %s (%s), %d procs, %d max threads\n",
+                    host, cpu, omp_get_num_procs(), omp_get_max_threads());
+            fprintf(report.out, "Compiler: %s, OpenMP %d, OMP_PLACES=%s, OMP_PROC_BIND=%s\n",
+                    __VERSION__, _OPENMP, values[5], values[6]);
+            fprintf(report.out, "Placement: %d threads on %d distinct CPUs, %s\n",
+                    omp_get_max_threads(), distinct, binding);
+            fprintf(report.out, "Date: %s, fingerprint %s\n\n", stamp, fingerprint);
+            break;
+
+        case BENCH_FORMAT_CSV:
+            for (int i = 0; i < num_keys; i++) {
+                fprintf(report.out, "# %s=%s\n", keys[i], values[i]);
+            }
+            fprintf(report.out, "# procs=%d\n# openmp=%d\n# fingerprint=%s\n",
+                    omp_get_num_procs(), _OPENMP, fingerprint);
+            fprintf(report.out, "# placement=%s\n# placement_ok=%d\n# distinct_cpus=%d\n",
+                    placement, placement_ok, distinct);
+            fprintf(report.out, "name,threads,size,runs,kept,converged,"
+                                "mean,median,min,max,p95,stddev,ci95");
+            for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+                fprintf(report.out, ",%s", perf_event_name(e));
+            }
+            fprintf(report.out, ",ipc\n");
+            break;
+
+        case BENCH_FORMAT_JSON:
+            fprintf(report.out, "{\n  \"metadata\": {");
+            for (int i = 0; i < num_keys; i++) {
+                fprintf(report.out, "%s\n    ", i ? "," : "");
+                json_string(report.out, keys[i]);
+                fprintf(report.out, ": ");
+                json_string(report.out, values[i]);
+            }
+            fprintf(report.out, ",\n    \"procs\": %d,\n    \"openmp\": %d,\n    \"fingerprint\": \"%s\",\n    \"placement\": ",
+                    omp_get_num_procs(), _OPENMP, fingerprint);
+            json_string(report.out, placement);
+            fprintf(report.out, ",\n    \"placement_ok\": %d,\n    \"distinct_cpus\": %d\n  },\n",
+                    placement_ok, distinct);
+            fprintf(report.out, "  \"results\": [");
+            break;
+    }
+}
+
+// Instructions per cycle, or -1 when either counter is missing
+static double counters_ipc(const perf_values_t* v) {
+    double cycles = v->count[PERF_CYCLES];
+    double instructions = v->count[PERF_INSTRUCTIONS];
+    return (cycles > 0.0 && instructions >= 0.0) ? instructions / cycles : -1.0;
+}
+
+// Empty CSV field / JSON null for unavailable values
+static void print_optional(FILE* out, double value, const char* missing) {
+    if (value < 0.0) fputs(missing, out);
+    else fprintf(out, "%.6g", value);
+}
+
+static void print_counters_json(FILE* out, const perf_values_t* v) {
+    fputc('{', out);
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        fprintf(out, "%s\"%s\": ", e ? ", " : "", perf_event_name(e));
+        print_optional(out, v->count[e], "null");
+    }
+    fprintf(out, ", \"ipc\": ");
+    print_optional(out, counters_ipc(v), "null");
+    fputc('}', out);
+}
+
+void bench_report_begin(const char* suite) {
+    const char* format = getenv("BENCH_FORMAT");
+    const char* path = getenv("BENCH_OUTPUT");
+
+    report.format = BENCH_FORMAT_TEXT;
+    if (format && strcmp(format, "csv") == 0) report.format = BENCH_FORMAT_CSV;
+    else if (format && strcmp(format, "json") == 0) report.format = BENCH_FORMAT_JSON;
+
+    report.out = stdout;
+    report.owns_out = 0;
+    if (path && *path) {
+        FILE* f = fopen(path, "w");
+        if (f) {
+            report.out = f;
+            report.owns_out = 1;
+        } else {
+            fprintf(stderr, "bench: cannot open %s, writing to stdout\n", path);
+        }
+    }
+
+    report.count = 0;
+    snprintf(report.suite, sizeof(report.suite), "%s", suite);
+    print_metadata();
+    bench_baseline_begin(suite);
+}
+
+void bench_report_result(const bench_result_t* r) {
+    if (!report.out) return;
+
+    switch (report.format) {
+        case BENCH_FORMAT_TEXT:
+            fprintf(report.out, "%-32s threads=%-3d median %.6f s  min %.6f  p95 %.6f  "
+                                "mean %.6f +/- %.6f  sd %.6f  (%d/%d runs%s)\n",
+                    r->name, r->threads, r->median, r->min, r->p95, r->mean, r->ci95,
+                    r->stddev, r->kept, r->runs, r->converged ? "" : ", not converged");
+            if (r->has_counters) {
+                const perf_values_t* v = &r->counters;
+                fprintf(report.out, "%-32s IPC ", "");
+                print_optional(report.out, counters_ipc(v), "n/a");
+                if (r->size > 0) {
+                    double llc = v->count[PERF_LLC_MISSES];
+                    double branch = v->count[PERF_BRANCH_MISSES];
+                    fprintf(report.out, "  LLC misses/elem ");
+                    print_optional(report.out, llc < 0.0 ? llc : llc / r->size, "n/a");
+                    fprintf(report.out, "  branch misses/elem ");
+                    print_optional(report.out, branch < 0.0 ? branch : branch / r->size, "n/a");
+                }
+                fputc('\n', report.out);
+            }
+            break;
+
+        case BENCH_FORMAT_CSV:
+            fprintf(report.out, "\"%s\",%d,%ld,%d,%d,%d,%.9f,%.9f,%.9f,%.9f,%.9f,%.9f,%.9f",
+                    r->name, r->threads, r->size, r->runs, r->kept, r->converged,
+                    r->mean, r->median, r->min, r->max, r->p95, r->stddev, r->ci95);
+            for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+                fputc(',', report.out);
+                if (r->has_counters) print_optional(report.out, r->counters.count[e], "");
+            }
+            fputc(',', report.out);
+            if (r->has_counters) print_optional(report.out, counters_ipc(&r->counters), "");
+            fputc('\n', report.out);
+            break;
+
+        case BENCH_FORMAT_JSON:
+            fprintf(report.out, "%s\n    {\"name\": ", report.count ? "," : "");
+            json_string(report.out, r->name);
+            fprintf(report.out, ", \"threads\": %d, \"size\": %ld, \"runs\": %d, \"kept\": %d, "
+                                "\"converged\": %s,\n     \"mean\": %.9f, \"median\": %.9f, "
+                                "\"min\": %.9f, \"max\": %.9f, \"p95\": %.9f, \"stddev\": %.9f, "
+                                "\"ci95\": %.9f,\n     \"samples\": [",
+                    r->threads, r->size, r->runs, r->kept, r->converged ? "true" : "false",
+                    r->mean, r->median, r->min, r->max, r->p95, r->stddev, r->ci95);
+            for (int i = 0; r->samples && i < r->runs; i++) {
+                fprintf(report.out, "%s%.9f", i ? ", " : "", r->samples[i]);
+            }
+            fprintf(report.out, "]");
+            if (r->has_counters) {
+                fprintf(report.out, ",\n     \"counters\": ");
+                print_counters_json(report.out, &r->counters);
+                fprintf(report.out, ",\n     \"thread_counters\": [");
+                for (int t = 0; r->thread_counters && t < r->threads && t < PERF_MAX_THREADS; t++) {
+                    fprintf(report.out, "%s\n       ", t ? "," : "");
+                    print_counters_json(report.out, &r->thread_counters[t]);
+                }
+                fprintf(report.out, "]");
+            }
+            fprintf(report.out, "}");
+            break;
+    }
+
+    report.count++;
+    fflush(report.out);
+    bench_baseline_add(r);
+}
+
+int bench_report_end(void) {
+    if (!report.out) return 0;
+
+    if (report.format == BENCH_FORMAT_JSON) {
+        fprintf(report.out, "\n  ]\n}\n");
+    }
+
+    if (report.owns_out) fclose(report.out);
+    report.out = NULL;
+    report.owns_out = 0;
+
+    // The comparison is for humans, keep it out of machine-readable stdout
+    return bench_baseline_end(bench_log_stream());
+}
+
+bench_format_t bench_report_format(void) {
+    return report.format;
+}
+
+FILE* bench_log_stream(void) {
+    if (report.format != BENCH_FORMAT_TEXT && !report.owns_out) return stderr;
+    return stdout;
+}
@@ -0,0 +1,382 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../include/external_sort.h"
+#include "../include/array_file.h"
+#include "../include/async_io.h"
+#include "../include/parallel_algorithms.h"
+
+#define SAMPLES_PER_RUN 256
+#define PARTITIONS_PER_THREAD 4     // More partitions than threads balance uneven splits
+#define MIN_RUN_ELEMS 1024
+#define MAX_RUN_ELEMS (1L << 30)    // parallel_sort_tasks() takes an int size
+#define MIN_BLOCK_ELEMS 8192        // 64 KB reads per run in the merge
+#define IO_DEPTH 4
+
+typedef struct {
+    int run_fd;
+    int out_fd;
+    long runs;
+    uint64_t run_elems;             // Elements per run, the last one may be shorter
+    uint64_t count;
+    int partitions;
+    const uint64_t* bounds;         // bounds[r * (partitions + 1) + p]: start of partition p in run r
+    size_t block_elems;
+    const array_header_t* out;
+    uint64_t chunk_elems;           // Output flush granularity, the checksum chunk if there is one
+    uint64_t* checksums;
+    unsigned char* checksummed;     // Chunks a partition wrote whole and checksummed
+} merge_ctx_t;
+
+// Position of a partition's merge in one run: a block in memory and the rest on disk
+typedef struct {
+    double* block;
+    size_t pos, count;
+    uint64_t next, end;             // Elements of the run file still to read
+} cursor_t;
+
+static int pread_full(int fd, void* buf, size_t len, off_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = pread(fd, (char*)buf + done, len - done, offset + done);
+        if (n <= 0) return -1;
+        done += n;
+    }
+    return 0;
+}
+
+static int pwrite_full(int fd, const void* buf, size_t len, off_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = pwrite(fd, (const char*)buf + done, len - done, offset + done);
+        if (n <= 0) return -1;
+        done += n;
+    }
+    return 0;
+}
+
+static uint64_t run_length(uint64_t count, uint64_t run_elems, long r) {
+    uint64_t start = (uint64_t)r * run_elems;
+    return count - start < run_elems ? count - start : run_elems;
+}
+
+// Load the next block of a run, then have the kernel start reading the one after it
+static int cursor_fill(cursor_t* c, int fd, size_t block_elems) {
+    size_t n = c->end - c->next < block_elems ? (size_t)(c->end - c->next) : block_elems;
+    if (pread_full(fd, c->block, n * sizeof(double), (off_t)(c->next * sizeof(double))) != 0) return -1;
+    c->next += n;
+    c->pos = 0;
+    c->count = n;
+    if (c->next < c->end) {
+        size_t ahead = c->end - c->next < block_elems ? (size_t)(c->end - c->next) : block_elems;
+        posix_fadvise(fd, (off_t)(c->next * sizeof(double)), (off_t)(ahead * sizeof(double)), POSIX_FADV_WILLNEED);
+    }
+    return 0;
+}
+
+// Min-heap of run indices keyed by the current element of each cursor
+static void sift_down(const cursor_t* cursors, int* heap, int size, int i) {
+    for (;;) {
+        int smallest = i, l = 2 * i + 1, r = 2 * i + 2;
+        const cursor_t* s = &cursors[heap[smallest]];
+        if (l < size && cursors[heap[l]].block[cursors[heap[l]].pos] < s->block[s->pos]) {
+            smallest = l;
+            s = &cursors[heap[l]];
+        }
+        if (r < size && cursors[heap[r]].block[cursors[heap[r]].pos] < s->block[s->pos]) smallest = r;
+        if (smallest == i) return;
+        int t = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = t;
+        i = smallest;
+    }
+}
+
+static int flush(const merge_ctx_t* ctx, const double* out, size_t n, uint64_t index) {
+    const array_header_t* h = ctx->out;
+    if (pwrite_full(ctx->out_fd, out, n * sizeof(double), (off_t)(h->data_offset + index * sizeof(double))) != 0) {
+        return -1;
+    }
+    // A whole chunk written at once (or all of the last one) is checksummed while in cache
+    if (h->chunk_size && index % ctx->chunk_elems == 0 && (n == ctx->chunk_elems || index + n == ctx->count)) {
+        uint64_t c = index / ctx->chunk_elems;
+        ctx->checksums[c] = array_checksum(out, n * sizeof(double));
+        ctx->checksummed[c] = 1;
+    }
+    return 0;
+}
+
+// k-way merge of partition p of every run into its place in the output
+static int merge_partition(const merge_ctx_t* ctx, int p) {
+    const int stride = ctx->partitions + 1;
+    uint64_t out_index = 0;
+    for (long r = 0; r < ctx->runs; r++) out_index += ctx->bounds[r * stride + p];
+
+    cursor_t* cursors = (cursor_t*)calloc(ctx->runs, sizeof(cursor_t));
+    int* heap = (int*)malloc(ctx->runs * sizeof(int));
+    double* out = (double*)malloc(ctx->chunk_elems * sizeof(double));
+    int errors = !cursors || !heap || !out;
+    int heap_size = 0;
+    for (long r = 0; r < ctx->runs && !errors; r++) {
+        cursor_t* c = &cursors[r];
+        c->next = (uint64_t)r * ctx->run_elems + ctx->bounds[r * stride + p];
+        c->end = (uint64_t)r * ctx->run_elems + ctx->bounds[r * stride + p + 1];
+        if (c->next == c->end) continue;
+        c->block = (double*)malloc(ctx->block_elems * sizeof(double));
+        if (!c->block || cursor_fill(c, ctx->run_fd, ctx->block_elems) != 0) {
+            errors++;
+            break;
+        }
+        heap[heap_size++] = (int)r;
+    }
+    for (int i = heap_size / 2 - 1; i >= 0 && !errors; i--) sift_down(cursors, heap, heap_size, i);
+
+    // Flush at output chunk boundaries, so whole chunks can be checksummed here
+    size_t filled = 0;
+    size_t room = (size_t)(ctx->chunk_elems - out_index % ctx->chunk_elems);
+    while (heap_size && !errors) {
+        cursor_t* c = &cursors[heap[0]];
+        out[filled++] = c->block[c->pos++];
+        if (c->pos == c->count) {
+            if (c->next == c->end) {
+                heap[0] = heap[--heap_size];
+            } else if (cursor_fill(c, ctx->run_fd, ctx->block_elems) != 0) {
+                errors++;
+                break;
+            }
+        }
+        if (heap_size) sift_down(cursors, heap, heap_size, 0);
+        if (filled == room) {
+            errors += flush(ctx, out, filled, out_index) != 0;
+            out_index += filled;
+            filled = 0;
+            room = (size_t)ctx->chunk_elems;
+        }
+    }
+    if (filled && !errors) errors += flush(ctx, out, filled, out_index) != 0;
+
+    for (long r = 0; cursors && r < ctx->runs; r++) free(cursors[r].block);
+    free(cursors);
+    free(heap);
+    free(out);
+    return errors ? -1 : 0;
+}
+
+// First index of a sorted run on disk whose element is >= key
+static int lower_bound(int fd, uint64_t start, uint64_t len, double key, uint64_t* index) {
+    uint64_t lo = 0, hi = len;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        double v;
+        if (pread_full(fd, &v, sizeof(v), (off_t)((start + mid) * sizeof(double))) != 0) return -1;
+        if (v < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *index = lo;
+    return 0;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Sorted runs are spilled to one unlinked temporary file
+static int open_run_file(const char* tmp_dir) {
+    if (!tmp_dir || !*tmp_dir) tmp_dir = getenv("TMPDIR");
+    if (!tmp_dir || !*tmp_dir) tmp_dir = "/tmp";
+    char path[512];
+    snprintf(path, sizeof(path), "%s/external_sort.XXXXXX", tmp_dir);
+    int fd = mkstemp(path);
+    if (fd >= 0) unlink(path);
+    return fd;
+}
+
+// Phase 1: read, sort and spill every run, sampling each sorted run
+static int sort_runs(int in_fd, const array_header_t* in, int run_fd, long runs, uint64_t run_elems,
+                     double* samples) {
+    const uint64_t count = in->data_bytes / sizeof(double);
+    async_io_t* io = async_io_create(ASYNC_IO_AUTO, IO_DEPTH);
+    double* buf[2] = { (double*)malloc(run_elems * sizeof(double)), (double*)malloc(run_elems * sizeof(double)) };
+    double* temp = (double*)malloc(run_elems * sizeof(double));
+    ssize_t* read_results = (ssize_t*)calloc(runs, sizeof(ssize_t));
+    ssize_t* write_results = (ssize_t*)calloc(runs, sizeof(ssize_t));
+    int errors = !io || !buf[0] || !buf[1] || !temp || !read_results || !write_results;
+
+    // Per run: read -> sort -> spill. Reads and spills are detached tasks, so the next run's
+    // read and the previous run's spill proceed while this run sorts on all threads
+    #pragma omp parallel if(!errors)
+    #pragma omp single
+    {
+        for (long r = 0; r < runs && !errors; r++) {
+            double* cur = buf[r % 2];
+            const uint64_t len = run_length(count, run_elems, r);
+            const off_t offset = (off_t)(r * run_elems * sizeof(double));
+
+            // The buffer is free once the spill of run r - 2 from it completed
+            omp_event_handle_t read_done;
+            #pragma omp task detach(read_done) depend(inout: cur[0])
+            async_io_read(io, in_fd, cur, len * sizeof(double), (off_t)in->data_offset + offset,
+                          &read_results[r], read_done);
+
+            // One sort at a time: the runs share the scratch buffer
+            #pragma omp task depend(inout: cur[0], temp[0])
+            {
+                if (read_results[r] == (ssize_t)(len * sizeof(double))) {
+                    parallel_sort_tasks(cur, temp, (int)len);
+                    for (int s = 0; s < SAMPLES_PER_RUN; s++) {
+                        samples[r * SAMPLES_PER_RUN + s] = cur[(uint64_t)s * len / SAMPLES_PER_RUN];
+                    }
+                }
+            }
+
+            omp_event_handle_t write_done;
+            #pragma omp task detach(write_done) depend(inout: cur[0])
+            async_io_write(io, run_fd, cur, len * sizeof(double), offset, &write_results[r], write_done);
+        }
+        #pragma omp taskwait
+    }
+
+    for (long r = 0; r < runs && !errors; r++) {
+        ssize_t bytes = (ssize_t)(run_length(count, run_elems, r) * sizeof(double));
+        errors += read_results[r] != bytes || write_results[r] != bytes;
+    }
+    if (io) async_io_destroy(io);
+    free(buf[0]);
+    free(buf[1]);
+    free(temp);
+    free(read_results);
+    free(write_results);
+    return errors ? -1 : 0;
+}
+
+// Phase 2: split the runs at sampled splitters and merge the partitions in parallel
+static int merge_runs(merge_ctx_t* ctx, double* samples, size_t budget) {
+    const int threads = omp_get_max_threads();
+    const int parts = ctx->partitions;
+    const int stride = parts + 1;
+    const long total_samples = ctx->runs * SAMPLES_PER_RUN;
+    uint64_t* bounds = (uint64_t*)malloc(ctx->runs * stride * sizeof(uint64_t));
+    if (!bounds) return -1;
+
+    qsort(samples, total_samples, sizeof(double), compare_doubles);
+    int errors = 0;
+    #pragma omp parallel for collapse(2) schedule(dynamic) reduction(+:errors)
+    for (long r = 0; r < ctx->runs; r++) {
+        for (int p = 0; p <= parts; p++) {
+            uint64_t len = run_length(ctx->count, ctx->run_elems, r);
+            uint64_t* b = &bounds[r * stride + p];
+            if (p == 0) {
+                *b = 0;
+            } else if (p == parts) {
+                *b = len;
+            } else {
+                double splitter = samples[(long)p * total_samples / parts];
+                errors += lower_bound(ctx->run_fd, (uint64_t)r * ctx->run_elems, len, splitter, b) != 0;
+            }
+        }
+    }
+    ctx->bounds = bounds;
+
+    // Each thread merges one partition at a time: its output buffer plus a block per run
+    size_t per_thread = budget / threads;
+    size_t out_bytes = (size_t)ctx->chunk_elems * sizeof(double);
+    size_t block = per_thread > out_bytes ? (per_thread - out_bytes) / (ctx->runs * sizeof(double)) : 0;
+    ctx->block_elems = block < MIN_BLOCK_ELEMS ? MIN_BLOCK_ELEMS : block;
+
+    #pragma omp parallel for schedule(dynamic, 1) reduction(+:errors) if(!errors)
+    for (int p = 0; p < parts; p++) {
+        if (!errors) errors += merge_partition(ctx, p) != 0;
+    }
+    free(bounds);
+    ctx->bounds = NULL;
+    return errors ? -1 : 0;
+}
+
+// Checksums of the chunks that straddle partitions, read back from the output
+static int finish_checksums(const merge_ctx_t* ctx) {
+    const array_header_t* h = ctx->out;
+    int errors = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:errors)
+    for (long c = 0; c < (long)h->num_chunks; c++) {
+        if (ctx->checksummed[c]) continue;
+        uint64_t offset = (uint64_t)c * h->chunk_size;
+        size_t len = (size_t)(h->data_bytes - offset < h->chunk_size ? h->data_bytes - offset : h->chunk_size);
+        char* chunk = (char*)malloc(len);
+        if (!chunk || pread_full(ctx->out_fd, chunk, len, (off_t)(h->data_offset + offset)) != 0) {
+            errors++;
+        } else {
+            ctx->checksums[c] = array_checksum(chunk, len);
+        }
+        free(chunk);
+    }
+    if (!errors && h->num_chunks) {
+        errors += pwrite_full(ctx->out_fd, ctx->checksums, h->num_chunks * sizeof(uint64_t),
+                              (off_t)h->checksum_offset) != 0;
+    }
+    return errors ? -1 : 0;
+}
+
+int external_sort_file(const char* input, const char* output, const external_sort_config_t* config,
+                       external_sort_stats_t* stats) {
+    size_t budget = config && config->memory_budget ? config->memory_budget : EXTERNAL_SORT_DEFAULT_BUDGET;
+    array_header_t in, out;
+    if (array_file_info(input, &in) != 0 || in.dtype != ARRAY_FLOAT64) return -1;
+
+    // Same shape as the input; checksum chunks must hold whole elements
+    size_t shape[ARRAY_MAX_DIMS];
+    for (uint32_t d = 0; d < in.ndim; d++) shape[d] = (size_t)in.shape[d];
+    size_t chunk_size = in.chunk_size % sizeof(double) ? ARRAY_DEFAULT_CHUNK : (size_t)in.chunk_size;
+    if (array_header_init(&out, ARRAY_FLOAT64, (int)in.ndim, shape, (size_t)in.alignment, chunk_size) != 0) {
+        return -1;
+    }
+
+    const uint64_t count = in.data_bytes / sizeof(double);
+    uint64_t run_elems = budget / (3 * sizeof(double));     // Two run buffers and the sort's scratch
+    if (run_elems < MIN_RUN_ELEMS) run_elems = MIN_RUN_ELEMS;
+    if (run_elems > MAX_RUN_ELEMS) run_elems = MAX_RUN_ELEMS;
+    if (run_elems > count) run_elems = count ? count : 1;
+    const long runs = (long)((count + run_elems - 1) / run_elems);
+
+    int in_fd = open(input, O_RDONLY);
+    int out_fd = open(output, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    int run_fd = count ? open_run_file(config ? config->tmp_dir : NULL) : -1;
+    double* samples = (double*)malloc((runs + 1) * SAMPLES_PER_RUN * sizeof(double));
+    const uint64_t chunk_elems = (chunk_size ? chunk_size : ARRAY_DEFAULT_CHUNK) / sizeof(double);
+    uint64_t* checksums = (uint64_t*)malloc((out.num_chunks + 1) * sizeof(uint64_t));
+    unsigned char* checksummed = (unsigned char*)calloc(out.num_chunks + 1, 1);
+    int errors = in_fd < 0 || out_fd < 0 || (count && run_fd < 0) || !samples || !checksums || !checksummed;
+    off_t end = (off_t)(out.checksum_offset + out.num_chunks * sizeof(uint64_t));
+    if (!errors) errors += ftruncate(out_fd, end) != 0 || pwrite_full(out_fd, &out, sizeof(out), 0) != 0;
+
+    double start = omp_get_wtime();
+    if (!errors && count) errors += sort_runs(in_fd, &in, run_fd, runs, run_elems, samples) != 0;
+    double runs_done = omp_get_wtime();
+
+    merge_ctx_t ctx = { run_fd, out_fd, runs, run_elems, count, PARTITIONS_PER_THREAD * omp_get_max_threads(),
+                        NULL, 0, &out, chunk_elems, checksums, checksummed };
+    if (!errors && count) errors += merge_runs(&ctx, samples, budget) != 0;
+    if (!errors) errors += finish_checksums(&ctx) != 0;
+    double merge_done = omp_get_wtime();
+
+    if (stats) {
+        stats->runs = runs;
+        stats->partitions = ctx.partitions;
+        stats->run_seconds = runs_done - start;
+        stats->merge_seconds = merge_done - runs_done;
+    }
+    free(samples);
+    free(checksums);
+    free(checksummed);
+    if (in_fd >= 0) close(in_fd);
+    if (run_fd >= 0) close(run_fd);
+    if (out_fd >= 0 && close(out_fd) != 0) errors++;
+    return errors ? -1 : 0;
+}
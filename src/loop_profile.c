@@ -0,0 +1,122 @@
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "../include/loop_profile.h"
+
+int loop_profile_init(loop_profile_t* profile, const char* name) {
+    snprintf(profile->name, sizeof(profile->name), "%s", name);
+    profile->capacity = omp_get_max_threads();
+    profile->threads = 0;
+    profile->stats = (loop_thread_stats_t*)aligned_alloc(64, profile->capacity * sizeof(loop_thread_stats_t));
+    if (!profile->stats) {
+        profile->capacity = 0;
+        return -1;
+    }
+    memset(profile->stats, 0, profile->capacity * sizeof(loop_thread_stats_t));
+    return 0;
+}
+
+void loop_profile_free(loop_profile_t* profile) {
+    free(profile->stats);
+    profile->stats = NULL;
+    profile->capacity = 0;
+    profile->threads = 0;
+}
+
+void loop_profile_thread_begin(loop_profile_t* profile) {
+    if (!profile) return;
+    int t = omp_get_thread_num();
+    if (t == 0) profile->threads = omp_get_num_threads();
+    if (t >= profile->capacity) return;
+
+    loop_thread_stats_t* s = &profile->stats[t];
+    s->iterations = 0;
+    s->chunks = 0;
+    s->next = -1;
+    s->start = omp_get_wtime();
+    s->finish = s->released = s->start;
+}
+
+void loop_profile_thread_end(loop_profile_t* profile) {
+    if (!profile) return;
+    int t = omp_get_thread_num();
+    double finish = omp_get_wtime();
+
+    #pragma omp barrier
+
+    if (t >= profile->capacity) return;
+    profile->stats[t].finish = finish;
+    profile->stats[t].released = omp_get_wtime();
+}
+
+void loop_profile_for(loop_profile_t* profile, long n, omp_sched_t kind, int chunk,
+                      void (*body)(long i, void* arg), void* arg) {
+    omp_sched_t saved_kind;
+    int saved_chunk;
+    omp_get_schedule(&saved_kind, &saved_chunk);
+    omp_set_schedule(kind, chunk);
+
+    #pragma omp parallel
+    {
+        loop_profile_thread_begin(profile);
+
+        #pragma omp for schedule(runtime) nowait
+        for (long i = 0; i < n; i++) {
+            loop_profile_iteration(profile, i);
+            body(i, arg);
+        }
+
+        loop_profile_thread_end(profile);
+    }
+
+    omp_set_schedule(saved_kind, saved_chunk);
+}
+
+void loop_profile_summarize(const loop_profile_t* profile, loop_profile_summary_t* summary) {
+    memset(summary, 0, sizeof(*summary));
+    int threads = profile->threads < profile->capacity ? profile->threads : profile->capacity;
+    if (threads <= 0) return;
+
+    double first = profile->stats[0].start;
+    double last = profile->stats[0].released;
+    double busy_sum = 0.0, idle_sum = 0.0;
+    summary->threads = threads;
+    summary->busy_min = profile->stats[0].finish - profile->stats[0].start;
+
+    for (int t = 0; t < threads; t++) {
+        const loop_thread_stats_t* s = &profile->stats[t];
+        double busy = s->finish - s->start;
+        double idle = s->released - s->finish;
+
+        if (s->start < first) first = s->start;
+        if (s->released > last) last = s->released;
+        if (busy > summary->busy_max) summary->busy_max = busy;
+        if (busy < summary->busy_min) summary->busy_min = busy;
+        busy_sum += busy;
+        idle_sum += idle;
+        summary->iterations += s->iterations;
+        summary->chunks += s->chunks;
+    }
+
+    summary->wall = last - first;
+    summary->busy_mean = busy_sum / threads;
+    summary->imbalance = summary->busy_mean > 0.0 ? summary->busy_max / summary->busy_mean : 1.0;
+    summary->idle_fraction = busy_sum + idle_sum > 0.0 ? idle_sum / (busy_sum + idle_sum) : 0.0;
+}
+
+void loop_profile_print(FILE* out, const loop_profile_t* profile) {
+    loop_profile_summary_t sum;
+    loop_profile_summarize(profile, &sum);
+
+    fprintf(out, "Load balance of %s (%d threads):\n", profile->name, sum.threads);
+    fprintf(out, "  %6s %12s %12s %12s %8s\n", "thread", "busy(ms)", "idle(ms)", "iterations", "chunks");
+    for (int t = 0; t < sum.threads; t++) {
+        const loop_thread_stats_t* s = &profile->stats[t];
+        fprintf(out, "  %6d %12.3f %12.3f %12ld %8ld\n", t, (s->finish - s->start) * 1e3,
+                (s->released - s->finish) * 1e3, s->iterations, s->chunks);
+    }
+    fprintf(out, "  busy max/mean/min %.3f/%.3f/%.3f ms, imbalance %.3f, idle at barrier %.1f%%, "
+                 "%ld iterations in %ld chunks\n",
+            sum.busy_max * 1e3, sum.busy_mean * 1e3, sum.busy_min * 1e3, sum.imbalance,
+            sum.idle_fraction * 100.0, sum.iterations, sum.chunks);
+}
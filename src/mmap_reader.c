@@ -0,0 +1,97 @@
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <omp.h>
+#include "../include/mmap_reader.h"
+
+mmap_file_t* mmap_file_open(const char* path, int flags) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    mmap_file_t* file = (mmap_file_t*)calloc(1, sizeof(mmap_file_t));
+    if (!file || fstat(fd, &st) != 0) {
+        free(file);
+        close(fd);
+        return NULL;
+    }
+    file->fd = fd;
+    file->size = st.st_size;
+    if (file->size == 0) return file;
+
+    int map_flags = MAP_PRIVATE | (flags & MMAP_POPULATE ? MAP_POPULATE : 0);
+    void* data = mmap(NULL, file->size, PROT_READ, map_flags, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        free(file);
+        return NULL;
+    }
+    file->data = (const char*)data;
+
+    // Hints are best effort, a failure only costs performance
+    if (flags & MMAP_SEQUENTIAL) madvise(data, file->size, MADV_SEQUENTIAL);
+    if (flags & MMAP_WILLNEED) madvise(data, file->size, MADV_WILLNEED);
+    if (flags & MMAP_PREFAULT) mmap_file_prefault(file);
+    return file;
+}
+
+void mmap_file_close(mmap_file_t* file) {
+    if (!file) return;
+    if (file->data) munmap((void*)file->data, file->size);
+    close(file->fd);
+    free(file);
+}
+
+long mmap_file_prefault(const mmap_file_t* file) {
+    const long page = sysconf(_SC_PAGESIZE);
+    const long pages = (long)((file->size + page - 1) / page);
+    const volatile char* data = file->data;
+    unsigned sum = 0;
+
+    // Contiguous blocks per thread keep each thread's faults sequential for read-ahead
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (long p = 0; p < pages; p++) {
+        sum += (unsigned char)data[p * page];
+    }
+    (void)sum;
+    return pages;
+}
+
+long mmap_file_views(const mmap_file_t* file, size_t chunk_size, mmap_view_t* views, long max_views) {
+    long count = (long)((file->size + chunk_size - 1) / chunk_size);
+    for (long i = 0; views && i < count && i < max_views; i++) {
+        size_t offset = (size_t)i * chunk_size;
+        views[i].data = file->data + offset;
+        views[i].offset = offset;
+        views[i].size = file->size - offset < chunk_size ? file->size - offset : chunk_size;
+    }
+    return count;
+}
+
+void mmap_file_split_lines(const mmap_file_t* file, int parts, mmap_view_t* views) {
+    size_t start = 0;
+    for (int i = 0; i < parts; i++) {
+        size_t end = i == parts - 1 ? file->size : file->size / parts * (i + 1);
+        if (end < start) end = start;
+        // Move the cut just past the next newline
+        if (end < file->size && end > 0) {
+            const char* nl = (const char*)memchr(file->data + end - 1, '\n', file->size - end + 1);
+            end = nl ? (size_t)(nl - file->data) + 1 : file->size;
+        }
+        views[i].data = file->data + start;
+        views[i].offset = start;
+        views[i].size = end - start;
+        start = end;
+    }
+}
+
+int mmap_file_evict(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    int status = fdatasync(fd) == 0 && posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0 ? 0 : -1;
+    close(fd);
+    return status;
+}
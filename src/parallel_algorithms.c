@@ -116,17 +116,25 @@ void mergesort_parallel(double* arr, double* temp, int left, int right, int dept
     }
 }
 
+/**
+ * Task-based sort for callers already inside a parallel region
+ * @param arr Array to sort
+ * @param temp Scratch space of size elements
+ * @param size Array size
+ */
+void parallel_sort_tasks(double* arr, double* temp, int size) {
+    mergesort_parallel(arr, temp, 0, size - 1, omp_get_max_threads());
+}
+
 void parallel_sort(double* arr, int size) {
     double* temp = (double*)malloc(size * sizeof(double));
     if (!temp) return;
     
-    int max_depth = omp_get_max_threads();
-    
     #pragma omp parallel
     {
         #pragma omp single nowait
         {
-            mergesort_parallel(arr, temp, 0, size - 1, max_depth);
+            parallel_sort_tasks(arr, temp, size);
         }
     }
     
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <omp.h>
+#include "../include/perf_counters.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+static const char* event_names[PERF_NUM_EVENTS] = {
+    "cycles", "instructions", "llc_misses", "branch_misses"
+};
+
+const char* perf_event_name(int id) {
+    return (id >= 0 && id < PERF_NUM_EVENTS) ? event_names[id] : "unknown";
+}
+
+#ifdef __linux__
+
+static const unsigned long long event_configs[PERF_NUM_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+// Count the calling thread only, user space only (works with perf_event_paranoid <= 2)
+static int open_counter(unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+int perf_session_open(perf_session_t* session, int num_threads) {
+    if (num_threads > PERF_MAX_THREADS) num_threads = PERF_MAX_THREADS;
+    if (num_threads < 1) num_threads = 1;
+
+    session->num_threads = num_threads;
+    session->available = 0;
+    session->error[0] = '\0';
+    for (int t = 0; t < PERF_MAX_THREADS; t++) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) session->fds[t][e] = -1;
+    }
+
+    int opened = 0;
+    int last_errno = 0;
+
+    #pragma omp parallel num_threads(num_threads) reduction(+:opened)
+    {
+        int t = omp_get_thread_num();
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            int fd = open_counter(event_configs[e]);
+            if (fd >= 0) {
+                session->fds[t][e] = fd;
+                opened++;
+            } else {
+                #pragma omp atomic write
+                last_errno = errno;
+            }
+        }
+    }
+
+    session->available = opened;
+    if (!opened) {
+        snprintf(session->error, sizeof(session->error), "perf_event_open: %s%s",
+                 strerror(last_errno),
+                 last_errno == EACCES || last_errno == EPERM
+                     ? " (check /proc/sys/kernel/perf_event_paranoid)" : "");
+    }
+    return opened;
+}
+
+static void ioctl_all(perf_session_t* session, unsigned long request) {
+    for (int t = 0; t < session->num_threads; t++) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            if (session->fds[t][e] >= 0) ioctl(session->fds[t][e], request, 0);
+        }
+    }
+}
+
+void perf_session_start(perf_session_t* session) {
+    if (session->available) ioctl_all(session, PERF_EVENT_IOC_ENABLE);
+}
+
+void perf_session_stop(perf_session_t* session) {
+    if (session->available) ioctl_all(session, PERF_EVENT_IOC_DISABLE);
+}
+
+void perf_session_read(perf_session_t* session, perf_values_t* per_thread, perf_values_t* total) {
+    perf_values_t sum;
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) sum.count[e] = -1.0;
+
+    for (int t = 0; t < session->num_threads; t++) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            double value = -1.0;
+            unsigned long long buf[3];  // value, time_enabled, time_running
+
+            int fd = session->fds[t][e];
+            if (fd >= 0 && read(fd, buf, sizeof(buf)) == (ssize_t)sizeof(buf)) {
+                value = (double)buf[0];
+                if (buf[2] > 0 && buf[2] < buf[1]) value *= (double)buf[1] / buf[2];
+            }
+
+            if (per_thread) per_thread[t].count[e] = value;
+            if (value >= 0.0) sum.count[e] = (sum.count[e] < 0.0 ? 0.0 : sum.count[e]) + value;
+        }
+    }
+
+    if (total) *total = sum;
+}
+
+void perf_session_close(perf_session_t* session) {
+    for (int t = 0; t < session->num_threads; t++) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            if (session->fds[t][e] >= 0) close(session->fds[t][e]);
+            session->fds[t][e] = -1;
+        }
+    }
+    session->available = 0;
+}
+
+#else // !__linux__
+
+int perf_session_open(perf_session_t* session, int num_threads) {
+    session->num_threads = num_threads < PERF_MAX_THREADS ? num_threads : PERF_MAX_THREADS;
+    session->available = 0;
+    snprintf(session->error, sizeof(session->error), "perf_event_open requires Linux");
+    return 0;
+}
+
+void perf_session_start(perf_session_t* session) { (void)session; }
+
+void perf_session_stop(perf_session_t* session) { (void)session; }
+
+void perf_session_read(perf_session_t* session, perf_values_t* per_thread, perf_values_t* total) {
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        for (int t = 0; per_thread && t < session->num_threads; t++) per_thread[t].count[e] = -1.0;
+        if (total) total->count[e] = -1.0;
+    }
+}
+
+void perf_session_close(perf_session_t* session) { (void)session; }
+
+#endif // __linux__
@@ -0,0 +1,232 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/reduce_state.h"
+
+#define PARALLEL_THRESHOLD 16384    // Smaller chunks are not worth a parallel region
+#define SUM_LANES 4                 // Independent accumulators per thread
+#define CACHE_LINE_WORDS 8
+
+static int update_threads(size_t n) {
+    return n < PARALLEL_THRESHOLD ? 1 : omp_get_max_threads();
+}
+
+// Contiguous slice of thread t out of nt
+static void slice(size_t n, int t, int nt, size_t* begin, size_t* end) {
+    *begin = n * t / nt;
+    *end = n * (t + 1) / nt;
+}
+
+static void sum_add(reduce_sum_t* s, double x) {
+    double t = s->sum + x;
+    if (fabs(s->sum) >= fabs(x)) {
+        s->compensation += (s->sum - t) + x;
+    } else {
+        s->compensation += (x - t) + s->sum;
+    }
+    s->sum = t;
+}
+
+// Compensated sum of a slice, skipping NaN; lanes keep several additions in flight
+static reduce_sum_t sum_slice(const double* x, size_t n) {
+    reduce_sum_t lanes[SUM_LANES];
+    memset(lanes, 0, sizeof(lanes));
+    size_t i = 0;
+    for (; i + SUM_LANES <= n; i += SUM_LANES) {
+        for (int l = 0; l < SUM_LANES; l++) {
+            if (x[i + l] == x[i + l]) sum_add(&lanes[l], x[i + l]);
+        }
+    }
+    for (; i < n; i++) {
+        if (x[i] == x[i]) sum_add(&lanes[0], x[i]);
+    }
+    for (int l = 1; l < SUM_LANES; l++) reduce_sum_merge(&lanes[0], &lanes[l]);
+    return lanes[0];
+}
+
+void reduce_sum_init(reduce_sum_t* s) {
+    s->sum = 0.0;
+    s->compensation = 0.0;
+}
+
+void reduce_sum_merge(reduce_sum_t* into, const reduce_sum_t* from) {
+    sum_add(into, from->sum);
+    into->compensation += from->compensation;
+}
+
+double reduce_sum_value(const reduce_sum_t* s) {
+    return s->sum + s->compensation;
+}
+
+void reduce_sum_update(reduce_sum_t* s, const double* x, size_t n) {
+    const int threads = update_threads(n);
+    reduce_sum_t* partial = threads > 1 ? (reduce_sum_t*)calloc(threads, sizeof(reduce_sum_t)) : NULL;
+    if (!partial) {
+        reduce_sum_t chunk = sum_slice(x, n);
+        reduce_sum_merge(s, &chunk);
+        return;
+    }
+
+    #pragma omp parallel num_threads(threads)
+    {
+        size_t begin, end;
+        slice(n, omp_get_thread_num(), omp_get_num_threads(), &begin, &end);
+        partial[omp_get_thread_num()] = sum_slice(x + begin, end - begin);
+    }
+    // Thread order, so the rounding does not depend on which thread finished first
+    for (int t = 0; t < threads; t++) reduce_sum_merge(s, &partial[t]);
+    free(partial);
+}
+
+void reduce_stats_init(reduce_stats_t* s) {
+    memset(s, 0, sizeof(*s));
+    s->min = INFINITY;
+    s->max = -INFINITY;
+}
+
+// Exact statistics of one slice: count, sum, min and max, then the squared
+// deviations from the slice mean (corrected two-pass algorithm)
+static void stats_slice(reduce_stats_t* s, const double* x, size_t n) {
+    reduce_stats_init(s);
+    double lo = INFINITY, hi = -INFINITY;
+    uint64_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        double v = x[i];
+        if (v != v) continue;
+        count++;
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+    }
+    s->nans = n - count;
+    if (!count) return;
+    s->count = count;
+    s->min = lo;
+    s->max = hi;
+    s->sum = sum_slice(x, n);
+    s->mean = reduce_sum_value(&s->sum) / (double)count;
+
+    double squares = 0.0, deviations = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        if (x[i] != x[i]) continue;
+        double d = x[i] - s->mean;
+        squares += d * d;
+        deviations += d;
+    }
+    s->m2 = squares - deviations * deviations / (double)count;
+}
+
+void reduce_stats_merge(reduce_stats_t* into, const reduce_stats_t* from) {
+    into->nans += from->nans;
+    if (!from->count) return;
+    if (!into->count) {
+        uint64_t nans = into->nans;
+        *into = *from;
+        into->nans = nans;
+        return;
+    }
+
+    const double na = (double)into->count, nb = (double)from->count, n = na + nb;
+    const double delta = from->mean - into->mean;
+    into->m2 += from->m2 + delta * delta * na * nb / n;
+    into->count += from->count;
+    reduce_sum_merge(&into->sum, &from->sum);
+    into->mean = reduce_sum_value(&into->sum) / (double)into->count;
+    if (from->min < into->min) into->min = from->min;
+    if (from->max > into->max) into->max = from->max;
+}
+
+void reduce_stats_update(reduce_stats_t* s, const double* x, size_t n) {
+    const int threads = update_threads(n);
+    reduce_stats_t* partial = threads > 1 ? (reduce_stats_t*)malloc(threads * sizeof(reduce_stats_t)) : NULL;
+    if (!partial) {
+        reduce_stats_t chunk;
+        stats_slice(&chunk, x, n);
+        reduce_stats_merge(s, &chunk);
+        return;
+    }
+
+    for (int t = 0; t < threads; t++) reduce_stats_init(&partial[t]);
+    #pragma omp parallel num_threads(threads)
+    {
+        size_t begin, end;
+        slice(n, omp_get_thread_num(), omp_get_num_threads(), &begin, &end);
+        stats_slice(&partial[omp_get_thread_num()], x + begin, end - begin);
+    }
+    for (int t = 0; t < threads; t++) reduce_stats_merge(s, &partial[t]);
+    free(partial);
+}
+
+double reduce_stats_variance(const reduce_stats_t* s, int ddof) {
+    if (s->count <= (uint64_t)(ddof < 0 ? 0 : ddof)) return NAN;
+    return s->m2 / (double)(s->count - ddof);
+}
+
+int reduce_hist_init(reduce_hist_t* h, double lo, double hi, int bins) {
+    memset(h, 0, sizeof(*h));
+    if (bins <= 0 || !(hi > lo)) return -1;
+    h->counts = (uint64_t*)calloc(bins, sizeof(uint64_t));
+    if (!h->counts) return -1;
+    h->lo = lo;
+    h->hi = hi;
+    h->bins = bins;
+    return 0;
+}
+
+// Count a slice into bins counts, below and above; NaN fails every test
+static void hist_slice(const reduce_hist_t* h, uint64_t* counts, uint64_t* below, uint64_t* above,
+                       const double* x, size_t n) {
+    const double scale = h->bins / (h->hi - h->lo);
+    for (size_t i = 0; i < n; i++) {
+        double v = x[i];
+        if (v < h->lo) {
+            (*below)++;
+        } else if (v >= h->hi) {
+            (*above)++;
+        } else if (v == v) {
+            int b = (int)((v - h->lo) * scale);
+            counts[b < h->bins ? b : h->bins - 1]++;    // Rounding at the top edge
+        }
+    }
+}
+
+void reduce_hist_update(reduce_hist_t* h, const double* x, size_t n) {
+    const int threads = update_threads(n);
+    // Private rows of bins counts, below and above, padded to cache lines and summed once at the end
+    const size_t stride = ((size_t)h->bins + 2 + CACHE_LINE_WORDS - 1) / CACHE_LINE_WORDS * CACHE_LINE_WORDS;
+    uint64_t* rows = threads > 1 ? (uint64_t*)calloc(threads * stride, sizeof(uint64_t)) : NULL;
+    if (!rows) {
+        hist_slice(h, h->counts, &h->below, &h->above, x, n);
+        return;
+    }
+
+    #pragma omp parallel num_threads(threads)
+    {
+        size_t begin, end;
+        slice(n, omp_get_thread_num(), omp_get_num_threads(), &begin, &end);
+        uint64_t* row = rows + omp_get_thread_num() * stride;
+        hist_slice(h, row, row + h->bins, row + h->bins + 1, x + begin, end - begin);
+    }
+    for (int t = 0; t < threads; t++) {
+        const uint64_t* row = rows + t * stride;
+        for (int b = 0; b < h->bins; b++) h->counts[b] += row[b];
+        h->below += row[h->bins];
+        h->above += row[h->bins + 1];
+    }
+    free(rows);
+}
+
+int reduce_hist_merge(reduce_hist_t* into, const reduce_hist_t* from) {
+    if (into->bins != from->bins || into->lo != from->lo || into->hi != from->hi) return -1;
+    for (int b = 0; b < into->bins; b++) into->counts[b] += from->counts[b];
+    into->below += from->below;
+    into->above += from->above;
+    return 0;
+}
+
+void reduce_hist_free(reduce_hist_t* h) {
+    if (!h) return;
+    free(h->counts);
+    h->counts = NULL;
+    h->bins = 0;
+}
@@ -0,0 +1,214 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "../include/ring_buffer.h"
+
+#define CACHE_LINE 64
+
+static size_t round_capacity(size_t capacity, size_t minimum) {
+    size_t size = minimum;
+    while (size < capacity) size <<= 1;
+    return size;
+}
+
+// ---- Single producer, single consumer ----
+
+struct ring_spsc {
+    void** items;
+    size_t mask;
+    char pad0[CACHE_LINE - sizeof(void**) - sizeof(size_t)];
+    atomic_size_t tail;     // Written by the producer
+    size_t cached_head;     // Producer's last view of head
+    char pad1[CACHE_LINE - sizeof(atomic_size_t) - sizeof(size_t)];
+    atomic_size_t head;     // Written by the consumer
+    size_t cached_tail;     // Consumer's last view of tail
+    char pad2[CACHE_LINE - sizeof(atomic_size_t) - sizeof(size_t)];
+};
+
+ring_spsc_t* ring_spsc_create(size_t capacity) {
+    ring_spsc_t* ring = (ring_spsc_t*)aligned_alloc(CACHE_LINE, sizeof(ring_spsc_t));
+    if (!ring) return NULL;
+
+    size_t size = round_capacity(capacity, 1);
+    ring->items = (void**)malloc(size * sizeof(void*));
+    if (!ring->items) {
+        free(ring);
+        return NULL;
+    }
+    ring->mask = size - 1;
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->head, 0);
+    ring->cached_head = 0;
+    ring->cached_tail = 0;
+    return ring;
+}
+
+void ring_spsc_destroy(ring_spsc_t* ring) {
+    if (!ring) return;
+    free(ring->items);
+    free(ring);
+}
+
+// Free cells as seen by the producer, refreshing its view of head when fewer than wanted
+static size_t spsc_free(ring_spsc_t* ring, size_t tail, size_t wanted) {
+    size_t free_cells = ring->mask + 1 - (tail - ring->cached_head);
+    if (free_cells < wanted) {
+        ring->cached_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        free_cells = ring->mask + 1 - (tail - ring->cached_head);
+    }
+    return free_cells;
+}
+
+// Items available to the consumer, refreshing its view of tail when fewer than wanted
+static size_t spsc_used(ring_spsc_t* ring, size_t head, size_t wanted) {
+    size_t used = ring->cached_tail - head;
+    if (used < wanted) {
+        ring->cached_tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        used = ring->cached_tail - head;
+    }
+    return used;
+}
+
+int ring_spsc_push(ring_spsc_t* ring, void* item) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if (spsc_free(ring, tail, 1) == 0) return 0;
+    ring->items[tail & ring->mask] = item;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+int ring_spsc_pop(ring_spsc_t* ring, void** item) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (spsc_used(ring, head, 1) == 0) return 0;
+    *item = ring->items[head & ring->mask];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return 1;
+}
+
+size_t ring_spsc_push_batch(ring_spsc_t* ring, void* const* items, size_t n) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t free_cells = spsc_free(ring, tail, n);
+    if (n > free_cells) n = free_cells;
+    for (size_t i = 0; i < n; i++) ring->items[(tail + i) & ring->mask] = items[i];
+    if (n) atomic_store_explicit(&ring->tail, tail + n, memory_order_release);
+    return n;
+}
+
+size_t ring_spsc_pop_batch(ring_spsc_t* ring, void** items, size_t max) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t used = spsc_used(ring, head, max);
+    if (max > used) max = used;
+    for (size_t i = 0; i < max; i++) items[i] = ring->items[(head + i) & ring->mask];
+    if (max) atomic_store_explicit(&ring->head, head + max, memory_order_release);
+    return max;
+}
+
+size_t ring_spsc_capacity(const ring_spsc_t* ring) {
+    return ring->mask + 1;
+}
+
+// ---- Multi producer, multi consumer (Vyukov) ----
+
+// A cell is free for the push at position p when seq == p, and holds the
+// item for the pop at position p when seq == p + 1
+typedef struct {
+    atomic_size_t seq;
+    void* item;
+} mpmc_cell_t;
+
+struct ring_mpmc {
+    mpmc_cell_t* cells;
+    size_t mask;
+    char pad0[CACHE_LINE - sizeof(mpmc_cell_t*) - sizeof(size_t)];
+    atomic_size_t tail;     // Next push position
+    char pad1[CACHE_LINE - sizeof(atomic_size_t)];
+    atomic_size_t head;     // Next pop position
+    char pad2[CACHE_LINE - sizeof(atomic_size_t)];
+};
+
+ring_mpmc_t* ring_mpmc_create(size_t capacity) {
+    ring_mpmc_t* ring = (ring_mpmc_t*)aligned_alloc(CACHE_LINE, sizeof(ring_mpmc_t));
+    if (!ring) return NULL;
+
+    size_t size = round_capacity(capacity, 2);
+    ring->cells = (mpmc_cell_t*)malloc(size * sizeof(mpmc_cell_t));
+    if (!ring->cells) {
+        free(ring);
+        return NULL;
+    }
+    ring->mask = size - 1;
+    for (size_t i = 0; i < size; i++) atomic_init(&ring->cells[i].seq, i);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->head, 0);
+    return ring;
+}
+
+void ring_mpmc_destroy(ring_mpmc_t* ring) {
+    if (!ring) return;
+    free(ring->cells);
+    free(ring);
+}
+
+// Claim up to n consecutive cells from *index whose seq equals position + offset.
+// Cells are checked before the CAS; once it succeeds no other thread can
+// touch them until this one publishes their new sequence numbers.
+static size_t mpmc_claim(ring_mpmc_t* ring, atomic_size_t* index, size_t offset, size_t n, size_t* start) {
+    if (n == 0) return 0;
+    size_t pos = atomic_load_explicit(index, memory_order_relaxed);
+    for (;;) {
+        size_t ready = 0;
+        while (ready < n) {
+            mpmc_cell_t* cell = &ring->cells[(pos + ready) & ring->mask];
+            size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+            if (seq != pos + ready + offset) break;
+            ready++;
+        }
+
+        if (ready == 0) {
+            // Either full/empty, or another thread moved the index: check which
+            size_t seq = atomic_load_explicit(&ring->cells[pos & ring->mask].seq, memory_order_acquire);
+            if ((long)(seq - (pos + offset)) < 0) return 0;
+            pos = atomic_load_explicit(index, memory_order_relaxed);
+            continue;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(index, &pos, pos + ready,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            *start = pos;
+            return ready;
+        }
+    }
+}
+
+int ring_mpmc_push(ring_mpmc_t* ring, void* item) {
+    return (int)ring_mpmc_push_batch(ring, &item, 1);
+}
+
+int ring_mpmc_pop(ring_mpmc_t* ring, void** item) {
+    return (int)ring_mpmc_pop_batch(ring, item, 1);
+}
+
+size_t ring_mpmc_push_batch(ring_mpmc_t* ring, void* const* items, size_t n) {
+    size_t start;
+    size_t claimed = mpmc_claim(ring, &ring->tail, 0, n, &start);
+    for (size_t i = 0; i < claimed; i++) {
+        mpmc_cell_t* cell = &ring->cells[(start + i) & ring->mask];
+        cell->item = items[i];
+        atomic_store_explicit(&cell->seq, start + i + 1, memory_order_release);
+    }
+    return claimed;
+}
+
+size_t ring_mpmc_pop_batch(ring_mpmc_t* ring, void** items, size_t max) {
+    size_t start;
+    size_t claimed = mpmc_claim(ring, &ring->head, 1, max, &start);
+    for (size_t i = 0; i < claimed; i++) {
+        mpmc_cell_t* cell = &ring->cells[(start + i) & ring->mask];
+        items[i] = cell->item;
+        atomic_store_explicit(&cell->seq, start + i + ring->mask + 1, memory_order_release);
+    }
+    return claimed;
+}
+
+size_t ring_mpmc_capacity(const ring_mpmc_t* ring) {
+    return ring->mask + 1;
+}
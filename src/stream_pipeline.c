@@ -0,0 +1,295 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <omp.h>
+#include "../include/stream_pipeline.h"
+#include "../include/ring_buffer.h"
+
+#define YIELD_AFTER 64  // Idle polls before giving the CPU away
+
+typedef struct {
+    char name[STREAM_NAME_LEN];
+    stream_stage_mode_t mode;
+    stream_stage_fn fn;
+    void* arg;
+    ring_mpmc_t* queue;             // Input of a parallel stage
+    _Atomic(stream_chunk_t*)* slots; // Input of a serial stage, indexed by seq % num_chunks
+    long next_seq;                  // Next chunk of a serial stage, owned by the drainer
+    atomic_int draining;            // A thread is running the serial stage
+    long chunks;
+    double busy;
+} stage_t;
+
+struct stream_pipeline {
+    int num_chunks;
+    size_t capacity;
+    stream_chunk_t* chunks;
+    char* memory;
+    ring_mpmc_t* free_chunks;
+
+    char source_name[STREAM_NAME_LEN];
+    stream_source_fn source;
+    void* source_arg;
+    atomic_int source_busy;         // A thread is running the source
+    atomic_int source_done;
+    long produced;                  // Chunks produced, owned by the source thread
+    long source_chunks;
+    double source_busy_time;
+
+    int num_stages;                 // Stages after the source
+    stage_t stages[STREAM_MAX_STAGES];
+
+    atomic_long total;              // Chunks of the stream, valid once source_done is set
+    atomic_long completed;          // Chunks that left the last stage
+    atomic_int error;
+};
+
+stream_pipeline_t* stream_pipeline_create(int num_chunks, size_t chunk_capacity) {
+    if (num_chunks <= 0 || chunk_capacity == 0) return NULL;
+
+    stream_pipeline_t* p = (stream_pipeline_t*)calloc(1, sizeof(stream_pipeline_t));
+    if (!p) return NULL;
+    p->num_chunks = num_chunks;
+    p->capacity = chunk_capacity;
+    p->chunks = (stream_chunk_t*)calloc(num_chunks, sizeof(stream_chunk_t));
+    p->memory = (char*)malloc(2 * chunk_capacity * num_chunks);
+    p->free_chunks = ring_mpmc_create(num_chunks);
+    if (!p->chunks || !p->memory || !p->free_chunks) {
+        stream_pipeline_destroy(p);
+        return NULL;
+    }
+
+    for (int i = 0; i < num_chunks; i++) {
+        p->chunks[i].capacity = chunk_capacity;
+        p->chunks[i].data = p->memory + 2 * i * chunk_capacity;
+        p->chunks[i].scratch = p->chunks[i].data + chunk_capacity;
+    }
+    snprintf(p->source_name, sizeof(p->source_name), "source");
+    return p;
+}
+
+void stream_pipeline_destroy(stream_pipeline_t* pipeline) {
+    if (!pipeline) return;
+    for (int k = 0; k < pipeline->num_stages; k++) {
+        ring_mpmc_destroy(pipeline->stages[k].queue);
+        free(pipeline->stages[k].slots);
+    }
+    ring_mpmc_destroy(pipeline->free_chunks);
+    free(pipeline->chunks);
+    free(pipeline->memory);
+    free(pipeline);
+}
+
+void stream_pipeline_source(stream_pipeline_t* pipeline, const char* name, stream_source_fn fn, void* arg) {
+    snprintf(pipeline->source_name, sizeof(pipeline->source_name), "%s", name);
+    pipeline->source = fn;
+    pipeline->source_arg = arg;
+}
+
+int stream_pipeline_add_stage(stream_pipeline_t* pipeline, const char* name, stream_stage_mode_t mode,
+                              stream_stage_fn fn, void* arg) {
+    if (pipeline->num_stages >= STREAM_MAX_STAGES) return -1;
+
+    stage_t* s = &pipeline->stages[pipeline->num_stages];
+    memset(s, 0, sizeof(*s));
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    s->mode = mode;
+    s->fn = fn;
+    s->arg = arg;
+    if (mode == STREAM_SERIAL) {
+        s->slots = (_Atomic(stream_chunk_t*)*)calloc(pipeline->num_chunks, sizeof(*s->slots));
+        if (!s->slots) return -1;
+    } else {
+        s->queue = ring_mpmc_create(pipeline->num_chunks);
+        if (!s->queue) return -1;
+    }
+    pipeline->num_stages++;
+    return 0;
+}
+
+static void deliver(stream_pipeline_t* p, int k, stream_chunk_t* chunk);
+
+static void process(stream_pipeline_t* p, int k, stream_chunk_t* chunk) {
+    stage_t* s = &p->stages[k];
+    if (!atomic_load_explicit(&p->error, memory_order_relaxed)) {
+        double t0 = omp_get_wtime();
+        int status = s->fn(chunk, s->arg);
+        double elapsed = omp_get_wtime() - t0;
+        if (status != 0) atomic_store(&p->error, 1);
+
+        #pragma omp atomic
+        s->busy += elapsed;
+        #pragma omp atomic
+        s->chunks++;
+    }
+    deliver(p, k + 1, chunk);
+}
+
+// Run the serial stage k on every chunk that is next in order. Only one
+// thread drains at a time; a chunk deposited while another thread drains is
+// picked up by that thread's re-check before it leaves.
+static void drain_serial(stream_pipeline_t* p, int k) {
+    stage_t* s = &p->stages[k];
+    for (;;) {
+        if (atomic_exchange(&s->draining, 1)) return;
+
+        stream_chunk_t* chunk;
+        while ((chunk = atomic_load(&s->slots[s->next_seq % p->num_chunks])) != NULL &&
+               chunk->seq == s->next_seq) {
+            atomic_store(&s->slots[s->next_seq % p->num_chunks], NULL);
+            s->next_seq++;
+            process(p, k, chunk);
+        }
+
+        atomic_store(&s->draining, 0);
+        chunk = atomic_load(&s->slots[s->next_seq % p->num_chunks]);
+        if (!chunk || chunk->seq != s->next_seq) return;
+    }
+}
+
+// Hand a chunk to stage k, or back to the pool after the last stage
+static void deliver(stream_pipeline_t* p, int k, stream_chunk_t* chunk) {
+    if (k == p->num_stages) {
+        ring_mpmc_push(p->free_chunks, chunk);
+        atomic_fetch_add(&p->completed, 1);
+        return;
+    }
+
+    stage_t* s = &p->stages[k];
+    if (s->mode == STREAM_SERIAL) {
+        atomic_store(&s->slots[chunk->seq % p->num_chunks], chunk);
+        drain_serial(p, k);
+    } else {
+        ring_mpmc_push(s->queue, chunk);
+    }
+}
+
+// Produce one chunk if nobody else is producing and a free chunk exists
+static int try_source(stream_pipeline_t* p) {
+    if (atomic_load_explicit(&p->source_done, memory_order_acquire)) return 0;
+    if (atomic_exchange(&p->source_busy, 1)) return 0;
+    if (atomic_load(&p->source_done)) {
+        atomic_store(&p->source_busy, 0);
+        return 0;
+    }
+
+    void* item;
+    if (!ring_mpmc_pop(p->free_chunks, &item)) {
+        atomic_store(&p->source_busy, 0);
+        return 0;
+    }
+
+    stream_chunk_t* chunk = (stream_chunk_t*)item;
+    chunk->seq = p->produced;
+    chunk->size = 0;
+    chunk->count = 0;
+    int status = 0;
+    if (!atomic_load(&p->error)) {
+        double t0 = omp_get_wtime();
+        status = p->source(chunk, p->source_arg);
+        p->source_busy_time += omp_get_wtime() - t0;
+    }
+
+    if (status == 1) {
+        p->produced++;
+        p->source_chunks++;
+        atomic_store(&p->source_busy, 0);
+        deliver(p, 0, chunk);
+    } else {
+        if (status < 0) atomic_store(&p->error, 1);
+        ring_mpmc_push(p->free_chunks, chunk);
+        atomic_store(&p->total, p->produced);
+        atomic_store_explicit(&p->source_done, 1, memory_order_release);
+        atomic_store(&p->source_busy, 0);
+    }
+    return 1;
+}
+
+// Process one chunk of the most downstream parallel stage that has work
+static int try_parallel_stage(stream_pipeline_t* p) {
+    for (int k = p->num_stages - 1; k >= 0; k--) {
+        if (p->stages[k].mode != STREAM_PARALLEL) continue;
+        void* chunk;
+        if (ring_mpmc_pop(p->stages[k].queue, &chunk)) {
+            process(p, k, (stream_chunk_t*)chunk);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int finished(stream_pipeline_t* p) {
+    return atomic_load_explicit(&p->source_done, memory_order_acquire) &&
+           atomic_load(&p->completed) == atomic_load(&p->total);
+}
+
+int stream_pipeline_run(stream_pipeline_t* pipeline) {
+    stream_pipeline_t* p = pipeline;
+    if (!p->source) return -1;
+
+    // Every chunk is back in the pool after a run; refill it from scratch anyway
+    void* item;
+    while (ring_mpmc_pop(p->free_chunks, &item)) {}
+    for (int i = 0; i < p->num_chunks; i++) ring_mpmc_push(p->free_chunks, &p->chunks[i]);
+    for (int k = 0; k < p->num_stages; k++) {
+        stage_t* s = &p->stages[k];
+        s->next_seq = 0;
+        s->chunks = 0;
+        s->busy = 0.0;
+        atomic_store(&s->draining, 0);
+        if (s->mode == STREAM_SERIAL) {
+            for (int i = 0; i < p->num_chunks; i++) atomic_store(&s->slots[i], NULL);
+        }
+    }
+    p->produced = 0;
+    p->source_chunks = 0;
+    p->source_busy_time = 0.0;
+    atomic_store(&p->source_busy, 0);
+    atomic_store(&p->source_done, 0);
+    atomic_store(&p->total, 0);
+    atomic_store(&p->completed, 0);
+    atomic_store(&p->error, 0);
+
+    #pragma omp parallel
+    {
+        int idle = 0;
+        while (!finished(p)) {
+            if (try_parallel_stage(p) || try_source(p)) {
+                idle = 0;
+            } else if (++idle >= YIELD_AFTER) {
+                sched_yield();
+                idle = 0;
+            }
+        }
+    }
+
+    return atomic_load(&p->error) ? -1 : 0;
+}
+
+int stream_pipeline_stats(const stream_pipeline_t* pipeline, stream_stage_stats_t* stats) {
+    snprintf(stats[0].name, sizeof(stats[0].name), "%s", pipeline->source_name);
+    stats[0].mode = STREAM_SERIAL;
+    stats[0].chunks = pipeline->source_chunks;
+    stats[0].busy = pipeline->source_busy_time;
+
+    for (int k = 0; k < pipeline->num_stages; k++) {
+        const stage_t* s = &pipeline->stages[k];
+        snprintf(stats[k + 1].name, sizeof(stats[k + 1].name), "%s", s->name);
+        stats[k + 1].mode = s->mode;
+        stats[k + 1].chunks = s->chunks;
+        stats[k + 1].busy = s->busy;
+    }
+    return pipeline->num_stages + 1;
+}
+
+int stream_pipeline_stages(const stream_pipeline_t* pipeline) {
+    return pipeline->num_stages + 1;
+}
+
+void stream_chunk_swap(stream_chunk_t* chunk) {
+    char* tmp = chunk->data;
+    chunk->data = chunk->scratch;
+    chunk->scratch = tmp;
+}
@@ -0,0 +1,264 @@
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "../include/task_dag.h"
+
+struct task_dag {
+    long num_nodes;
+    long node_capacity;
+    task_dag_fn* fns;
+    void** args;
+    double* costs;
+
+    long num_edges;
+    long edge_capacity;
+    long* edge_from;
+    long* edge_to;
+
+    // Built from the edge list by analyze() after the graph changed
+    int analyzed;
+    long* succ_start;           // Successors of v: succ[succ_start[v] .. succ_start[v + 1])
+    long* succ;
+    long* pred_start;
+    long* pred;
+    long* order;                // Topological order
+    double* bottom_level;
+    double critical_path;
+    int* priority;
+    int* remaining;             // Unfinished predecessors (counters executor)
+    char* sentinels;            // One depend() address per node
+};
+
+static int grow(void** array, long capacity, size_t element) {
+    void* p = realloc(*array, capacity * element);
+    if (!p) return -1;
+    *array = p;
+    return 0;
+}
+
+static void free_analysis(task_dag_t* dag) {
+    free(dag->succ_start);
+    free(dag->succ);
+    free(dag->pred_start);
+    free(dag->pred);
+    free(dag->order);
+    free(dag->bottom_level);
+    free(dag->priority);
+    free(dag->remaining);
+    free(dag->sentinels);
+    dag->succ_start = dag->succ = dag->pred_start = dag->pred = dag->order = NULL;
+    dag->bottom_level = NULL;
+    dag->priority = dag->remaining = NULL;
+    dag->sentinels = NULL;
+    dag->analyzed = 0;
+}
+
+task_dag_t* task_dag_create(void) {
+    return (task_dag_t*)calloc(1, sizeof(task_dag_t));
+}
+
+void task_dag_destroy(task_dag_t* dag) {
+    if (!dag) return;
+    free_analysis(dag);
+    free(dag->fns);
+    free(dag->args);
+    free(dag->costs);
+    free(dag->edge_from);
+    free(dag->edge_to);
+    free(dag);
+}
+
+long task_dag_add_node(task_dag_t* dag, task_dag_fn fn, void* arg, double cost) {
+    if (dag->num_nodes == dag->node_capacity) {
+        long capacity = dag->node_capacity ? 2 * dag->node_capacity : 1024;
+        if (grow((void**)&dag->fns, capacity, sizeof(task_dag_fn)) != 0 ||
+            grow((void**)&dag->args, capacity, sizeof(void*)) != 0 ||
+            grow((void**)&dag->costs, capacity, sizeof(double)) != 0) {
+            return -1;
+        }
+        dag->node_capacity = capacity;
+    }
+    long v = dag->num_nodes++;
+    dag->fns[v] = fn;
+    dag->args[v] = arg;
+    dag->costs[v] = cost > 0.0 ? cost : 1.0;
+    dag->analyzed = 0;
+    return v;
+}
+
+int task_dag_add_edge(task_dag_t* dag, long from, long to) {
+    if (from < 0 || to < 0 || from >= dag->num_nodes || to >= dag->num_nodes || from == to) return -1;
+    if (dag->num_edges == dag->edge_capacity) {
+        long capacity = dag->edge_capacity ? 2 * dag->edge_capacity : 4096;
+        if (grow((void**)&dag->edge_from, capacity, sizeof(long)) != 0 ||
+            grow((void**)&dag->edge_to, capacity, sizeof(long)) != 0) {
+            return -1;
+        }
+        dag->edge_capacity = capacity;
+    }
+    dag->edge_from[dag->num_edges] = from;
+    dag->edge_to[dag->num_edges] = to;
+    dag->num_edges++;
+    dag->analyzed = 0;
+    return 0;
+}
+
+long task_dag_num_nodes(const task_dag_t* dag) {
+    return dag->num_nodes;
+}
+
+// Adjacency of one direction in CSR form from the edge list
+static void build_csr(long n, long m, const long* key, const long* value, long* start, long* out, long* cursor) {
+    memset(start, 0, (n + 1) * sizeof(long));
+    for (long e = 0; e < m; e++) start[key[e] + 1]++;
+    for (long v = 0; v < n; v++) start[v + 1] += start[v];
+    memcpy(cursor, start, n * sizeof(long));
+    for (long e = 0; e < m; e++) out[cursor[key[e]]++] = value[e];
+}
+
+// Adjacency, topological order (Kahn), bottom levels and priorities
+static int analyze(task_dag_t* dag) {
+    free_analysis(dag);
+    const long n = dag->num_nodes, m = dag->num_edges;
+    dag->succ_start = (long*)malloc((n + 1) * sizeof(long));
+    dag->succ = (long*)malloc((m + 1) * sizeof(long));
+    dag->pred_start = (long*)malloc((n + 1) * sizeof(long));
+    dag->pred = (long*)malloc((m + 1) * sizeof(long));
+    dag->order = (long*)malloc((n + 1) * sizeof(long));
+    dag->bottom_level = (double*)malloc((n + 1) * sizeof(double));
+    dag->priority = (int*)malloc((n + 1) * sizeof(int));
+    dag->remaining = (int*)malloc((n + 1) * sizeof(int));
+    dag->sentinels = (char*)malloc(n + 1);
+    if (!dag->succ_start || !dag->succ || !dag->pred_start || !dag->pred || !dag->order ||
+        !dag->bottom_level || !dag->priority || !dag->remaining || !dag->sentinels) {
+        free_analysis(dag);
+        return -1;
+    }
+    // The order array is free until Kahn's algorithm fills it
+    build_csr(n, m, dag->edge_from, dag->edge_to, dag->succ_start, dag->succ, dag->order);
+    build_csr(n, m, dag->edge_to, dag->edge_from, dag->pred_start, dag->pred, dag->order);
+
+    // The order array doubles as the queue of nodes whose predecessors are all placed
+    long head = 0, tail = 0;
+    for (long v = 0; v < n; v++) {
+        dag->remaining[v] = (int)(dag->pred_start[v + 1] - dag->pred_start[v]);
+        if (dag->remaining[v] == 0) dag->order[tail++] = v;
+    }
+    while (head < tail) {
+        long v = dag->order[head++];
+        for (long e = dag->succ_start[v]; e < dag->succ_start[v + 1]; e++) {
+            if (--dag->remaining[dag->succ[e]] == 0) dag->order[tail++] = dag->succ[e];
+        }
+    }
+    if (tail < n) {
+        free_analysis(dag);
+        return -1;
+    }
+
+    // Costliest path to an exit, node included, in reverse topological order
+    double longest = 0.0;
+    for (long k = n - 1; k >= 0; k--) {
+        long v = dag->order[k];
+        double below = 0.0;
+        for (long e = dag->succ_start[v]; e < dag->succ_start[v + 1]; e++) {
+            if (dag->bottom_level[dag->succ[e]] > below) below = dag->bottom_level[dag->succ[e]];
+        }
+        dag->bottom_level[v] = dag->costs[v] + below;
+        if (dag->bottom_level[v] > longest) longest = dag->bottom_level[v];
+    }
+    const int max_priority = omp_get_max_task_priority();
+    for (long v = 0; v < n; v++) {
+        dag->priority[v] = longest > 0.0 ? (int)(dag->bottom_level[v] / longest * max_priority + 0.5) : 0;
+    }
+    dag->critical_path = longest;
+    dag->analyzed = 1;
+    return 0;
+}
+
+double task_dag_bottom_level(task_dag_t* dag, long node) {
+    if (node < 0 || node >= dag->num_nodes) return -1.0;
+    if (!dag->analyzed && analyze(dag) != 0) return -1.0;
+    return dag->bottom_level[node];
+}
+
+double task_dag_critical_path(task_dag_t* dag) {
+    if (!dag->analyzed && analyze(dag) != 0) return -1.0;
+    return dag->critical_path;
+}
+
+int task_dag_priority(task_dag_t* dag, long node) {
+    if (node < 0 || node >= dag->num_nodes) return -1;
+    if (!dag->analyzed && analyze(dag) != 0) return -1;
+    return dag->priority[node];
+}
+
+static void run_released(task_dag_t* dag, long v, int priorities);
+
+static void spawn(task_dag_t* dag, long v, int priorities) {
+    #pragma omp task firstprivate(v) priority(priorities ? dag->priority[v] : 0)
+    run_released(dag, v, priorities);
+}
+
+// Counters executor: run v, then release its successors; the most critical
+// released successor runs next on this thread, the others become tasks
+static void run_released(task_dag_t* dag, long v, int priorities) {
+    while (v >= 0) {
+        dag->fns[v](dag->args[v]);
+        long next = -1;
+        for (long e = dag->succ_start[v]; e < dag->succ_start[v + 1]; e++) {
+            long s = dag->succ[e];
+            int left;
+            // acq_rel: the last predecessor to decrement must see the others' work
+            // before it starts the successor
+            #pragma omp atomic capture acq_rel
+            left = --dag->remaining[s];
+            if (left) continue;
+            if (next < 0) {
+                next = s;
+            } else if (dag->bottom_level[s] > dag->bottom_level[next]) {
+                spawn(dag, next, priorities);
+                next = s;
+            } else {
+                spawn(dag, s, priorities);
+            }
+        }
+        v = next;
+    }
+}
+
+int task_dag_execute(task_dag_t* dag, task_dag_mode_t mode, int priorities) {
+    if (!dag->analyzed && analyze(dag) != 0) return -1;
+    const long n = dag->num_nodes;
+
+    if (mode == TASK_DAG_COUNTERS) {
+        for (long v = 0; v < n; v++) dag->remaining[v] = (int)(dag->pred_start[v + 1] - dag->pred_start[v]);
+        #pragma omp parallel
+        #pragma omp single
+        {
+            for (long v = 0; v < n; v++) {
+                if (dag->pred_start[v + 1] == dag->pred_start[v]) spawn(dag, v, priorities);
+            }
+        }
+        return 0;
+    }
+
+    // Tasks are created in topological order, so every predecessor's depend(out:)
+    // precedes the depend(in:) on its sentinel
+    #pragma omp parallel
+    #pragma omp single
+    {
+        for (long k = 0; k < n; k++) {
+            const long v = dag->order[k];
+            const long* preds = dag->pred + dag->pred_start[v];
+            const long num_preds = dag->pred_start[v + 1] - dag->pred_start[v];
+            char* sentinel = dag->sentinels;
+            // GCC misses the uses in a task with depend(iterator()) and warns they are unused
+            (void)sentinel;
+            (void)num_preds;
+            #pragma omp task firstprivate(v) priority(priorities ? dag->priority[v] : 0) \
+                depend(out: sentinel[v]) depend(iterator(long i = 0:num_preds), in: sentinel[preds[i]])
+            dag->fns[v](dag->args[v]);
+        }
+    }
+    return 0;
+}
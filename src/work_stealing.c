@@ -0,0 +1,232 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <omp.h>
+#include "../include/work_stealing.h"
+
+#define YIELD_AFTER 64  // Failed steals before giving the CPU away
+
+// One worker: Chase-Lev deque plus private counters. top and bottom sit on
+// separate cache lines, thieves only write top.
+typedef struct {
+    atomic_long top;
+    char pad0[64 - sizeof(atomic_long)];
+    atomic_long bottom;
+    char pad1[64 - sizeof(atomic_long)];
+    _Atomic(ws_task_t*) buffer[WS_DEQUE_CAPACITY];
+    unsigned long long rng;
+    ws_stats_t stats;
+} __attribute__((aligned(64))) ws_worker_t;
+
+struct ws_pool {
+    int num_workers;
+    atomic_int done;
+    ws_worker_t* workers;
+};
+
+static _Thread_local ws_pool_t* current_pool = NULL;
+static _Thread_local ws_worker_t* current_worker = NULL;
+
+// ---- Chase-Lev deque (C11 formulation of Le, Pop, Cohen and Zappa Nardelli) ----
+
+// Owner only; returns 0 when the deque is full
+static int deque_push(ws_worker_t* w, ws_task_t* task) {
+    long b = atomic_load_explicit(&w->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&w->top, memory_order_acquire);
+    if (b - t >= WS_DEQUE_CAPACITY) return 0;
+
+    atomic_store_explicit(&w->buffer[b % WS_DEQUE_CAPACITY], task, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+    return 1;
+}
+
+// Owner only; NULL when empty or when a thief won the race for the last task
+static ws_task_t* deque_pop(ws_worker_t* w) {
+    long b = atomic_load_explicit(&w->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&w->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&w->top, memory_order_relaxed);
+
+    if (t > b) {
+        atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    ws_task_t* task = atomic_load_explicit(&w->buffer[b % WS_DEQUE_CAPACITY], memory_order_relaxed);
+    if (t == b) {
+        // Last task: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&w->top, &t, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            task = NULL;
+        }
+        atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+// Any thread; NULL when empty or when the race was lost
+static ws_task_t* deque_steal(ws_worker_t* w) {
+    long t = atomic_load_explicit(&w->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&w->bottom, memory_order_acquire);
+    if (t >= b) return NULL;
+
+    ws_task_t* task = atomic_load_explicit(&w->buffer[t % WS_DEQUE_CAPACITY], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&w->top, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return task;
+}
+
+// ---- Runtime ----
+
+static void execute(ws_task_t* task) {
+    task->fn(task->arg);
+    atomic_store_explicit(&task->done, 1, memory_order_release);
+}
+
+// xorshift64, one stream per worker
+static int random_victim(ws_worker_t* self, int num_workers) {
+    unsigned long long x = self->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    self->rng = x;
+    return (int)(x % (unsigned long long)num_workers);
+}
+
+// Try one steal from a random other worker and run what we got
+static int try_steal(ws_pool_t* pool, ws_worker_t* self) {
+    if (pool->num_workers < 2) return 0;
+
+    int victim = random_victim(self, pool->num_workers);
+    if (&pool->workers[victim] == self) return 0;
+
+    self->stats.steal_attempts++;
+    ws_task_t* task = deque_steal(&pool->workers[victim]);
+    if (!task) return 0;
+
+    self->stats.stolen++;
+    execute(task);
+    return 1;
+}
+
+ws_pool_t* ws_pool_create(int num_workers) {
+    if (num_workers <= 0) num_workers = omp_get_max_threads();
+
+    ws_pool_t* pool = (ws_pool_t*)malloc(sizeof(ws_pool_t));
+    if (!pool) return NULL;
+    pool->workers = (ws_worker_t*)aligned_alloc(64, num_workers * sizeof(ws_worker_t));
+    if (!pool->workers) {
+        free(pool);
+        return NULL;
+    }
+
+    pool->num_workers = num_workers;
+    atomic_init(&pool->done, 0);
+    for (int i = 0; i < num_workers; i++) {
+        ws_worker_t* w = &pool->workers[i];
+        atomic_init(&w->top, 0);
+        atomic_init(&w->bottom, 0);
+        w->rng = 0x9E3779B97F4A7C15ULL * (i + 1);
+        memset(&w->stats, 0, sizeof(w->stats));
+    }
+    return pool;
+}
+
+void ws_pool_destroy(ws_pool_t* pool) {
+    if (!pool) return;
+    free(pool->workers);
+    free(pool);
+}
+
+void ws_run(ws_pool_t* pool, void (*root)(void* arg), void* arg) {
+    atomic_store(&pool->done, 0);
+    for (int i = 0; i < pool->num_workers; i++) {
+        memset(&pool->workers[i].stats, 0, sizeof(ws_stats_t));
+    }
+
+    #pragma omp parallel num_threads(pool->num_workers)
+    {
+        int id = omp_get_thread_num();
+        ws_worker_t* self = &pool->workers[id];
+        current_pool = pool;
+        current_worker = self;
+
+        if (id == 0) {
+            root(arg);
+            atomic_store_explicit(&pool->done, 1, memory_order_release);
+        } else {
+            int failed = 0;
+            while (!atomic_load_explicit(&pool->done, memory_order_acquire)) {
+                if (try_steal(pool, self)) {
+                    failed = 0;
+                } else if (++failed >= YIELD_AFTER) {
+                    sched_yield();
+                    failed = 0;
+                }
+            }
+        }
+
+        current_pool = NULL;
+        current_worker = NULL;
+    }
+}
+
+void ws_spawn(ws_task_t* task, void (*fn)(void* arg), void* arg) {
+    task->fn = fn;
+    task->arg = arg;
+    atomic_store_explicit(&task->done, 0, memory_order_relaxed);
+
+    ws_worker_t* self = current_worker;
+    if (self && deque_push(self, task)) {
+        self->stats.spawned++;
+        return;
+    }
+
+    // Outside ws_run() or deque full: run now, ws_join() finds it done
+    if (self) self->stats.inlined++;
+    execute(task);
+}
+
+void ws_join(ws_task_t* task) {
+    if (atomic_load_explicit(&task->done, memory_order_acquire)) return;
+
+    ws_pool_t* pool = current_pool;
+    ws_worker_t* self = current_worker;
+
+    // Strict nesting: an unstolen task is at the bottom of our deque
+    ws_task_t* top = deque_pop(self);
+    if (top) {
+        execute(top);
+        if (top == task) return;
+    }
+
+    // Stolen: keep busy with other work until the thief is done
+    int failed = 0;
+    while (!atomic_load_explicit(&task->done, memory_order_acquire)) {
+        if (try_steal(pool, self)) {
+            failed = 0;
+        } else if (++failed >= YIELD_AFTER) {
+            sched_yield();
+            failed = 0;
+        }
+    }
+}
+
+void ws_pool_stats(const ws_pool_t* pool, ws_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < pool->num_workers; i++) {
+        const ws_stats_t* s = &pool->workers[i].stats;
+        stats->spawned += s->spawned;
+        stats->inlined += s->inlined;
+        stats->stolen += s->stolen;
+        stats->steal_attempts += s->steal_attempts;
+    }
+}
+
+int ws_pool_workers(const ws_pool_t* pool) {
+    return pool->num_workers;
+}
@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/workload.h"
+
+static const char* profile_names[WORKLOAD_NUM_PROFILES] = {
+    "uniform", "increasing", "decreasing", "exponential", "zipf", "bimodal", "periodic"
+};
+
+const char* workload_profile_name(workload_profile_t profile) {
+    if (profile < 0 || profile >= WORKLOAD_NUM_PROFILES) return "unknown";
+    return profile_names[profile];
+}
+
+int workload_profile_parse(const char* name) {
+    for (int p = 0; p < WORKLOAD_NUM_PROFILES; p++) {
+        if (strcmp(name, profile_names[p]) == 0) return p;
+    }
+    return -1;
+}
+
+// splitmix64, so profiles are identical across libcs
+static unsigned long long next_random(unsigned long long* state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform double in [0, 1)
+static double next_uniform(unsigned long long* state) {
+    return (next_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int workload_generate(double* cost, long n, workload_profile_t profile, double mean,
+                      unsigned long long seed) {
+    if (n <= 0 || mean < 0.0) return -1;
+    unsigned long long state = seed;
+
+    switch (profile) {
+        case WORKLOAD_UNIFORM:
+            for (long i = 0; i < n; i++) cost[i] = 1.0;
+            break;
+
+        case WORKLOAD_INCREASING:
+            for (long i = 0; i < n; i++) cost[i] = (i + 0.5) / n;
+            break;
+
+        case WORKLOAD_DECREASING:
+            for (long i = 0; i < n; i++) cost[i] = (n - i - 0.5) / n;
+            break;
+
+        case WORKLOAD_EXPONENTIAL:
+            for (long i = 0; i < n; i++) cost[i] = -log(1.0 - next_uniform(&state));
+            break;
+
+        case WORKLOAD_ZIPF: {
+            // Shuffle the ranks 1..n over the iterations (Fisher-Yates)
+            long* rank = (long*)malloc(n * sizeof(long));
+            if (!rank) return -1;
+            for (long i = 0; i < n; i++) rank[i] = i + 1;
+            for (long i = n - 1; i > 0; i--) {
+                long j = (long)(next_random(&state) % (unsigned long long)(i + 1));
+                long tmp = rank[i];
+                rank[i] = rank[j];
+                rank[j] = tmp;
+            }
+            for (long i = 0; i < n; i++) cost[i] = 1.0 / rank[i];
+            free(rank);
+            break;
+        }
+
+        case WORKLOAD_BIMODAL:
+            for (long i = 0; i < n; i++) cost[i] = next_uniform(&state) < 0.1 ? 10.0 : 1.0;
+            break;
+
+        case WORKLOAD_PERIODIC:
+            for (long i = 0; i < n; i++) cost[i] = i % 100 ? 1.0 : 10000.0;
+            break;
+
+        default:
+            return -1;
+    }
+
+    // Scale to the requested mean so every profile does the same total work
+    double sum = 0.0;
+    for (long i = 0; i < n; i++) sum += cost[i];
+    double scale = sum > 0.0 ? mean / (sum / n) : 0.0;
+    for (long i = 0; i < n; i++) cost[i] *= scale;
+    return 0;
+}
+
+double workload_execute(double cost) {
+    long units = (long)(cost + 0.5);
+    double sum = 0.0;
+    for (long j = 0; j < units; j++) {
+        sum += sin(j) * cos(j);
+    }
+    return sum;
+}
+
+#define CALIBRATION_TIME 10e-3  // Shortest timed execution when calibrating
+
+static double units_per_second = 0.0;
+static volatile double calibration_sink;
+
+// Seconds to execute a number of units. The volatile reads and writes keep the
+// compiler from hoisting or reusing the pure computation across timer calls.
+static double time_units(long units) {
+    volatile long count = units;
+    double t0 = omp_get_wtime();
+    calibration_sink += workload_execute((double)count);
+    return omp_get_wtime() - t0;
+}
+
+// Double the unit count until one execution takes CALIBRATION_TIME, keep the fastest of three.
+// Double-checked: once calibrated, callers (every workload_spin()) only do an atomic read.
+double workload_calibrate(void) {
+    double rate;
+    #pragma omp atomic read
+    rate = units_per_second;
+    if (rate != 0.0) return rate;
+
+    #pragma omp critical(workload_calibrate)
+    {
+        if (units_per_second == 0.0) {
+            long units = 1000;
+            double elapsed;
+            while ((elapsed = time_units(units)) < CALIBRATION_TIME) units *= 2;
+            for (int r = 0; r < 2; r++) {
+                double t = time_units(units);
+                if (t < elapsed) elapsed = t;
+            }
+            #pragma omp atomic write
+            units_per_second = units / elapsed;
+        }
+        rate = units_per_second;
+    }
+    return rate;
+}
+
+double workload_spin(double seconds) {
+    if (seconds <= 0.0) return 0.0;
+    return workload_execute(seconds * workload_calibrate());
+}
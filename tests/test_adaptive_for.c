@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/adaptive_for.h"
+#include "test_common.h"
+
+#define N 100000
+#define THREADS 4
+
+static void mark(long begin, long end, void* arg) {
+    int* visits = (int*)arg;
+    for (long i = begin; i < end; i++) {
+        #pragma omp atomic
+        visits[i]++;
+    }
+}
+
+// Every iteration must run exactly once
+static int covered_once(const int* visits, long n) {
+    for (long i = 0; i < n; i++) {
+        if (visits[i] != 1) return 0;
+    }
+    return 1;
+}
+
+int test_coverage() {
+    printf("\n=== Testing Iteration Coverage ===\n");
+    int* visits = (int*)malloc(N * sizeof(int));
+    long sizes[] = { N, 1, 3, 7, 1000 };
+    char what[96];
+
+    for (int s = 0; s < ADAPTIVE_NUM_STRATEGIES; s++) {
+        adaptive_site_t site;
+        adaptive_site_init(&site, "coverage", s);
+
+        // Repeated invocations exercise the learned chunk sizes and weights
+        for (int rep = 0; rep < 3; rep++) {
+            for (int k = 0; k < 5; k++) {
+                memset(visits, 0, N * sizeof(int));
+                adaptive_for(&site, sizes[k], mark, visits);
+                snprintf(what, sizeof(what), "%s covers n=%ld (invocation %d)",
+                         adaptive_strategy_name(s), sizes[k], site.invocations);
+                check(what, 1, covered_once(visits, sizes[k]));
+            }
+        }
+        snprintf(what, sizeof(what), "%s invocations", adaptive_strategy_name(s));
+        check(what, 15, site.invocations);
+    }
+
+    free(visits);
+    return 0;
+}
+
+static void spin(long begin, long end, void* arg) {
+    volatile double* sink = (double*)arg;
+    double x = 0.0;
+    for (long i = begin; i < end; i++) x += sqrt((double)i);
+    *sink += x * 0.0;
+}
+
+int test_learning() {
+    printf("\n=== Testing Learned State ===\n");
+    adaptive_site_t site;
+    double sink = 0.0;
+
+    adaptive_site_init(&site, "learning", ADAPTIVE_AWF);
+    for (int rep = 0; rep < 4; rep++) adaptive_for(&site, N, spin, &sink);
+
+    check("Iteration time measured", 1, site.iteration_time > 0.0);
+    check("Minimum chunk amortizes the counter", 1,
+          site.min_chunk >= (long)(site.target_chunk_time / site.iteration_time));
+    double weight_sum = 0.0;
+    for (int t = 0; t < THREADS; t++) weight_sum += site.weight[t];
+    check("AWF weights average to 1", THREADS, weight_sum);
+    check("Chunks recorded", 1, site.last_chunks >= THREADS);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for adaptive loop scheduling\n");
+    omp_set_num_threads(THREADS);
+
+    test_coverage();
+    test_learning();
+
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/array_file.h"
+#include "test_common.h"
+
+static char path[64];
+
+// Overwrite one byte of the file
+static void poke(off_t offset, char value) {
+    int fd = open(path, O_WRONLY);
+    if (pwrite(fd, &value, 1, offset) != 1) failures++;
+    close(fd);
+}
+
+int test_roundtrip() {
+    printf("\n=== Testing Round Trips ===\n");
+    const size_t n = 100003;
+    double* values = (double*)malloc(n * sizeof(double));
+    for (size_t i = 0; i < n; i++) values[i] = sin((double)i) * 1e6;
+
+    const char* modes[] = { "mmap", "pread" };
+    size_t chunk_sizes[] = { 0, 4096, 100000 };
+    char what[96];
+    for (int c = 0; c < 3; c++) {
+        check("Write 1-D float64", 0, array_file_write(path, values, ARRAY_FLOAT64, 1, &n, 0, chunk_sizes[c]));
+        for (int m = 0; m < 2; m++) {
+            array_t a;
+            snprintf(what, sizeof(what), "Load %s, chunk %zu", modes[m], chunk_sizes[c]);
+            check(what, 0, array_file_load(path, (array_load_mode_t)m, 1, &a));
+            snprintf(what, sizeof(what), "Count and content %s, chunk %zu", modes[m], chunk_sizes[c]);
+            check(what, 1, a.count == n && memcmp(a.data, values, n * sizeof(double)) == 0);
+            snprintf(what, sizeof(what), "Data aligned %s, chunk %zu", modes[m], chunk_sizes[c]);
+            check(what, 0, (uintptr_t)a.data % ARRAY_DEFAULT_ALIGNMENT);
+            array_free(&a);
+        }
+    }
+
+    // The mapping is private: writing through it leaves the file alone
+    array_t a;
+    array_file_load(path, ARRAY_LOAD_MMAP, 0, &a);
+    ((double*)a.data)[0] = -1.0;
+    array_free(&a);
+    array_file_load(path, ARRAY_LOAD_PREAD, 1, &a);
+    check("File unchanged by writes to the mapping", values[0], ((double*)a.data)[0]);
+    array_free(&a);
+
+    // 2-D int32 with a small alignment
+    int32_t grid[6][7];
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 7; j++) grid[i][j] = i * 100 + j;
+    }
+    size_t shape[2] = { 6, 7 };
+    check("Write 2-D int32", 0, array_file_write(path, grid, ARRAY_INT32, 2, shape, 64, 16));
+    array_header_t h;
+    check("Header readable", 0, array_file_info(path, &h));
+    check("Header dtype", ARRAY_INT32, h.dtype);
+    check("Header shape", 1, h.ndim == 2 && h.shape[0] == 6 && h.shape[1] == 7);
+    check("Header data offset aligned", 0, h.data_offset % 64);
+    check("Header chunks", (6 * 7 * 4 + 15) / 16, h.num_chunks);
+    check("Load 2-D", 0, array_file_load(path, ARRAY_LOAD_PREAD, 1, &a));
+    check("2-D element [5][5]", 505, ((int32_t*)a.data)[5 * 7 + 5]);
+    array_free(&a);
+
+    size_t zero = 0;
+    check("Write empty array", 0, array_file_write(path, NULL, ARRAY_UINT8, 1, &zero, 0, 4096));
+    check("Load empty array", 0, array_file_load(path, ARRAY_LOAD_MMAP, 1, &a));
+    check("Empty array count", 0, a.count);
+    array_free(&a);
+
+    check("dtype size", 4, array_dtype_size(ARRAY_FLOAT32));
+    check("Unknown dtype rejected", -1, array_file_write(path, values, ARRAY_NUM_DTYPES, 1, &n, 0, 0));
+    check("Bad alignment rejected", -1, array_file_write(path, values, ARRAY_FLOAT64, 1, &n, 48, 0));
+    free(values);
+    return 0;
+}
+
+int test_corruption() {
+    printf("\n=== Testing Corruption Detection ===\n");
+    const size_t n = 50000;
+    int64_t* values = (int64_t*)malloc(n * sizeof(int64_t));
+    for (size_t i = 0; i < n; i++) values[i] = (int64_t)(i * i);
+    array_file_write(path, values, ARRAY_INT64, 1, &n, 0, 8192);
+    array_header_t h;
+    array_file_info(path, &h);
+
+    poke((off_t)(h.data_offset + 30000), 0x5a);
+    array_t a;
+    check("Flipped byte detected (mmap)", -2, array_file_load(path, ARRAY_LOAD_MMAP, 1, &a));
+    check("Flipped byte detected (pread)", -2, array_file_load(path, ARRAY_LOAD_PREAD, 1, &a));
+    check("Loads without verification", 0, array_file_load(path, ARRAY_LOAD_PREAD, 0, &a));
+    array_free(&a);
+
+    poke(0, 'X');
+    check("Bad magic rejected", -1, array_file_load(path, ARRAY_LOAD_MMAP, 0, &a));
+    check("Bad magic header", -1, array_file_info(path, &h));
+
+    array_file_write(path, values, ARRAY_INT64, 1, &n, 0, 8192);
+    check("Truncate", 0, truncate(path, (off_t)(h.data_offset + 1000)));
+    check("Truncated file rejected", -1, array_file_load(path, ARRAY_LOAD_PREAD, 1, &a));
+    check("Missing file", -1, array_file_load("/nonexistent/array", ARRAY_LOAD_MMAP, 1, &a));
+
+    // An aligned data offset near UINT64_MAX whose sums wrap back inside the file
+    array_file_write(path, values, ARRAY_INT64, 1, &n, 0, 8192);
+    array_file_info(path, &h);
+    array_header_t forged = h;
+    forged.data_offset = UINT64_MAX - 4095;
+    forged.checksum_offset = (forged.data_offset + forged.data_bytes + 7) & ~(uint64_t)7;
+    int fd = open(path, O_WRONLY);
+    if (pwrite(fd, &forged, sizeof(forged), 0) != (ssize_t)sizeof(forged)) failures++;
+    close(fd);
+    check("Wrapping data offset rejected", -1, array_file_load(path, ARRAY_LOAD_MMAP, 0, &a));
+    check("Wrapping data offset header", -1, array_file_info(path, &forged));
+    free(values);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for array files\n");
+    snprintf(path, sizeof(path), "/tmp/test_array_file.%d.bin", (int)getpid());
+
+    test_roundtrip();
+    test_corruption();
+
+    unlink(path);
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../include/async_io.h"
+#include "test_common.h"
+
+#define PIECES 32
+#define PIECE_SIZE 100000
+#define DEPTH 4
+
+static char path[64];
+
+int test_backend(async_io_backend_t backend) {
+    async_io_t* io = async_io_create(backend, DEPTH);
+    if (!io) {
+        printf("\n=== Backend %s not available here, skipped ===\n", async_io_backend_name(backend));
+        return 0;
+    }
+    printf("\n=== Testing the %s Backend ===\n", async_io_backend_name(backend));
+    const char* name = async_io_backend_name(backend);
+    char what[96];
+
+    size_t size = (size_t)PIECES * PIECE_SIZE;
+    char* data = (char*)malloc(size);
+    char* back = (char*)calloc(size, 1);
+    for (size_t i = 0; i < size; i++) data[i] = (char)(i * 7 + i / 251);
+    ssize_t results[PIECES];
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    // More pieces than the depth, from several threads, written out of order
+    #pragma omp parallel num_threads(4)
+    #pragma omp single
+    {
+        for (int p = PIECES - 1; p >= 0; p--) {
+            omp_event_handle_t done;
+            #pragma omp task detach(done) firstprivate(p)
+            async_io_write(io, fd, data + (size_t)p * PIECE_SIZE, PIECE_SIZE, (off_t)p * PIECE_SIZE, &results[p], done);
+        }
+        #pragma omp taskwait
+    }
+    int all = 1;
+    for (int p = 0; p < PIECES; p++) all &= results[p] == PIECE_SIZE;
+    snprintf(what, sizeof(what), "Writes complete (%s)", name);
+    check(what, 1, all);
+
+    // Read the whole file back in one request, plus a request past the end
+    ssize_t whole = 0, tail = 0, bad = 0, empty = -1;
+    char tail_buf[64];
+    #pragma omp parallel num_threads(4)
+    #pragma omp single
+    {
+        omp_event_handle_t e1, e2, e3, e4;
+        #pragma omp task detach(e1)
+        async_io_read(io, fd, back, size, 0, &whole, e1);
+        #pragma omp task detach(e2)
+        async_io_read(io, fd, tail_buf, sizeof(tail_buf), (off_t)size - 10, &tail, e2);
+        #pragma omp task detach(e3)
+        async_io_read(io, -1, tail_buf, sizeof(tail_buf), 0, &bad, e3);
+        #pragma omp task detach(e4)
+        async_io_read(io, fd, tail_buf, 0, 0, &empty, e4);
+        #pragma omp taskwait
+    }
+    snprintf(what, sizeof(what), "Whole file read (%s)", name);
+    check(what, (double)size, whole);
+    snprintf(what, sizeof(what), "Content matches (%s)", name);
+    check(what, 1, memcmp(data, back, size) == 0);
+    snprintf(what, sizeof(what), "Short read at end of file (%s)", name);
+    check(what, 10, tail);
+    snprintf(what, sizeof(what), "Bad descriptor reported (%s)", name);
+    check(what, -EBADF, bad);
+    snprintf(what, sizeof(what), "Empty read (%s)", name);
+    check(what, 0, empty);
+
+    // Compute tasks keep running while a read is in flight
+    ssize_t result = 0;
+    long computed = 0;
+    #pragma omp parallel num_threads(2)
+    #pragma omp single
+    {
+        omp_event_handle_t done;
+        memset(back, 0, size);
+        #pragma omp task detach(done) depend(out: back[0])
+        async_io_read(io, fd, back, size, 0, &result, done);
+        #pragma omp task depend(in: back[0])
+        {
+            #pragma omp atomic
+            computed += back[size - 1] == data[size - 1];
+        }
+        for (int t = 0; t < 8; t++) {
+            #pragma omp task
+            {
+                #pragma omp atomic
+                computed += 10;
+            }
+        }
+        #pragma omp taskwait
+    }
+    snprintf(what, sizeof(what), "Dependent task sees the data (%s)", name);
+    check(what, 81, computed);
+
+    snprintf(what, sizeof(what), "Runs on a concrete backend (%s)", name);
+    check(what, 1, async_io_backend(io) != ASYNC_IO_AUTO);
+    close(fd);
+    free(data);
+    free(back);
+    async_io_destroy(io);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for asynchronous I/O\n");
+    snprintf(path, sizeof(path), "/tmp/test_async_io.%d.dat", (int)getpid());
+
+    test_backend(ASYNC_IO_THREADS);
+    test_backend(ASYNC_IO_URING);
+    test_backend(ASYNC_IO_AUTO);
+    check("Zero depth rejected", 1, async_io_create(ASYNC_IO_AUTO, 0) == NULL);
+
+    unlink(path);
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/bench_harness.h"
+#include "../include/bench_baseline.h"
+#include "test_common.h"
+
+int test_statistics() {
+    printf("\n=== Testing Statistics ===\n");
+    const double samples[] = { 5.0, 1.0, 4.0, 2.0, 3.0 };
+    bench_result_t r;
+
+    bench_stats_compute(samples, 5, 0.0, &r);
+    check("Runs", 5, r.runs);
+    check("Mean", 3.0, r.mean);
+    check("Median", 3.0, r.median);
+    check("Min", 1.0, r.min);
+    check("Max", 5.0, r.max);
+    check("P95", 4.8, r.p95);
+    check("Stddev", sqrt(2.5), r.stddev);
+    check("CI95", 2.776 * sqrt(2.5) / sqrt(5.0), r.ci95);
+    return 0;
+}
+
+int test_outlier_rejection() {
+    printf("\n=== Testing Outlier Rejection ===\n");
+    const double samples[] = { 1.0, 1.1, 0.9, 1.0, 1.05, 0.95, 25.0 };
+    bench_result_t r;
+
+    bench_stats_compute(samples, 7, 1.5, &r);
+    check("Kept", 6, r.kept);
+    check("Max after rejection", 1.1, r.max);
+    check("Mean after rejection", 1.0, r.mean);
+
+    bench_stats_compute(samples, 7, 0.0, &r);
+    check("Kept without rejection", 7, r.kept);
+    return 0;
+}
+
+static void busy(void* arg) {
+    volatile double* x = (volatile double*)arg;
+    for (int i = 0; i < 100000; i++) *x += 1e-9 * i;
+}
+
+int test_run() {
+    printf("\n=== Testing Adaptive Run ===\n");
+    bench_config_t config;
+    bench_result_t r;
+    double x = 0.0;
+
+    bench_config_default(&config);
+    config.min_runs = 3;
+    config.max_runs = 10;
+    config.target_rel_ci = 1e9;  // Converges as soon as min_runs is reached
+
+    bench_run(&config, "busy", 100000, busy, &x, &r);
+    check("Runs stop at min_runs once converged", 3, r.runs);
+    check("Converged", 1, r.converged);
+    check("Threads recorded", omp_get_max_threads(), r.threads);
+    bench_result_free(&r);
+
+    config.target_rel_ci = 0.0;  // Never converges, bounded by max_runs
+    bench_run(&config, "busy", 100000, busy, &x, &r);
+    check("Runs capped at max_runs", 10, r.runs);
+    check("Not converged", 0, r.converged);
+    bench_result_free(&r);
+    return 0;
+}
+
+int test_mann_whitney() {
+    printf("\n=== Testing Mann-Whitney U ===\n");
+    const double slow[] = { 6.0, 7.0, 8.0, 9.0, 10.0 };
+    const double fast[] = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+    const double same[] = { 2.0, 2.0, 2.0, 2.0, 2.0 };
+
+    // U = 25, mean 12.5, variance 25 * 11 / 12, continuity correction 0.5
+    double z = 12.0 / sqrt(25.0 * 11.0 / 12.0);
+    check("Separated samples", 0.5 * erfc(z / sqrt(2.0)), bench_mann_whitney_p(slow, 5, fast, 5));
+    check("Wrong direction", 1, bench_mann_whitney_p(fast, 5, slow, 5) > 0.99);
+    check("All ties", 1.0, bench_mann_whitney_p(same, 5, same, 5));
+    return 0;
+}
+
+// Save a baseline, then compare a run that is 20% slower and one that is not
+int test_baseline() {
+    printf("\n=== Testing Baseline Comparison ===\n");
+    char dir[] = "/tmp/bench_baseline_XXXXXX";
+    if (!mkdtemp(dir)) {
+        printf("mkdtemp failed -> FAIL\n");
+        failures++;
+        return 1;
+    }
+    setenv("BENCH_BASELINE_DIR", dir, 1);
+
+    double samples[20];
+    bench_result_t r;
+    memset(&r, 0, sizeof(r));
+    snprintf(r.name, sizeof(r.name), "kernel");
+    r.threads = 1;
+    r.size = 100;
+    r.runs = 20;
+    r.samples = samples;
+
+    double scales[] = { 1.0, 1.2, 1.01 };
+    int expected[] = { 0, 1, 0 };
+    for (int pass = 0; pass < 3; pass++) {
+        setenv("BENCH_BASELINE", pass == 0 ? "save" : "compare", 1);
+        for (int i = 0; i < 20; i++) samples[i] = scales[pass] * (1.0 + 0.001 * (i % 5));
+        bench_baseline_begin("test_suite");
+        bench_baseline_add(&r);
+        int regressions = bench_baseline_end(stdout);
+        check(pass == 0 ? "Save reports no regressions" :
+              pass == 1 ? "20% slowdown is a regression" : "1% slowdown is noise",
+              expected[pass], regressions);
+    }
+
+    unsetenv("BENCH_BASELINE");
+    unsetenv("BENCH_BASELINE_DIR");
+    char command[64];
+    snprintf(command, sizeof(command), "rm -rf %s", dir);
+    if (system(command) != 0) printf("warning: could not remove %s\n", dir);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for benchmark harness\n");
+
+    test_statistics();
+    test_outlier_rejection();
+    test_run();
+    test_mann_whitney();
+    test_baseline();
+
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+// Shared by the test programs: check() prints one PASS/FAIL line per
+// comparison and counts failures, main() returns 1 if any failed.
+// Define TEST_EPSILON before the include for a looser tolerance.
+
+#include <stdio.h>
+#include <math.h>
+
+#ifndef TEST_EPSILON
+#define TEST_EPSILON 1e-9
+#endif
+
+static int failures = 0;
+
+static inline void check(const char* what, double expected, double got) {
+    int ok = fabs(expected - got) < TEST_EPSILON;
+    printf("%s: expected %.6f, got %.6f -> %s\n", what, expected, got, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+#endif // TEST_COMMON_H
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../include/csv_parser.h"
+#include "../include/parallel_algorithms.h"
+#include "test_common.h"
+
+// Parse a NUL-terminated string; 1 if the value and the end match strtod bit for bit
+static int same_as_strtod(const char* s) {
+    double got, expected;
+    char* expected_end;
+    const char* end = csv_parse_double(s, s + strlen(s), &got);
+    expected = strtod(s, &expected_end);
+    return end == expected_end && memcmp(&got, &expected, sizeof(double)) == 0;
+}
+
+int test_numbers() {
+    printf("\n=== Testing Number Parsing ===\n");
+    const char* cases[] = {
+        "0", "-0", "1", "-1.5", "+3.25e+2", ".5", "5.", "0.1", "1e23", "7E-10",
+        "9007199254740993", "9007199254740992.5", "18446744073709551615",
+        "1.7976931348623157e308", "1.7976931348623159e308", "1e309",
+        "2.2250738585072014e-308", "2.2250738585072011e-308", "4.9e-324", "2e-324", "3e-324", "1e-400",
+        "123456789012345678901234567890", "0.000000000000000000000000000001", "3.14159265358979323846264338327950288"
+    };
+    char what[96];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        snprintf(what, sizeof(what), "\"%s\" matches strtod", cases[i]);
+        check(what, 1, same_as_strtod(cases[i]));
+    }
+
+    // Random bit patterns and decimal forms at full precision
+    uint64_t state = 88172645463325252ULL;
+    char buf[64];
+    int mismatches = 0;
+    for (int i = 0; i < 300000; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        double d;
+        memcpy(&d, &state, sizeof(d));
+        if (isnan(d) || isinf(d)) continue;
+        snprintf(buf, sizeof(buf), i % 3 == 0 ? "%.17g" : i % 3 == 1 ? "%.6e" : "%.3f", i % 3 == 2 ? fmod(d, 1e6) : d);
+        mismatches += !same_as_strtod(buf);
+    }
+    check("Random doubles match strtod", 0, mismatches);
+
+    double v = 42.0;
+    check("Sign alone rejected", 1, csv_parse_double("-", "-" + 1, &v) == NULL);
+    check("Letters rejected", 1, csv_parse_double("nan", "nan" + 3, &v) == NULL);
+    const char* s = "12e+x";
+    check("Dangling exponent not consumed", 2, csv_parse_double(s, s + 5, &v) - s);
+    s = "2.5,7";
+    check("Stops at the delimiter", 3, csv_parse_double(s, s + 5, &v) - s);
+    check("Stops at the buffer end", 2, csv_parse_double(s, s + 1, &v) == s + 1 ? v : -1);
+    return 0;
+}
+
+int test_tables() {
+    printf("\n=== Testing Tables ===\n");
+    const char* text =
+        "x, y ,z\r\n"
+        "1,2,3\r\n"
+        "\n"
+        "4.5, -6e2 ,7\n"
+        "8,,9\n"
+        "10,abc\n"
+        "11,12,13,14";
+    csv_table_t t;
+    check("Parse with header", 0, csv_parse_buffer(text, strlen(text), ',', 1, &t));
+    check("Columns", 3, t.columns);
+    check("Rows (blank line skipped)", 5, t.rows);
+    check("Names trimmed", 1, t.names && !strcmp(t.names[0], "x") && !strcmp(t.names[1], "y") && !strcmp(t.names[2], "z"));
+    check("Value with padding", -600, t.data[1][1]);
+    check("Value after CRLF", 3, t.data[2][0]);
+    check("Last row without newline", 13, t.data[2][4]);
+    check("Empty field is NaN", 1, isnan(t.data[1][2]));
+    check("Text and missing fields are NaN", 1, isnan(t.data[1][3]) && isnan(t.data[2][3]));
+    check("Bad fields counted", 3, t.bad_fields);
+    check("Columns 64-byte aligned", 0, (uintptr_t)t.data[0] % 64);
+    csv_table_free(&t);
+
+    check("Tab separated, no header", 0, csv_parse_buffer("1\t2\n3\t4\n", 8, '\t', 0, &t));
+    check("Tab separated shape", 1, t.columns == 2 && t.rows == 2 && t.names == NULL);
+    check("Tab separated value", 4, t.data[1][1]);
+    csv_table_free(&t);
+
+    check("Empty input", 0, csv_parse_buffer("", 0, ',', 1, &t));
+    check("Empty input has no rows", 0, t.rows);
+    csv_table_free(&t);
+    return 0;
+}
+
+int test_parallel() {
+    printf("\n=== Testing Parallel Parsing ===\n");
+    const int rows = 200003;
+    double* expected = (double*)malloc(rows * sizeof(double));
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/test_csv_parser.%d.csv", (int)getpid());
+    FILE* out = fopen(path, "w");
+    fprintf(out, "id;value\n");
+    for (int i = 0; i < rows; i++) {
+        expected[i] = sin((double)i) * 1e3;
+        fprintf(out, "%d;%.17g\n", i, expected[i]);
+    }
+    fclose(out);
+
+    // Every thread count cuts the file differently, the result must not change
+    int threads[] = { 1, 3, 8 };
+    char what[96];
+    for (int k = 0; k < 3; k++) {
+        omp_set_num_threads(threads[k]);
+        csv_table_t t;
+        snprintf(what, sizeof(what), "Parse file, %d threads", threads[k]);
+        check(what, 0, csv_parse_file(path, ';', 1, &t));
+        snprintf(what, sizeof(what), "Rows, %d threads", threads[k]);
+        check(what, rows, t.rows);
+        int in_order = 1;
+        for (int i = 0; i < t.rows && in_order; i++) in_order = t.data[0][i] == i;
+        snprintf(what, sizeof(what), "Rows in file order, %d threads", threads[k]);
+        check(what, 1, in_order);
+        snprintf(what, sizeof(what), "Values exact, %d threads", threads[k]);
+        check(what, 1, t.rows == rows && memcmp(t.data[1], expected, rows * sizeof(double)) == 0);
+
+        // Columns feed the parallel algorithms directly
+        double sum = parallel_reduce(t.data[1], (int)t.rows, 0.0, 0);
+        check("Column sum", parallel_reduce(expected, rows, 0.0, 0), sum);
+        parallel_sort(t.data[1], (int)t.rows);
+        int sorted = 1;
+        for (int i = 1; i < t.rows; i++) sorted &= t.data[1][i - 1] <= t.data[1][i];
+        check("Column sorted", 1, sorted);
+        csv_table_free(&t);
+    }
+    omp_set_num_threads(omp_get_num_procs());
+
+    csv_table_t t;
+    check("Missing file", -1, csv_parse_file("/nonexistent/data.csv", ',', 0, &t));
+    unlink(path);
+    free(expected);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for the CSV parser\n");
+
+    test_numbers();
+    test_tables();
+    test_parallel();
+
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../include/external_sort.h"
+#include "../include/array_file.h"
+#include "test_common.h"
+
+static char input[64], output[64];
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Sort values through files with the given budget and compare with qsort
+static void sort_and_compare(const char* label, double* values, size_t n, size_t chunk_size, size_t budget,
+                             long expected_runs) {
+    char what[128];
+    check("Write input", 0, array_file_write(input, values, ARRAY_FLOAT64, 1, &n, 0, chunk_size));
+    external_sort_config_t config = { budget, NULL };
+    external_sort_stats_t stats;
+    snprintf(what, sizeof(what), "Sort (%s)", label);
+    check(what, 0, external_sort_file(input, output, &config, &stats));
+    if (expected_runs >= 0) {
+        snprintf(what, sizeof(what), "Runs (%s)", label);
+        check(what, expected_runs, stats.runs);
+    }
+
+    qsort(values, n, sizeof(double), compare_doubles);
+    array_t sorted;
+    snprintf(what, sizeof(what), "Output loads with valid checksums (%s)", label);
+    check(what, 0, array_file_load(output, ARRAY_LOAD_PREAD, 1, &sorted));
+    snprintf(what, sizeof(what), "Output matches qsort (%s)", label);
+    check(what, 1, sorted.count == n && (n == 0 || memcmp(sorted.data, values, n * sizeof(double)) == 0));
+    snprintf(what, sizeof(what), "Output keeps the chunk size (%s)", label);
+    check(what, (double)chunk_size, (double)sorted.header.chunk_size);
+    array_free(&sorted);
+}
+
+int test_sort() {
+    printf("\n=== Testing External Sort ===\n");
+    const size_t n = 500009;
+    double* values = (double*)malloc(n * sizeof(double));
+
+    // 1 MB budget: runs of 43690 elements, a dozen of them
+    srand(7);
+    for (size_t i = 0; i < n; i++) values[i] = (double)rand() / RAND_MAX * 2e6 - 1e6;
+    sort_and_compare("random, many runs", values, n, ARRAY_DEFAULT_CHUNK, 1 << 20, (n + 43689) / 43690);
+
+    // Few distinct values: partitions split at equal keys
+    for (size_t i = 0; i < n; i++) values[i] = (double)(rand() % 5);
+    sort_and_compare("duplicates, odd chunks", values, n, 8 * 1000, 1 << 20, -1);
+
+    // Already sorted and reversed input, no checksums, one run
+    for (size_t i = 0; i < n; i++) values[i] = (double)(n - i);
+    sort_and_compare("reversed, one run", values, n, 0, 64 << 20, 1);
+
+    sort_and_compare("empty", values, 0, 4096, 1 << 20, 0);
+
+    // Every thread count merges the same partitions differently
+    int threads[] = { 1, 3 };
+    char label[64];
+    for (int t = 0; t < 2; t++) {
+        omp_set_num_threads(threads[t]);
+        for (size_t i = 0; i < n; i++) values[i] = sin((double)i * 0.37) * 1e3;
+        snprintf(label, sizeof(label), "%d threads", threads[t]);
+        sort_and_compare(label, values, n, 4096 * 8, 1 << 20, -1);
+    }
+    omp_set_num_threads(omp_get_num_procs());
+    free(values);
+    return 0;
+}
+
+int test_errors() {
+    printf("\n=== Testing Error Handling ===\n");
+    int ints[4] = { 4, 3, 2, 1 };
+    size_t n = 4;
+    array_file_write(input, ints, ARRAY_INT32, 1, &n, 0, 0);
+    check("Non-float64 input rejected", -1, external_sort_file(input, output, NULL, NULL));
+    check("Missing input", -1, external_sort_file("/nonexistent/array", output, NULL, NULL));
+
+    double values[3] = { 3, 1, 2 };
+    n = 3;
+    array_file_write(input, values, ARRAY_FLOAT64, 1, &n, 0, 0);
+    check("Unwritable output", -1, external_sort_file(input, "/nonexistent/sorted", NULL, NULL));
+    external_sort_config_t config = { 0, "/nonexistent" };
+    check("Unusable temporary directory", -1, external_sort_file(input, output, &config, NULL));
+    return 0;
+}
+
+int main() {
+    printf("Running tests for the external sort\n");
+    snprintf(input, sizeof(input), "/tmp/test_external_sort.%d.in", (int)getpid());
+    snprintf(output, sizeof(output), "/tmp/test_external_sort.%d.out", (int)getpid());
+
+    test_sort();
+    test_errors();
+
+    unlink(input);
+    unlink(output);
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/loop_profile.h"
+#include "test_common.h"
+
+#define N 1000
+#define THREADS 4
+
+static void square(long i, void* arg) {
+    double* out = (double*)arg;
+    out[i] = (double)i * i;
+}
+
+int test_profile_for() {
+    printf("\n=== Testing Profiled Loop ===\n");
+    double* out = (double*)calloc(N, sizeof(double));
+    loop_profile_t profile;
+    loop_profile_summary_t summary;
+
+    loop_profile_init(&profile, "square");
+    loop_profile_for(&profile, N, omp_sched_static, 10, square, out);
+    loop_profile_summarize(&profile, &summary);
+
+    check("Threads", THREADS, summary.threads);
+    check("Iterations", N, summary.iterations);
+    // Round-robin chunks of 10 are never adjacent for the same thread
+    check("Chunks", N / 10, summary.chunks);
+    check("Static share of thread 0", N / THREADS, profile.stats[0].iterations);
+    check("Body ran", (double)(N - 1) * (N - 1), out[N - 1]);
+    check("Imbalance at least 1", 1, summary.imbalance >= 1.0);
+    check("Idle fraction in [0, 1)", 1, summary.idle_fraction >= 0.0 && summary.idle_fraction < 1.0);
+
+    loop_profile_for(&profile, N, omp_sched_static, 0, square, out);
+    loop_profile_summarize(&profile, &summary);
+    check("Unchunked static gives one chunk per thread", THREADS, summary.chunks);
+
+    loop_profile_free(&profile);
+    free(out);
+    return 0;
+}
+
+int test_inline_hooks() {
+    printf("\n=== Testing In-place Hooks ===\n");
+    loop_profile_t profile;
+    loop_profile_summary_t summary;
+    long sum = 0, plain = 0;
+
+    loop_profile_init(&profile, "inline");
+    #pragma omp parallel reduction(+:sum)
+    {
+        loop_profile_thread_begin(&profile);
+        #pragma omp for schedule(dynamic, 7) nowait
+        for (int i = 0; i < N; i++) {
+            loop_profile_iteration(&profile, i);
+            sum += i;
+        }
+        loop_profile_thread_end(&profile);
+    }
+    loop_profile_summarize(&profile, &summary);
+    check("Iterations", N, summary.iterations);
+    check("Reduction intact", (double)N * (N - 1) / 2, sum);
+    check("Chunks cover the loop", 1, summary.chunks >= 1 && summary.chunks <= (N + 6) / 7);
+
+    // A NULL profile leaves the loop uninstrumented
+    #pragma omp parallel reduction(+:plain)
+    {
+        loop_profile_thread_begin(NULL);
+        #pragma omp for nowait
+        for (int i = 0; i < N; i++) {
+            loop_profile_iteration(NULL, i);
+            plain += i;
+        }
+        loop_profile_thread_end(NULL);
+    }
+    check("NULL profile", (double)N * (N - 1) / 2, plain);
+
+    loop_profile_free(&profile);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for loop profiling\n");
+    omp_set_num_threads(THREADS);
+
+    test_profile_for();
+    test_inline_hooks();
+
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "../include/mmap_reader.h"
+#include "test_common.h"
+
+static char path[64];
+
+// Lines of varying length, "<i>:<i x's>\n"
+static long write_lines(int lines) {
+    FILE* out = fopen(path, "w");
+    long size = 0;
+    for (int i = 0; i < lines; i++) {
+        size += fprintf(out, "%d:", i);
+        for (int j = 0; j < i % 50; j++) size += fprintf(out, "x");
+        size += fprintf(out, "\n");
+    }
+    fclose(out);
+    return size;
+}
+
+int test_open() {
+    printf("\n=== Testing Mapping ===\n");
+    long size = write_lines(3000);
+    int flag_sets[] = { 0, MMAP_POPULATE, MMAP_SEQUENTIAL | MMAP_WILLNEED, MMAP_PREFAULT };
+    char* expected = (char*)malloc(size);
+    FILE* in = fopen(path, "r");
+    check("Read back", size, fread(expected, 1, size, in));
+    fclose(in);
+
+    for (int f = 0; f < 4; f++) {
+        char what[64];
+        mmap_file_t* file = mmap_file_open(path, flag_sets[f]);
+        snprintf(what, sizeof(what), "Size with flags %d", flag_sets[f]);
+        check(what, size, file ? file->size : 0);
+        snprintf(what, sizeof(what), "Content with flags %d", flag_sets[f]);
+        check(what, 1, file && memcmp(file->data, expected, size) == 0);
+        mmap_file_close(file);
+    }
+
+    mmap_file_t* file = mmap_file_open(path, 0);
+    long page = sysconf(_SC_PAGESIZE);
+    check("Pages prefaulted", (size + page - 1) / page, mmap_file_prefault(file));
+    check("Evict a cached file", 0, mmap_file_evict(path));
+    check("Content after eviction", 1, memcmp(file->data, expected, size) == 0);
+    mmap_file_close(file);
+    free(expected);
+
+    check("Missing file", 1, mmap_file_open("/nonexistent/mmap_reader", 0) == NULL);
+    fclose(fopen(path, "w"));
+    file = mmap_file_open(path, MMAP_PREFAULT);
+    check("Empty file maps", 1, file != NULL && file->size == 0);
+    mmap_file_close(file);
+    return 0;
+}
+
+int test_views() {
+    printf("\n=== Testing Views ===\n");
+    long size = write_lines(3000);
+    mmap_file_t* file = mmap_file_open(path, 0);
+
+    mmap_view_t views[64];
+    long n = mmap_file_views(file, 2000, NULL, 0);
+    check("View count", (size + 1999) / 2000, n);
+    mmap_file_views(file, 2000, views, 64);
+    check("First view", 1, views[0].data == file->data && views[0].size == 2000);
+    check("Last view size", size - (n - 1) * 2000, views[n - 1].size);
+    check("Last view offset", (n - 1) * 2000, views[n - 1].offset);
+
+    // Every part ends at a line boundary and the parts tile the file
+    int part_counts[] = { 1, 3, 8, 64 };
+    for (int t = 0; t < 4; t++) {
+        int parts = part_counts[t];
+        mmap_file_split_lines(file, parts, views);
+        size_t covered = 0;
+        int aligned = 1;
+        for (int i = 0; i < parts; i++) {
+            if (views[i].offset != covered) aligned = 0;
+            if (views[i].size > 0 && views[i].data[views[i].size - 1] != '\n') aligned = 0;
+            covered += views[i].size;
+        }
+        char what[64];
+        snprintf(what, sizeof(what), "Split into %d parts covers the file", parts);
+        check(what, size, covered);
+        snprintf(what, sizeof(what), "Split into %d parts ends at newlines", parts);
+        check(what, 1, aligned);
+    }
+    mmap_file_close(file);
+
+    // More parts than lines: the extra parts are empty
+    FILE* out = fopen(path, "w");
+    fprintf(out, "one line\nno newline at the end");
+    fclose(out);
+    file = mmap_file_open(path, 0);
+    mmap_file_split_lines(file, 8, views);
+    size_t covered = 0;
+    int nonempty = 0;
+    for (int i = 0; i < 8; i++) {
+        covered += views[i].size;
+        nonempty += views[i].size > 0;
+    }
+    check("Short file covered", file->size, covered);
+    check("Short file parts with data", 2, nonempty);
+    mmap_file_close(file);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for the mmap reader\n");
+    snprintf(path, sizeof(path), "/tmp/test_mmap_reader.%d.txt", (int)getpid());
+
+    test_open();
+    test_views();
+
+    unlink(path);
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
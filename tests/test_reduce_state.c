@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/reduce_state.h"
+#include "test_common.h"
+
+// Relative comparison for values far from 1; merged variances of data at 1e9
+// carry the rounding of the means (ulp 1e-7) into the deviations
+static void check_close(const char* what, double expected, double got) {
+    check(what, 1, fabs(expected - got) <= 1e-10 * fabs(expected) + 1e-12);
+}
+
+int test_sum() {
+    printf("\n=== Testing Compensated Sums ===\n");
+    const size_t n = 100000;
+    double* x = (double*)malloc(n * sizeof(double));
+    // Large values cancel exactly; a plain sum loses every 1.0 next to them
+    for (size_t i = 0; i < n; i += 4) {
+        x[i] = 1e16;
+        x[i + 1] = 1.0;
+        x[i + 2] = -1e16;
+        x[i + 3] = 1.0;
+    }
+    reduce_sum_t s;
+    reduce_sum_init(&s);
+    reduce_sum_update(&s, x, n);
+    check("Cancelling sum", n / 2, reduce_sum_value(&s));
+
+    // The same data in uneven chunks, and as two merged states
+    reduce_sum_t chunks, a, b;
+    reduce_sum_init(&chunks);
+    for (size_t begin = 0; begin < n; begin += 777) reduce_sum_update(&chunks, x + begin, begin + 777 < n ? 777 : n - begin);
+    check("Chunked sum", n / 2, reduce_sum_value(&chunks));
+    reduce_sum_init(&a);
+    reduce_sum_init(&b);
+    reduce_sum_update(&a, x, 30001);
+    reduce_sum_update(&b, x + 30001, n - 30001);
+    reduce_sum_merge(&a, &b);
+    check("Merged sum", n / 2, reduce_sum_value(&a));
+
+    x[5] = NAN;
+    reduce_sum_init(&s);
+    reduce_sum_update(&s, x, 8);
+    check("NaN skipped", 3.0, reduce_sum_value(&s));
+    free(x);
+    return 0;
+}
+
+int test_stats() {
+    printf("\n=== Testing Statistics ===\n");
+    const size_t n = 200000;
+    double* x = (double*)malloc(n * sizeof(double));
+    // A large offset makes a naive sum-of-squares variance useless
+    for (size_t i = 0; i < n; i++) x[i] = 1e9 + (double)(i % 1000) - 499.5;
+    double variance = (1000.0 * 1000.0 - 1.0) / 12.0;   // Discrete uniform over 1000 values
+
+    reduce_stats_t whole;
+    reduce_stats_init(&whole);
+    reduce_stats_update(&whole, x, n);
+    check("Count", n, whole.count);
+    check_close("Mean", 1e9, whole.mean);
+    check_close("Population variance", variance, reduce_stats_variance(&whole, 0));
+    check_close("Sample variance", variance * n / (n - 1), reduce_stats_variance(&whole, 1));
+    check("Min", 1e9 - 499.5, whole.min);
+    check("Max", 1e9 + 499.5, whole.max);
+    check_close("Sum", 1e9 * n, reduce_sum_value(&whole.sum));
+
+    // Chunks of every size folded in one at a time
+    reduce_stats_t streamed;
+    reduce_stats_init(&streamed);
+    size_t begin = 0;
+    for (size_t len = 1; begin < n; len = len * 3 + 1) {
+        size_t m = begin + len < n ? len : n - begin;
+        reduce_stats_update(&streamed, x + begin, m);
+        begin += m;
+    }
+    check("Streamed count", n, streamed.count);
+    check_close("Streamed mean", whole.mean, streamed.mean);
+    check_close("Streamed variance", reduce_stats_variance(&whole, 0), reduce_stats_variance(&streamed, 0));
+
+    // States from "other processes" combine like one
+    reduce_stats_t parts[3], merged;
+    reduce_stats_init(&merged);
+    size_t cuts[4] = { 0, 1, 150000, n };
+    for (int p = 0; p < 3; p++) {
+        reduce_stats_init(&parts[p]);
+        reduce_stats_update(&parts[p], x + cuts[p], cuts[p + 1] - cuts[p]);
+    }
+    reduce_stats_merge(&merged, &parts[2]);
+    reduce_stats_merge(&merged, &parts[0]);
+    reduce_stats_merge(&merged, &parts[1]);
+    check("Merged count", n, merged.count);
+    check_close("Merged variance", variance, reduce_stats_variance(&merged, 0));
+    check("Merged min", whole.min, merged.min);
+
+    // A fixed thread count gives the same bits on every run
+    omp_set_num_threads(3);
+    reduce_stats_t r1, r2;
+    reduce_stats_init(&r1);
+    reduce_stats_init(&r2);
+    reduce_stats_update(&r1, x, n);
+    reduce_stats_update(&r2, x, n);
+    check("Reproducible with 3 threads", 1, r1.mean == r2.mean && r1.m2 == r2.m2);
+    check_close("3 threads agree with the default", reduce_stats_variance(&whole, 0), reduce_stats_variance(&r1, 0));
+    omp_set_num_threads(omp_get_num_procs());
+
+    reduce_stats_t empty, nans;
+    reduce_stats_init(&empty);
+    check("Empty variance is NaN", 1, isnan(reduce_stats_variance(&empty, 0)));
+    double only_nan[3] = { NAN, 2.0, NAN };
+    reduce_stats_init(&nans);
+    reduce_stats_update(&nans, only_nan, 3);
+    check("NaN counted", 2, nans.nans);
+    check("NaN excluded", 1, nans.count);
+    reduce_stats_merge(&empty, &nans);
+    check("Merge into empty", 2.0, empty.mean);
+    check("Sample variance of one value", 1, isnan(reduce_stats_variance(&empty, 1)));
+    free(x);
+    return 0;
+}
+
+int test_histogram() {
+    printf("\n=== Testing Histograms ===\n");
+    const size_t n = 100000;
+    double* x = (double*)malloc(n * sizeof(double));
+    for (size_t i = 0; i < n; i++) x[i] = (double)(i % 120) - 10.0;   // -10 .. 109
+
+    reduce_hist_t h, a, b;
+    check("Init", 0, reduce_hist_init(&h, 0.0, 100.0, 10));
+    reduce_hist_update(&h, x, n);
+    uint64_t total = h.below + h.above;
+    for (int i = 0; i < h.bins; i++) total += h.counts[i];
+    check("Every value counted", n, total);
+    check("Below", (n / 120) * 10 + 10, h.below);
+    check("Bin 0 holds [0, 10)", (n / 120) * 10 + 10, h.counts[0]);
+    check("Above (100 and up)", (n / 120) * 10, h.above);
+
+    reduce_hist_init(&a, 0.0, 100.0, 10);
+    reduce_hist_init(&b, 0.0, 100.0, 10);
+    reduce_hist_update(&a, x, 12345);
+    reduce_hist_update(&b, x + 12345, n - 12345);
+    check("Merge", 0, reduce_hist_merge(&a, &b));
+    check("Merged equals whole", 1, memcmp(a.counts, h.counts, 10 * sizeof(uint64_t)) == 0 && a.below == h.below);
+
+    reduce_hist_t other;
+    reduce_hist_init(&other, 0.0, 50.0, 10);
+    check("Different binning rejected", -1, reduce_hist_merge(&a, &other));
+    double edge[3] = { 100.0 - 1e-13, NAN, 0.0 };
+    reduce_hist_update(&other, edge, 3);
+    check("NaN ignored", 1, other.counts[0] == 1 && other.above == 1 && other.below == 0);
+    reduce_hist_free(&other);
+    check("Bad range rejected", -1, reduce_hist_init(&other, 1.0, 1.0, 4));
+
+    reduce_hist_free(&h);
+    reduce_hist_free(&a);
+    reduce_hist_free(&b);
+    free(x);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for reduction states\n");
+
+    test_sum();
+    test_stats();
+    test_histogram();
+
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <omp.h>
+#include "../include/ring_buffer.h"
+#include "test_common.h"
+
+#define ITEMS_PER_PRODUCER 20000
+#define PRODUCERS 4
+#define CONSUMERS 4
+
+static void* as_item(uintptr_t v) { return (void*)v; }
+
+int test_spsc() {
+    printf("\n=== Testing SPSC Ring ===\n");
+    ring_spsc_t* ring = ring_spsc_create(5);
+    check("Capacity rounded up", 8, ring_spsc_capacity(ring));
+
+    void* item = NULL;
+    check("Pop from empty", 0, ring_spsc_pop(ring, &item));
+
+    // Several laps so the indices wrap around the cells
+    int in_order = 1;
+    for (uintptr_t lap = 0; lap < 5; lap++) {
+        for (uintptr_t i = 0; i < 8; i++) {
+            if (!ring_spsc_push(ring, as_item(lap * 8 + i + 1))) in_order = 0;
+        }
+        if (ring_spsc_push(ring, as_item(99))) in_order = 0;
+        for (uintptr_t i = 0; i < 8; i++) {
+            if (!ring_spsc_pop(ring, &item) || item != as_item(lap * 8 + i + 1)) in_order = 0;
+        }
+    }
+    check("FIFO across wraparound, full and empty detected", 1, in_order);
+
+    void* items[12];
+    void* out[12];
+    for (uintptr_t i = 0; i < 12; i++) items[i] = as_item(i + 1);
+    ring_spsc_push(ring, items[0]);
+    check("Batch push stops at capacity", 7, ring_spsc_push_batch(ring, items + 1, 11));
+    check("Batch pop returns what is there", 8, ring_spsc_pop_batch(ring, out, 12));
+    check("Batch pop order", 1, out[0] == items[0] && out[7] == items[7]);
+    check("Batch pop from empty", 0, ring_spsc_pop_batch(ring, out, 12));
+    ring_spsc_destroy(ring);
+
+    // One producer and one consumer thread
+    ring = ring_spsc_create(64);
+    long total = 0, sum = 0, ordered = 1;
+    #pragma omp parallel num_threads(2)
+    {
+        if (omp_get_thread_num() == 0) {
+            for (uintptr_t i = 1; i <= ITEMS_PER_PRODUCER; i++) {
+                while (!ring_spsc_push(ring, as_item(i))) sched_yield();
+            }
+        } else {
+            uintptr_t expected = 1;
+            while (expected <= ITEMS_PER_PRODUCER) {
+                void* batch[16];
+                size_t n = ring_spsc_pop_batch(ring, batch, 16);
+                if (n == 0) sched_yield();
+                for (size_t i = 0; i < n; i++) {
+                    if (batch[i] != as_item(expected)) ordered = 0;
+                    sum += (long)(uintptr_t)batch[i];
+                    expected++;
+                    total++;
+                }
+            }
+        }
+    }
+    check("Threaded SPSC item count", ITEMS_PER_PRODUCER, total);
+    check("Threaded SPSC sum", (double)ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER + 1) / 2, sum);
+    check("Threaded SPSC order", 1, ordered);
+    ring_spsc_destroy(ring);
+    return 0;
+}
+
+int test_mpmc() {
+    printf("\n=== Testing MPMC Ring ===\n");
+    ring_mpmc_t* ring = ring_mpmc_create(1);
+    check("Capacity at least 2", 2, ring_mpmc_capacity(ring));
+    ring_mpmc_destroy(ring);
+
+    ring = ring_mpmc_create(16);
+    void* item;
+    int in_order = 1;
+    for (uintptr_t lap = 0; lap < 5; lap++) {
+        for (uintptr_t i = 0; i < 16; i++) {
+            if (!ring_mpmc_push(ring, as_item(lap * 16 + i + 1))) in_order = 0;
+        }
+        if (ring_mpmc_push(ring, as_item(99))) in_order = 0;
+        for (uintptr_t i = 0; i < 16; i++) {
+            if (!ring_mpmc_pop(ring, &item) || item != as_item(lap * 16 + i + 1)) in_order = 0;
+        }
+        if (ring_mpmc_pop(ring, &item)) in_order = 0;
+    }
+    check("FIFO across wraparound, full and empty detected", 1, in_order);
+
+    void* items[20];
+    void* out[20];
+    for (uintptr_t i = 0; i < 20; i++) items[i] = as_item(i + 1);
+    check("Batch push of zero items", 0, ring_mpmc_push_batch(ring, items, 0));
+    check("Batch push stops at capacity", 16, ring_mpmc_push_batch(ring, items, 20));
+    check("Batch pop partial", 10, ring_mpmc_pop_batch(ring, out, 10));
+    check("Batch push into the freed cells", 4, ring_mpmc_push_batch(ring, items + 16, 4));
+    check("Batch pop the rest", 10, ring_mpmc_pop_batch(ring, out + 10, 20));
+    int order = 1;
+    for (int i = 0; i < 20; i++) order &= out[i] == items[i];
+    check("Batch order", 1, order);
+    ring_mpmc_destroy(ring);
+
+    // Every item of every producer is popped exactly once
+    ring = ring_mpmc_create(64);
+    const long total = (long)PRODUCERS * ITEMS_PER_PRODUCER;
+    unsigned char* seen = (unsigned char*)calloc(total, 1);
+    atomic_long popped = 0;
+    atomic_long duplicates = 0;
+    #pragma omp parallel num_threads(PRODUCERS + CONSUMERS)
+    {
+        int id = omp_get_thread_num();
+        if (id < PRODUCERS) {
+            for (long i = 0; i < ITEMS_PER_PRODUCER;) {
+                // Alternate batch and single pushes
+                void* batch[8];
+                size_t n = 0;
+                for (; n < 8 && i + (long)n < ITEMS_PER_PRODUCER; n++) {
+                    batch[n] = as_item((uintptr_t)(id * ITEMS_PER_PRODUCER + i + n + 1));
+                }
+                size_t pushed = id % 2 ? ring_mpmc_push_batch(ring, batch, n) : (size_t)ring_mpmc_push(ring, batch[0]);
+                if (pushed == 0) sched_yield();
+                i += pushed;
+            }
+        } else {
+            while (atomic_load(&popped) < total) {
+                void* batch[8];
+                size_t n = id % 2 ? ring_mpmc_pop_batch(ring, batch, 8) : (size_t)ring_mpmc_pop(ring, batch);
+                if (n == 0) sched_yield();
+                for (size_t i = 0; i < n; i++) {
+                    long index = (long)(uintptr_t)batch[i] - 1;
+                    if (seen[index]++) atomic_fetch_add(&duplicates, 1);
+                }
+                atomic_fetch_add(&popped, n);
+            }
+        }
+    }
+    long missing = 0;
+    for (long i = 0; i < total; i++) missing += seen[i] == 0;
+    check("MPMC items popped", total, atomic_load(&popped));
+    check("MPMC items missing", 0, missing);
+    check("MPMC items popped twice", 0, atomic_load(&duplicates));
+    check("MPMC empty afterwards", 0, ring_mpmc_pop(ring, &item));
+    free(seen);
+    ring_mpmc_destroy(ring);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for the ring buffers\n");
+
+    test_spsc();
+    test_mpmc();
+
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
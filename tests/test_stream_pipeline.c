@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <omp.h>
+#include "../include/stream_pipeline.h"
+#include "test_common.h"
+
+#define CHUNKS 8
+#define CAPACITY 64
+#define STREAM_LENGTH 1000
+
+typedef struct {
+    long next;          // Next value the source emits
+    long fail_at;       // Source fails at this value (-1: never)
+    atomic_long in_flight;
+    long max_in_flight;
+    long last_seq;      // Last chunk seen by the serial sink
+    long out_of_order;
+    long sum;
+} StreamState;
+
+// One long per chunk, the chunk's position in the stream
+static int source(stream_chunk_t* chunk, void* arg) {
+    StreamState* st = (StreamState*)arg;
+    if (st->next == st->fail_at) return -1;
+    if (st->next == STREAM_LENGTH) return 0;
+
+    long in_flight = atomic_fetch_add(&st->in_flight, 1) + 1;
+    if (in_flight > st->max_in_flight) st->max_in_flight = in_flight;
+    memcpy(chunk->data, &st->next, sizeof(long));
+    chunk->size = sizeof(long);
+    st->next++;
+    return 1;
+}
+
+// Out of place: the doubled value goes to scratch, then the buffers swap
+static int twice(stream_chunk_t* chunk, void* arg) {
+    (void)arg;
+    long v;
+    memcpy(&v, chunk->data, sizeof(long));
+    v *= 2;
+    memcpy(chunk->scratch, &v, sizeof(long));
+    stream_chunk_swap(chunk);
+    return 0;
+}
+
+static int sink(stream_chunk_t* chunk, void* arg) {
+    StreamState* st = (StreamState*)arg;
+    long v;
+    memcpy(&v, chunk->data, sizeof(long));
+    if (chunk->seq != st->last_seq + 1 || v != 2 * chunk->seq) st->out_of_order++;
+    st->last_seq = chunk->seq;
+    st->sum += v;
+    atomic_fetch_sub(&st->in_flight, 1);
+    return 0;
+}
+
+static void reset(StreamState* st) {
+    st->next = 0;
+    st->fail_at = -1;
+    atomic_store(&st->in_flight, 0);
+    st->max_in_flight = 0;
+    st->last_seq = -1;
+    st->out_of_order = 0;
+    st->sum = 0;
+}
+
+int test_ordering() {
+    printf("\n=== Testing Ordering and Bounded Memory ===\n");
+    stream_pipeline_t* p = stream_pipeline_create(CHUNKS, CAPACITY);
+    StreamState st;
+    stream_pipeline_source(p, "numbers", source, &st);
+    stream_pipeline_add_stage(p, "twice", STREAM_PARALLEL, twice, NULL);
+    stream_pipeline_add_stage(p, "sink", STREAM_SERIAL, sink, &st);
+
+    int thread_counts[] = { 1, 4 };
+    char what[64];
+    for (int t = 0; t < 2; t++) {
+        omp_set_num_threads(thread_counts[t]);
+        reset(&st);
+        int status = stream_pipeline_run(p);
+
+        snprintf(what, sizeof(what), "Run status (%d threads)", thread_counts[t]);
+        check(what, 0, status);
+        snprintf(what, sizeof(what), "Sum (%d threads)", thread_counts[t]);
+        check(what, (double)STREAM_LENGTH * (STREAM_LENGTH - 1), st.sum);
+        snprintf(what, sizeof(what), "Serial stage in order (%d threads)", thread_counts[t]);
+        check(what, 0, st.out_of_order);
+        snprintf(what, sizeof(what), "Chunks in flight bounded (%d threads)", thread_counts[t]);
+        check(what, 1, st.max_in_flight <= CHUNKS);
+    }
+
+    stream_stage_stats_t stats[3];
+    check("Stage count", 3, stream_pipeline_stats(p, stats));
+    check("Source chunks", STREAM_LENGTH, stats[0].chunks);
+    check("Parallel stage chunks", STREAM_LENGTH, stats[1].chunks);
+    check("Serial stage chunks", STREAM_LENGTH, stats[2].chunks);
+    stream_pipeline_destroy(p);
+    return 0;
+}
+
+int test_errors() {
+    printf("\n=== Testing Error Propagation ===\n");
+    stream_pipeline_t* p = stream_pipeline_create(CHUNKS, CAPACITY);
+    StreamState st;
+    stream_pipeline_source(p, "numbers", source, &st);
+    stream_pipeline_add_stage(p, "sink", STREAM_SERIAL, sink, &st);
+
+    omp_set_num_threads(4);
+    reset(&st);
+    st.fail_at = 100;
+    check("Failing source reported", -1, stream_pipeline_run(p));
+    check("Chunks before the failure delivered", 100, st.last_seq + 1);
+
+    reset(&st);
+    check("Pipeline reusable after an error", 0, stream_pipeline_run(p));
+    check("Full stream after the rerun", STREAM_LENGTH, st.last_seq + 1);
+
+    check("Create rejects zero chunks", 1, stream_pipeline_create(0, CAPACITY) == NULL);
+    stream_pipeline_destroy(p);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for the streaming pipeline\n");
+
+    test_ordering();
+    test_errors();
+
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
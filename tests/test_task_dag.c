@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../include/task_dag.h"
+#include "test_common.h"
+
+#define NODES 400
+#define MAX_PREDS 4
+
+typedef struct {
+    int id;
+    int num_preds;
+    int preds[MAX_PREDS];
+} Node;
+
+static Node nodes[NODES];
+static int finished[NODES];
+static int runs[NODES];
+static int violations;
+
+// Fails the ordering if a predecessor has not finished yet
+static void visit(void* arg) {
+    Node* n = (Node*)arg;
+    for (int p = 0; p < n->num_preds; p++) {
+        int done;
+        #pragma omp atomic read
+        done = finished[n->preds[p]];
+        if (!done) {
+            #pragma omp atomic
+            violations++;
+        }
+    }
+    if (n->id % 7 == 0) usleep(200);
+    #pragma omp atomic
+    runs[n->id]++;
+    #pragma omp atomic write
+    finished[n->id] = 1;
+}
+
+static void reset() {
+    memset(finished, 0, sizeof(finished));
+    memset(runs, 0, sizeof(runs));
+    violations = 0;
+}
+
+static int all_ran_once(int n) {
+    for (int i = 0; i < n; i++) {
+        if (runs[i] != 1) return 0;
+    }
+    return 1;
+}
+
+int test_random_graph() {
+    printf("\n=== Testing Random Graphs ===\n");
+    task_dag_t* dag = task_dag_create();
+    srand(3);
+    // Node ids are added in reverse, so creation order is not a topological order
+    for (int i = 0; i < NODES; i++) {
+        nodes[i].id = i;
+        nodes[i].num_preds = 0;
+    }
+    for (int i = NODES - 1; i >= 0; i--) task_dag_add_node(dag, visit, &nodes[i], 1.0 + i % 5);
+    for (int i = 0; i < NODES - 20; i++) {
+        int k = 1 + rand() % MAX_PREDS;
+        for (int p = 0; p < k; p++) {
+            int pred = i + 1 + rand() % (NODES - i - 1);
+            nodes[i].preds[nodes[i].num_preds++] = pred;
+            task_dag_add_edge(dag, NODES - 1 - pred, NODES - 1 - i);
+        }
+    }
+    check("Node count", NODES, task_dag_num_nodes(dag));
+
+    const char* modes[] = { "depend", "counters" };
+    char what[96];
+    omp_set_num_threads(4);
+    for (int m = 0; m < 2; m++) {
+        for (int prio = 0; prio < 2; prio++) {
+            reset();
+            snprintf(what, sizeof(what), "Execute (%s, priorities %d)", modes[m], prio);
+            check(what, 0, task_dag_execute(dag, (task_dag_mode_t)m, prio));
+            snprintf(what, sizeof(what), "Dependences respected (%s, priorities %d)", modes[m], prio);
+            check(what, 0, violations);
+            snprintf(what, sizeof(what), "Every node ran once (%s, priorities %d)", modes[m], prio);
+            check(what, 1, all_ran_once(NODES));
+        }
+    }
+    omp_set_num_threads(omp_get_num_procs());
+    task_dag_destroy(dag);
+    return 0;
+}
+
+int test_structure() {
+    printf("\n=== Testing Graph Structure ===\n");
+    task_dag_t* dag = task_dag_create();
+    reset();
+    check("Empty graph runs", 0, task_dag_execute(dag, TASK_DAG_DEPEND, 1));
+
+    // Chain 0 -> 1 -> 2, then a node joined to all of them after a first run
+    for (int i = 0; i < 3; i++) {
+        nodes[i].id = i;
+        nodes[i].num_preds = i ? 1 : 0;
+        nodes[i].preds[0] = i - 1;
+        task_dag_add_node(dag, visit, &nodes[i], 0.0);
+    }
+    task_dag_add_edge(dag, 0, 1);
+    task_dag_add_edge(dag, 1, 2);
+    check("Chain", 0, task_dag_execute(dag, TASK_DAG_COUNTERS, 0));
+    check("Chain in order", 1, violations == 0 && all_ran_once(3));
+
+    nodes[3].id = 3;
+    nodes[3].num_preds = 3;
+    for (int p = 0; p < 3; p++) nodes[3].preds[p] = p;
+    long join = task_dag_add_node(dag, visit, &nodes[3], 1.0);
+    for (int p = 0; p < 3; p++) task_dag_add_edge(dag, p, join);
+    task_dag_add_edge(dag, 0, join);    // Duplicate edges are harmless
+    reset();
+    check("Graph grown after a run", 0, task_dag_execute(dag, TASK_DAG_DEPEND, 1));
+    check("Join after all", 1, violations == 0 && all_ran_once(4));
+    reset();
+    check("Duplicate edge, counters", 0, task_dag_execute(dag, TASK_DAG_COUNTERS, 1));
+    check("Join once", 1, all_ran_once(4));
+
+    check("Self edge rejected", -1, task_dag_add_edge(dag, 2, 2));
+    check("Unknown node rejected", -1, task_dag_add_edge(dag, 0, 99));
+    task_dag_add_edge(dag, join, 0);
+    reset();
+    check("Cycle rejected", -1, task_dag_execute(dag, TASK_DAG_DEPEND, 0));
+    check("Nothing ran", 0, runs[0] + runs[1] + runs[2] + runs[3]);
+    task_dag_destroy(dag);
+    return 0;
+}
+
+int test_critical_path() {
+    printf("\n=== Testing Critical Path ===\n");
+    task_dag_t* dag = task_dag_create();
+    check("Empty critical path", 0, task_dag_critical_path(dag));
+
+    // Diamond a(1) -> b(5), c(2) -> d(1): the critical path is a, b, d
+    long a = task_dag_add_node(dag, visit, &nodes[0], 1.0);
+    long b = task_dag_add_node(dag, visit, &nodes[1], 5.0);
+    long c = task_dag_add_node(dag, visit, &nodes[2], 2.0);
+    long d = task_dag_add_node(dag, visit, &nodes[3], 1.0);
+    task_dag_add_edge(dag, a, b);
+    task_dag_add_edge(dag, a, c);
+    task_dag_add_edge(dag, b, d);
+    task_dag_add_edge(dag, c, d);
+    check("Critical path", 7.0, task_dag_critical_path(dag));
+    check("Bottom level of the entry", 7.0, task_dag_bottom_level(dag, a));
+    check("Bottom level on the path", 6.0, task_dag_bottom_level(dag, b));
+    check("Bottom level off the path", 3.0, task_dag_bottom_level(dag, c));
+    check("Bottom level of the exit", 1.0, task_dag_bottom_level(dag, d));
+
+    // Scaled to whatever OMP_MAX_TASK_PRIORITY allows, 0 when it is unset
+    int max_priority = omp_get_max_task_priority();
+    check("Entry gets the top priority", max_priority, task_dag_priority(dag, a));
+    check("Exit priority", (int)(max_priority / 7.0 + 0.5), task_dag_priority(dag, d));
+    check("Priorities follow bottom levels", 1, task_dag_priority(dag, b) >= task_dag_priority(dag, c));
+
+    // A new edge invalidates the analysis
+    long e = task_dag_add_node(dag, visit, &nodes[4], 10.0);
+    task_dag_add_edge(dag, c, e);
+    check("Critical path after a change", 13.0, task_dag_critical_path(dag));
+    check("Unknown node", -1, task_dag_bottom_level(dag, 99));
+    check("Unknown node priority", -1, task_dag_priority(dag, -1));
+    task_dag_add_edge(dag, d, a);
+    check("Cyclic graph", -1, task_dag_critical_path(dag));
+    task_dag_destroy(dag);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for task graphs\n");
+
+    test_random_graph();
+    test_structure();
+    test_critical_path();
+
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/work_stealing.h"
+#include "test_common.h"
+
+#define WORKERS 4
+
+typedef struct {
+    int n;
+    long result;
+} FibArgs;
+
+static void fib(void* arg) {
+    FibArgs* f = (FibArgs*)arg;
+    if (f->n < 2) {
+        f->result = f->n;
+        return;
+    }
+    FibArgs a = { f->n - 1, 0 }, b = { f->n - 2, 0 };
+    ws_task_t task_a, task_b;
+    ws_spawn(&task_a, fib, &a);
+    ws_spawn(&task_b, fib, &b);
+    ws_join(&task_b);
+    ws_join(&task_a);
+    f->result = a.result + b.result;
+}
+
+int test_fork_join() {
+    printf("\n=== Testing Fork/Join ===\n");
+    ws_pool_t* pool = ws_pool_create(WORKERS);
+    ws_stats_t stats;
+    FibArgs f = { 20, 0 };
+
+    check("Workers", WORKERS, ws_pool_workers(pool));
+    for (int rep = 0; rep < 5; rep++) {
+        f.result = 0;
+        ws_run(pool, fib, &f);
+    }
+    check("fib(20)", 6765, f.result);
+
+    // fib(20) makes 10945 calls with n >= 2, each spawning two tasks
+    ws_pool_stats(pool, &stats);
+    check("Spawned plus inlined", 2 * 10945, stats.spawned + stats.inlined);
+    check("Stolen tasks were attempted", 1, stats.stolen <= stats.steal_attempts);
+
+    ws_pool_destroy(pool);
+    return 0;
+}
+
+typedef struct {
+    int* slots;
+    int index;
+} MarkArgs;
+
+static void mark(void* arg) {
+    MarkArgs* m = (MarkArgs*)arg;
+    m->slots[m->index]++;
+}
+
+// More children than a deque holds: the overflow runs inline
+static void wide(void* arg) {
+    int* slots = (int*)arg;
+    int n = 2 * WS_DEQUE_CAPACITY;
+    ws_task_t* tasks = (ws_task_t*)malloc(n * sizeof(ws_task_t));
+    MarkArgs* args = (MarkArgs*)malloc(n * sizeof(MarkArgs));
+    for (int i = 0; i < n; i++) {
+        args[i].slots = slots;
+        args[i].index = i;
+        ws_spawn(&tasks[i], mark, &args[i]);
+    }
+    for (int i = n - 1; i >= 0; i--) ws_join(&tasks[i]);
+    free(tasks);
+    free(args);
+}
+
+int test_overflow() {
+    printf("\n=== Testing Full Deque ===\n");
+    int n = 2 * WS_DEQUE_CAPACITY;
+    int* slots = (int*)calloc(n, sizeof(int));
+    ws_pool_t* pool = ws_pool_create(WORKERS);
+    ws_stats_t stats;
+
+    ws_run(pool, wide, slots);
+    int once = 1;
+    for (int i = 0; i < n; i++) once &= slots[i] == 1;
+    check("Every task ran once", 1, once);
+
+    ws_pool_stats(pool, &stats);
+    check("Overflow inlined", 1, stats.inlined >= WS_DEQUE_CAPACITY);
+
+    // Outside ws_run() tasks run immediately
+    ws_task_t task;
+    MarkArgs m = { slots, 0 };
+    ws_spawn(&task, mark, &m);
+    ws_join(&task);
+    check("Spawn outside a run", 2, slots[0]);
+
+    ws_pool_destroy(pool);
+    free(slots);
+    return 0;
+}
+
+int main() {
+    printf("Running tests for the work-stealing runtime\n");
+
+    test_fork_join();
+    test_overflow();
+
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
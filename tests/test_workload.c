@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "../include/workload.h"
+
+#define N 10000
+#define TEST_EPSILON 1e-6
+#include "test_common.h"
+
+int test_profiles() {
+    printf("\n=== Testing Cost Profiles ===\n");
+    double* cost = (double*)malloc(N * sizeof(double));
+    char what[64];
+
+    for (int p = 0; p < WORKLOAD_NUM_PROFILES; p++) {
+        const char* name = workload_profile_name(p);
+        snprintf(what, sizeof(what), "Parse %s", name);
+        check(what, p, workload_profile_parse(name));
+
+        workload_generate(cost, N, p, 25.0, 1);
+        double sum = 0.0, min = cost[0];
+        for (int i = 0; i < N; i++) {
+            sum += cost[i];
+            if (cost[i] < min) min = cost[i];
+        }
+        snprintf(what, sizeof(what), "Mean of %s", name);
+        check(what, 25.0, sum / N);
+        snprintf(what, sizeof(what), "Costs of %s non-negative", name);
+        check(what, 1, min >= 0.0);
+    }
+    check("Unknown profile", -1, workload_profile_parse("sawtooth"));
+
+    workload_generate(cost, N, WORKLOAD_INCREASING, 1.0, 1);
+    check("Increasing", 1, cost[0] < cost[N / 2] && cost[N / 2] < cost[N - 1]);
+    workload_generate(cost, N, WORKLOAD_DECREASING, 1.0, 1);
+    check("Decreasing", 1, cost[0] > cost[N / 2] && cost[N / 2] > cost[N - 1]);
+    workload_generate(cost, N, WORKLOAD_PERIODIC, 100.99, 1);
+    check("Periodic light iteration", 1.0, cost[1]);
+    check("Periodic heavy iteration", 10000.0, cost[100]);
+
+    // Zipf puts 1/H_n of the total work on the heaviest iteration
+    workload_generate(cost, N, WORKLOAD_ZIPF, 1.0, 1);
+    double max = 0.0, harmonic = 0.0;
+    for (int i = 0; i < N; i++) {
+        if (cost[i] > max) max = cost[i];
+        harmonic += 1.0 / (i + 1);
+    }
+    check("Zipf heaviest iteration", N / harmonic, max);
+
+    free(cost);
+    return 0;
+}
+
+int test_reproducible() {
+    printf("\n=== Testing Seeds ===\n");
+    double* a = (double*)malloc(N * sizeof(double));
+    double* b = (double*)malloc(N * sizeof(double));
+    int same = 1, differ = 0;
+
+    workload_generate(a, N, WORKLOAD_EXPONENTIAL, 10.0, 7);
+    workload_generate(b, N, WORKLOAD_EXPONENTIAL, 10.0, 7);
+    for (int i = 0; i < N; i++) same &= a[i] == b[i];
+    workload_generate(b, N, WORKLOAD_EXPONENTIAL, 10.0, 8);
+    for (int i = 0; i < N; i++) differ |= a[i] != b[i];
+
+    check("Same seed, same costs", 1, same);
+    check("Different seed, different costs", 1, differ);
+    check("Zero cost executes nothing", 0.0, workload_execute(0.0));
+
+    free(a);
+    free(b);
+    return 0;
+}
+
+int test_spin() {
+    printf("\n=== Testing Calibrated Busy-Work ===\n");
+    double rate = workload_calibrate();
+    check("Calibrated rate positive", 1, rate > 0.0);
+    check("Calibration cached", rate, workload_calibrate());
+
+    // Wall time is noisy on shared machines, only reject gross errors
+    double t0 = omp_get_wtime();
+    volatile double sink = workload_spin(20e-3);
+    double elapsed = omp_get_wtime() - t0;
+    (void)sink;
+    printf("Spin of 20 ms took %.3f ms\n", elapsed * 1e3);
+    check("Spin not too short", 1, elapsed >= 10e-3);
+    check("Spin not too long", 1, elapsed < 200e-3);
+    check("Zero spin", 0.0, workload_spin(0.0));
+    return 0;
+}
+
+int main() {
+    printf("Running tests for workload generators\n");
+
+    test_profiles();
+    test_reproducible();
+    test_spin();
+
+    printf("\n%s\n", failures ? "Some tests FAILED." : "All tests completed.");
+    return failures ? 1 : 0;
+}
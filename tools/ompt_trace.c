@@ -0,0 +1,415 @@
+// OMPT tracing tool: records parallel regions, implicit and explicit tasks,
+// barriers/taskwaits and synchronization waits per thread and writes them as
+// Chrome trace-event JSON (open in chrome://tracing or https://ui.perfetto.dev).
+//
+// Build:  make tools
+// Use:    OMP_TOOL_LIBRARIES=./bin/libompt_trace.so ./bin/task_dependencies
+//
+// The runtime must implement OMPT (LLVM libomp, Intel OpenMP). Binaries built
+// with GCC can run on libomp through its GOMP compatibility layer:
+//         LD_PRELOAD=libomp.so.5 OMP_TOOL_LIBRARIES=... ./bin/...
+//
+// Environment:
+//   OMPT_TRACE_FILE    output path (default ompt_trace.json)
+//   OMPT_TRACE_EVENTS  ring buffer capacity per thread (default 65536 events);
+//                      when a buffer wraps, the oldest events are dropped
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <omp-tools.h>
+
+#define MAX_THREADS 1024
+#define MAX_SCOPE_DEPTH 64
+#define DEFAULT_EVENTS (1 << 16)
+
+// Tasks carry their id in task_data->value; the top bits mark explicit tasks
+// and whether the task has started executing (so the creation arrow is drawn once)
+#define TASK_STARTED (1ULL << 63)
+#define TASK_EXPLICIT (1ULL << 62)
+#define TASK_ID_MASK (TASK_EXPLICIT - 1)
+
+typedef enum {
+    EV_PARALLEL,
+    EV_IMPLICIT_TASK,
+    EV_TASK,            // One execution segment of an explicit task
+    EV_TASK_CREATE,     // Instant, start of the creation -> execution flow arrow
+    EV_SYNC,            // Barrier, taskwait, taskgroup, reduction
+    EV_SYNC_WAIT,       // Time spent waiting inside a sync region
+    EV_MUTEX_WAIT       // Waiting for a lock, critical or ordered region
+} event_type_t;
+
+typedef struct {
+    uint64_t start;     // ns since tool start
+    uint64_t dur;       // ns (0 for instants)
+    uint64_t id;        // parallel/task id
+    uint32_t type;      // event_type_t
+    uint32_t arg;       // Team size, sync kind, mutex kind, first-segment flag
+} trace_event_t;
+
+typedef struct {
+    uint32_t type;
+    uint32_t arg;
+    uint64_t start;
+    uint64_t id;
+} open_scope_t;
+
+// Written only by its owner thread, read once at finalize: no locks needed
+typedef struct {
+    int index;
+    int thread_type;
+    uint64_t head;          // Total events written (buffer slot is head % capacity)
+    uint64_t capacity;
+    trace_event_t* events;
+
+    int depth;
+    open_scope_t scopes[MAX_SCOPE_DEPTH];
+
+    uint64_t task_id;       // Explicit task currently running (with flag bits), 0 if none
+    uint64_t task_start;
+} thread_trace_t;
+
+static thread_trace_t* threads[MAX_THREADS];
+static int num_threads = 0;
+static uint64_t next_id = 1;
+static uint64_t capacity = DEFAULT_EVENTS;
+static struct timespec origin;
+static __thread thread_trace_t* self = NULL;
+
+static ompt_set_callback_t set_callback;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)(ts.tv_sec - origin.tv_sec) * 1000000000ULL + ts.tv_nsec - origin.tv_nsec;
+}
+
+static uint64_t new_id(void) {
+    return __atomic_fetch_add(&next_id, 1, __ATOMIC_RELAXED);
+}
+
+static thread_trace_t* current_thread(int thread_type) {
+    if (self) return self;
+
+    int index = __atomic_fetch_add(&num_threads, 1, __ATOMIC_RELAXED);
+    if (index >= MAX_THREADS) return NULL;
+
+    thread_trace_t* t = (thread_trace_t*)calloc(1, sizeof(thread_trace_t));
+    if (!t) return NULL;
+    t->events = (trace_event_t*)malloc(capacity * sizeof(trace_event_t));
+    if (!t->events) {
+        free(t);
+        return NULL;
+    }
+    t->index = index;
+    t->thread_type = thread_type;
+    t->capacity = capacity;
+
+    __atomic_store_n(&threads[index], t, __ATOMIC_RELEASE);
+    self = t;
+    return t;
+}
+
+static void record(thread_trace_t* t, uint32_t type, uint64_t start, uint64_t dur,
+                   uint64_t id, uint32_t arg) {
+    trace_event_t* e = &t->events[t->head % t->capacity];
+    e->start = start;
+    e->dur = dur;
+    e->id = id;
+    e->type = type;
+    e->arg = arg;
+    __atomic_store_n(&t->head, t->head + 1, __ATOMIC_RELEASE);
+}
+
+static void scope_begin(uint32_t type, uint64_t id, uint32_t arg) {
+    thread_trace_t* t = current_thread(ompt_thread_unknown);
+    if (!t || t->depth >= MAX_SCOPE_DEPTH) return;
+
+    open_scope_t* s = &t->scopes[t->depth++];
+    s->type = type;
+    s->arg = arg;
+    s->id = id;
+    s->start = now_ns();
+}
+
+// Runtimes do not always close scopes in LIFO order (implicit barriers may end
+// after their implicit task), so match the innermost open scope of this type
+static void scope_end(uint32_t type) {
+    thread_trace_t* t = self;
+    if (!t) return;
+
+    for (int i = t->depth - 1; i >= 0; i--) {
+        if (t->scopes[i].type != type) continue;
+
+        open_scope_t s = t->scopes[i];
+        memmove(&t->scopes[i], &t->scopes[i + 1], (t->depth - i - 1) * sizeof(open_scope_t));
+        t->depth--;
+        record(t, type, s.start, now_ns() - s.start, s.id, s.arg);
+        return;
+    }
+}
+
+// ---- Callbacks ----
+
+static void on_thread_begin(ompt_thread_t thread_type, ompt_data_t* thread_data) {
+    thread_trace_t* t = current_thread(thread_type);
+    if (t) t->thread_type = thread_type;
+    thread_data->value = t ? (uint64_t)t->index : 0;
+}
+
+static void on_parallel_begin(ompt_data_t* encountering_task_data, const ompt_frame_t* frame,
+                              ompt_data_t* parallel_data, unsigned int requested,
+                              int flags, const void* codeptr) {
+    (void)encountering_task_data; (void)frame; (void)flags; (void)codeptr;
+    parallel_data->value = new_id();
+    scope_begin(EV_PARALLEL, parallel_data->value, requested);
+}
+
+static void on_parallel_end(ompt_data_t* parallel_data, ompt_data_t* encountering_task_data,
+                            int flags, const void* codeptr) {
+    (void)parallel_data; (void)encountering_task_data; (void)flags; (void)codeptr;
+    scope_end(EV_PARALLEL);
+}
+
+static void on_implicit_task(ompt_scope_endpoint_t endpoint, ompt_data_t* parallel_data,
+                             ompt_data_t* task_data, unsigned int actual_parallelism,
+                             unsigned int index, int flags) {
+    (void)index; (void)flags;
+    if (endpoint == ompt_scope_begin) {
+        task_data->value = new_id();
+        scope_begin(EV_IMPLICIT_TASK, parallel_data ? parallel_data->value : 0, actual_parallelism);
+    } else {
+        scope_end(EV_IMPLICIT_TASK);
+    }
+}
+
+static void on_task_create(ompt_data_t* encountering_task_data, const ompt_frame_t* frame,
+                           ompt_data_t* new_task_data, int flags, int has_dependences,
+                           const void* codeptr) {
+    (void)encountering_task_data; (void)frame; (void)has_dependences; (void)codeptr;
+    new_task_data->value = new_id();
+
+    if (!(flags & ompt_task_explicit)) return;
+    thread_trace_t* t = current_thread(ompt_thread_unknown);
+    if (t) record(t, EV_TASK_CREATE, now_ns(), 0, new_task_data->value, (uint32_t)flags);
+    new_task_data->value |= TASK_EXPLICIT;
+}
+
+// Every switch closes the running explicit task segment and opens the next one
+static void on_task_schedule(ompt_data_t* prior_task_data, ompt_task_status_t prior_status,
+                             ompt_data_t* next_task_data) {
+    (void)prior_task_data; (void)prior_status;
+    thread_trace_t* t = current_thread(ompt_thread_unknown);
+    if (!t) return;
+
+    uint64_t now = now_ns();
+    if (t->task_id) {
+        record(t, EV_TASK, t->task_start, now - t->task_start, t->task_id & TASK_ID_MASK,
+               (t->task_id & TASK_STARTED) ? 0 : 1);
+        t->task_id = 0;
+    }
+
+    if (next_task_data && (next_task_data->value & TASK_EXPLICIT)) {
+        uint64_t value = next_task_data->value;
+        t->task_id = value;
+        t->task_start = now;
+        next_task_data->value = value | TASK_STARTED;
+    }
+}
+
+static void on_sync_region(ompt_sync_region_t kind, ompt_scope_endpoint_t endpoint,
+                           ompt_data_t* parallel_data, ompt_data_t* task_data,
+                           const void* codeptr) {
+    (void)task_data; (void)codeptr;
+    if (endpoint == ompt_scope_begin) {
+        scope_begin(EV_SYNC, parallel_data ? parallel_data->value : 0, kind);
+    } else {
+        scope_end(EV_SYNC);
+    }
+}
+
+static void on_sync_region_wait(ompt_sync_region_t kind, ompt_scope_endpoint_t endpoint,
+                                ompt_data_t* parallel_data, ompt_data_t* task_data,
+                                const void* codeptr) {
+    (void)task_data; (void)codeptr;
+    if (endpoint == ompt_scope_begin) {
+        scope_begin(EV_SYNC_WAIT, parallel_data ? parallel_data->value : 0, kind);
+    } else {
+        scope_end(EV_SYNC_WAIT);
+    }
+}
+
+static void on_mutex_acquire(ompt_mutex_t kind, unsigned int hint, unsigned int impl,
+                             ompt_wait_id_t wait_id, const void* codeptr) {
+    (void)hint; (void)impl; (void)codeptr;
+    scope_begin(EV_MUTEX_WAIT, wait_id, kind);
+}
+
+static void on_mutex_acquired(ompt_mutex_t kind, ompt_wait_id_t wait_id, const void* codeptr) {
+    (void)kind; (void)wait_id; (void)codeptr;
+    scope_end(EV_MUTEX_WAIT);
+}
+
+// ---- Chrome trace output ----
+
+static const char* sync_name(uint32_t kind) {
+    switch (kind) {
+        case ompt_sync_region_taskwait: return "taskwait";
+        case ompt_sync_region_taskgroup: return "taskgroup";
+        case ompt_sync_region_reduction: return "reduction";
+        case ompt_sync_region_barrier_explicit: return "barrier (explicit)";
+        case ompt_sync_region_barrier_implementation: return "barrier (runtime)";
+        default: return "barrier (implicit)";
+    }
+}
+
+static const char* mutex_name(uint32_t kind) {
+    switch (kind) {
+        case ompt_mutex_critical: return "critical";
+        case ompt_mutex_atomic: return "atomic";
+        case ompt_mutex_ordered: return "ordered";
+        default: return "lock";
+    }
+}
+
+static const char* thread_type_name(int type) {
+    switch (type) {
+        case ompt_thread_initial: return "initial";
+        case ompt_thread_worker: return "worker";
+        default: return "other";
+    }
+}
+
+static void write_event(FILE* out, int tid, const trace_event_t* e, int* first) {
+    double ts = e->start / 1000.0;
+    double dur = e->dur / 1000.0;
+    char name[64];
+
+    fputs(*first ? "\n" : ",\n", out);
+    *first = 0;
+
+    switch (e->type) {
+        case EV_PARALLEL:
+            fprintf(out, "{\"name\":\"parallel\",\"cat\":\"parallel\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                         "\"pid\":1,\"tid\":%d,\"args\":{\"id\":%llu,\"requested\":%u}}",
+                    ts, dur, tid, (unsigned long long)e->id, e->arg);
+            break;
+        case EV_IMPLICIT_TASK:
+            fprintf(out, "{\"name\":\"implicit task\",\"cat\":\"parallel\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                         "\"pid\":1,\"tid\":%d,\"args\":{\"parallel\":%llu,\"team\":%u}}",
+                    ts, dur, tid, (unsigned long long)e->id, e->arg);
+            break;
+        case EV_TASK:
+            snprintf(name, sizeof(name), "task %llu", (unsigned long long)e->id);
+            fprintf(out, "{\"name\":\"%s\",\"cat\":\"task\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                         "\"pid\":1,\"tid\":%d}", name, ts, dur, tid);
+            if (e->arg) {
+                // First segment: end of the creation -> execution arrow
+                fprintf(out, ",\n{\"name\":\"spawn\",\"cat\":\"task\",\"ph\":\"f\",\"bp\":\"e\",\"id\":%llu,"
+                             "\"ts\":%.3f,\"pid\":1,\"tid\":%d}", (unsigned long long)e->id, ts, tid);
+            }
+            break;
+        case EV_TASK_CREATE:
+            fprintf(out, "{\"name\":\"create task %llu\",\"cat\":\"task\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,"
+                         "\"pid\":1,\"tid\":%d},\n", (unsigned long long)e->id, ts, tid);
+            fprintf(out, "{\"name\":\"spawn\",\"cat\":\"task\",\"ph\":\"s\",\"id\":%llu,\"ts\":%.3f,"
+                         "\"pid\":1,\"tid\":%d}", (unsigned long long)e->id, ts, tid);
+            break;
+        case EV_SYNC:
+            fprintf(out, "{\"name\":\"%s\",\"cat\":\"sync\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                         "\"pid\":1,\"tid\":%d}", sync_name(e->arg), ts, dur, tid);
+            break;
+        case EV_SYNC_WAIT:
+            fprintf(out, "{\"name\":\"wait: %s\",\"cat\":\"wait\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                         "\"pid\":1,\"tid\":%d}", sync_name(e->arg), ts, dur, tid);
+            break;
+        case EV_MUTEX_WAIT:
+            fprintf(out, "{\"name\":\"wait: %s\",\"cat\":\"wait\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                         "\"pid\":1,\"tid\":%d}", mutex_name(e->arg), ts, dur, tid);
+            break;
+    }
+}
+
+static void write_trace(void) {
+    const char* path = getenv("OMPT_TRACE_FILE");
+    if (!path || !*path) path = "ompt_trace.json";
+
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "ompt_trace: cannot open %s\n", path);
+        return;
+    }
+
+    int count = __atomic_load_n(&num_threads, __ATOMIC_ACQUIRE);
+    if (count > MAX_THREADS) count = MAX_THREADS;
+
+    uint64_t total = 0, dropped = 0;
+    int first = 1;
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    for (int i = 0; i < count; i++) {
+        thread_trace_t* t = __atomic_load_n(&threads[i], __ATOMIC_ACQUIRE);
+        if (!t) continue;
+
+        fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                     "\"args\":{\"name\":\"%s thread %d\"}}",
+                first ? "" : ",", i, thread_type_name(t->thread_type), i);
+        first = 0;
+
+        uint64_t head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+        uint64_t begin = head > t->capacity ? head - t->capacity : 0;
+        for (uint64_t k = begin; k < head; k++) {
+            write_event(out, i, &t->events[k % t->capacity], &first);
+        }
+        total += head - begin;
+        dropped += begin;
+    }
+
+    fprintf(out, "\n]}\n");
+    fclose(out);
+    fprintf(stderr, "ompt_trace: %llu events from %d threads written to %s",
+            (unsigned long long)total, count, path);
+    if (dropped) fprintf(stderr, " (%llu oldest events dropped, raise OMPT_TRACE_EVENTS)",
+                         (unsigned long long)dropped);
+    fprintf(stderr, "\n");
+}
+
+// ---- Tool entry points ----
+
+#define REGISTER(event, fn) set_callback(event, (ompt_callback_t)(fn))
+
+static int trace_initialize(ompt_function_lookup_t lookup, int initial_device_num,
+                            ompt_data_t* tool_data) {
+    (void)initial_device_num; (void)tool_data;
+
+    const char* events = getenv("OMPT_TRACE_EVENTS");
+    if (events && atol(events) > 0) capacity = (uint64_t)atol(events);
+    clock_gettime(CLOCK_MONOTONIC, &origin);
+
+    set_callback = (ompt_set_callback_t)lookup("ompt_set_callback");
+    if (!set_callback) return 0;
+
+    REGISTER(ompt_callback_thread_begin, on_thread_begin);
+    REGISTER(ompt_callback_parallel_begin, on_parallel_begin);
+    REGISTER(ompt_callback_parallel_end, on_parallel_end);
+    REGISTER(ompt_callback_implicit_task, on_implicit_task);
+    REGISTER(ompt_callback_task_create, on_task_create);
+    REGISTER(ompt_callback_task_schedule, on_task_schedule);
+    REGISTER(ompt_callback_sync_region, on_sync_region);
+    REGISTER(ompt_callback_sync_region_wait, on_sync_region_wait);
+    REGISTER(ompt_callback_mutex_acquire, on_mutex_acquire);
+    REGISTER(ompt_callback_mutex_acquired, on_mutex_acquired);
+    return 1;
+}
+
+static void trace_finalize(ompt_data_t* tool_data) {
+    (void)tool_data;
+    write_trace();
+}
+
+ompt_start_tool_result_t* ompt_start_tool(unsigned int omp_version, const char* runtime_version) {
+    (void)omp_version; (void)runtime_version;
+    static ompt_start_tool_result_t result = { trace_initialize, trace_finalize, { 0 } };
+    return &result;
+}